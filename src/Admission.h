@@ -0,0 +1,171 @@
+#ifndef QT_MULTITHREADING_ADMISSION_H
+#define QT_MULTITHREADING_ADMISSION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * What happens to tasks, which would wait longer in the queue than ControllerConfiguration::queueWaitTarget
+ */
+enum class AdmissionPolicy {
+    /**
+     * The tasks are not queued at all and have to be handled by the caller, see AdmissionResult::rejected
+     */
+    Reject,
+    /**
+     * The tasks are queued in a low priority queue, which is only sent to Worker which would be idle otherwise
+     */
+    Deprioritize
+};
+
+/**
+ * The outcome of Processor::extendQueue() for a batch of tasks. \n
+ * The tasks are admitted in order, so the first AdmissionResult::admitted tasks of the batch are queued normally,
+ * the remaining ones are either all deprioritized or all rejected, depending on ControllerConfiguration::admissionPolicy.
+ * Tasks not fitting into ControllerConfiguration::memoryBudget are rejected regardless of the policy, so that
+ * deprioritized tasks may be followed by rejected ones.
+ */
+struct AdmissionResult {
+    /**
+     * The number of tasks queued normally
+     */
+    std::size_t admitted = 0;
+    /**
+     * The number of tasks queued in the low priority queue, see AdmissionPolicy::Deprioritize
+     */
+    std::size_t deprioritized = 0;
+    /**
+     * The number of tasks not queued at all, see AdmissionPolicy::Reject and ControllerConfiguration::memoryBudget
+     */
+    std::size_t rejected = 0;
+
+    /**
+     * Returns, whether all tasks of the batch have been queued normally
+     *
+     * @return \p true if no task has been deprioritized or rejected, \p false otherwise
+     */
+    [[nodiscard]] inline bool allAdmitted() const {
+        return !this->deprioritized && !this->rejected;
+    }
+};
+
+/**
+ * Sums up the AdmissionResult of the batches a TaskSubmitter gave to the WorkerController, see
+ * TaskSubmitter::admission(). \n
+ * Written by the thread of the WorkerController and read by the producer, thus the counters are atomic.
+ */
+class AdmissionTally {
+public:
+    /**
+     * Adds the outcome of a batch
+     *
+     * @param admission The outcome of the batch
+     */
+    inline void add(const AdmissionResult &admission) {
+        this->admitted.fetch_add(admission.admitted, std::memory_order_relaxed);
+        this->deprioritized.fetch_add(admission.deprioritized, std::memory_order_relaxed);
+        this->rejected.fetch_add(admission.rejected, std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the sum of the outcomes added so far, the counters are read one by one
+     *
+     * @return The numbers of admitted, deprioritized and rejected tasks of all batches
+     */
+    [[nodiscard]] inline AdmissionResult sum() const {
+        AdmissionResult admission;
+        admission.admitted = this->admitted.load(std::memory_order_relaxed);
+        admission.deprioritized = this->deprioritized.load(std::memory_order_relaxed);
+        admission.rejected = this->rejected.load(std::memory_order_relaxed);
+        return admission;
+    }
+
+private:
+    /**
+     * See AdmissionResult::admitted
+     */
+    std::atomic<std::size_t> admitted = 0;
+    /**
+     * See AdmissionResult::deprioritized
+     */
+    std::atomic<std::size_t> deprioritized = 0;
+    /**
+     * See AdmissionResult::rejected
+     */
+    std::atomic<std::size_t> rejected = 0;
+};
+
+/**
+ * Estimates how long a task has to wait in the queue of the WorkerController before being sent to a Worker. \n
+ * The queue drains at the number of Worker divided by the mean time a Worker needs per task, measured from sending
+ * the task to the Worker until the Worker reports being ready again. The mean is an exponentially weighted moving
+ * average, so that the estimate follows changes of the workload. \n
+ * Measuring completions per wall time instead would underestimate the drain rate, whenever the queue runs empty.
+ */
+class QueueWaitEstimator {
+public:
+    /**
+     * Adds the time a Worker needed for a task
+     *
+     * @param serviceTime The time from sending the task to the Worker until the Worker has been ready again
+     */
+    inline void addServiceTime(const std::chrono::nanoseconds serviceTime) {
+        const auto sample = static_cast<double>(serviceTime.count());
+        this->meanServiceTime = this->measured
+                                ? QueueWaitEstimator::weight * sample +
+                                  (1 - QueueWaitEstimator::weight) * this->meanServiceTime
+                                : sample;
+        this->measured = true;
+    }
+
+    /**
+     * Returns, whether a service time has been measured already, the estimate is 0 otherwise
+     *
+     * @return \p true if estimates are available, \p false otherwise
+     */
+    [[nodiscard]] inline bool ready() const {
+        return this->measured;
+    }
+
+    /**
+     * Estimates the queue wait of a task
+     *
+     * @param tasksAhead The number of tasks, which have to be sent to a Worker before the task
+     * @param readyWorkers The number of Worker waiting for a task
+     * @param numberOfWorkers The number of Worker sharing the queue
+     * @return The estimated time until the task is sent to a Worker,
+     *         std::chrono::nanoseconds::max() if there are no Worker at all
+     */
+    [[nodiscard]] inline std::chrono::nanoseconds estimate(const std::size_t tasksAhead,
+                                                           const std::size_t readyWorkers,
+                                                           const std::size_t numberOfWorkers) const {
+        if (!this->measured || tasksAhead < readyWorkers) {
+            return std::chrono::nanoseconds(0);
+        }
+        if (!numberOfWorkers) {
+            return std::chrono::nanoseconds::max();
+        }
+        // the task is sent, once a Worker finished for every task ahead of it, which is not taken by a ready Worker
+        const double completionsNeeded = static_cast<double>(tasksAhead - readyWorkers + 1);
+        return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(
+                completionsNeeded * this->meanServiceTime / static_cast<double>(numberOfWorkers)
+        ));
+    }
+
+private:
+    /**
+     * The weight of a new sample in the moving average
+     */
+    static constexpr double weight = 0.05;
+    /**
+     * The moving average of the service time in nanoseconds
+     */
+    double meanServiceTime = 0;
+    /**
+     * Whether a service time has been added yet
+     */
+    bool measured = false;
+};
+
+#endif
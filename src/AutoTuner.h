@@ -0,0 +1,209 @@
+#ifndef QT_MULTITHREADING_AUTOTUNER_H
+#define QT_MULTITHREADING_AUTOTUNER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+/**
+ * The setting chosen by the AutoTuner
+ */
+struct TuningSetting {
+    /**
+     * The number of Worker tasks are given to, the other Worker stay idle
+     */
+    std::size_t workers = 1;
+    /**
+     * The largest number of tasks sent to a Worker at once, see ControllerConfiguration::dispatchBatchSize
+     */
+    std::size_t batchSize = 1;
+};
+
+/**
+ * Chooses the number of Worker and the dispatch batch size with the highest throughput,
+ * see ControllerConfiguration::autoTuning. \n
+ * The tuning happens in rounds of fixed length on the actual tasks: every candidate setting is used for one round,
+ * first all batch sizes with all Worker, then all numbers of Worker with the best batch size. Rounds in which the
+ * Worker ran out of tasks are repeated, since their throughput only shows how fast tasks arrived.
+ *
+ * Once settled, the mean execution time of the tasks is compared with the one measured right after settling,
+ * and the tuning starts over when it drifted, since the best setting depends on the size of the tasks.
+ */
+class AutoTuner {
+public:
+    /**
+     * Constructor used to initialize the AutoTuner
+     *
+     * @param maxBatchSize The largest batch size tried
+     * @param drift The relative change of the mean execution time starting the tuning over, e.g. 0.5 for 50 %
+     */
+    AutoTuner(const std::size_t maxBatchSize, const double drift)
+            : maxBatchSize(std::max<std::size_t>(maxBatchSize, 1)), drift(drift) {}
+
+    /**
+     * Starts the tuning over, e.g. when the number of threads has been changed
+     *
+     * @param newMaxWorkers The number of running Worker, which is the largest number of Worker tried
+     */
+    inline void restart(const std::size_t newMaxWorkers) {
+        this->maxWorkers = std::max<std::size_t>(newMaxWorkers, 1);
+        this->phase = Phase::BatchSize;
+        this->candidates.clear();
+        for (std::size_t batchSize = 1; batchSize < this->maxBatchSize; batchSize *= 4) {
+            this->candidates.push_back(batchSize);
+        }
+        this->candidates.push_back(this->maxBatchSize);
+        this->candidate = 0;
+        this->bestThroughput = 0;
+        this->best = TuningSetting{this->maxWorkers, 1};
+        this->current = TuningSetting{this->maxWorkers, this->candidates.front()};
+        this->baselineExecutionTime = std::chrono::nanoseconds(0);
+        ++this->calibrations;
+    }
+
+    /**
+     * Ends a round and chooses the setting of the next one
+     *
+     * @param completedTasks The number of tasks completed during the round
+     * @param duration The length of the round
+     * @param saturated Whether there have been tasks waiting for a Worker during the whole round
+     * @param meanExecutionTime The mean execution time of the tasks completed during the round
+     * @return The setting to use for the next round
+     */
+    inline TuningSetting round(const std::size_t completedTasks, const std::chrono::nanoseconds duration,
+                               const bool saturated, const std::chrono::nanoseconds meanExecutionTime) {
+        if (!completedTasks || duration.count() <= 0) {
+            return this->current;
+        }
+
+        if (this->phase == Phase::Settled) {
+            if (!this->baselineExecutionTime.count()) {
+                this->baselineExecutionTime = std::max(meanExecutionTime, std::chrono::nanoseconds(1));
+            } else {
+                const double ratio = static_cast<double>(meanExecutionTime.count()) /
+                                     static_cast<double>(this->baselineExecutionTime.count());
+                if (ratio > 1 + this->drift || ratio * (1 + this->drift) < 1) {
+                    this->restart(this->maxWorkers);
+                }
+            }
+            return this->current;
+        }
+
+        // a round without waiting tasks only measured how fast tasks arrived, thus it is repeated
+        if (!saturated) {
+            return this->current;
+        }
+
+        const double throughput = static_cast<double>(completedTasks) / static_cast<double>(duration.count());
+        if (throughput > this->bestThroughput) {
+            this->bestThroughput = throughput;
+            this->best = this->current;
+        }
+
+        if (++this->candidate < this->candidates.size()) {
+            if (this->phase == Phase::BatchSize) {
+                this->current.batchSize = this->candidates[this->candidate];
+            } else {
+                this->current.workers = this->candidates[this->candidate];
+            }
+        } else if (this->phase == Phase::BatchSize && this->maxWorkers > 1) {
+            // all Worker with the best batch size have been measured already
+            this->phase = Phase::Workers;
+            this->candidates.clear();
+            for (std::size_t workers = 1; workers < this->maxWorkers; workers *= 2) {
+                this->candidates.push_back(workers);
+            }
+            this->candidate = 0;
+            this->current = TuningSetting{this->candidates.front(), this->best.batchSize};
+        } else {
+            this->phase = Phase::Settled;
+            this->current = this->best;
+        }
+        return this->current;
+    }
+
+    /**
+     * Returns the setting of the current round
+     *
+     * @return The current setting
+     */
+    [[nodiscard]] inline TuningSetting setting() const {
+        return this->current;
+    }
+
+    /**
+     * Returns, whether the AutoTuner is still trying candidate settings
+     *
+     * @return \p true while tuning, \p false once settled
+     */
+    [[nodiscard]] inline bool isTuning() const {
+        return this->phase != Phase::Settled;
+    }
+
+    /**
+     * Returns how often the tuning has been started, including the first time
+     *
+     * @return The number of started tunings
+     */
+    [[nodiscard]] inline std::size_t numberOfCalibrations() const {
+        return this->calibrations;
+    }
+
+private:
+    /**
+     * What the AutoTuner is doing
+     */
+    enum class Phase {
+        BatchSize,
+        Workers,
+        Settled
+    };
+
+    /**
+     * The largest batch size tried
+     */
+    const std::size_t maxBatchSize;
+    /**
+     * The relative change of the mean execution time starting the tuning over
+     */
+    const double drift;
+    /**
+     * The largest number of Worker tried
+     */
+    std::size_t maxWorkers = 1;
+    /**
+     * What the AutoTuner is doing
+     */
+    Phase phase = Phase::Settled;
+    /**
+     * The batch sizes or numbers of Worker tried in the current phase
+     */
+    std::vector<std::size_t> candidates;
+    /**
+     * The index of the current candidate in AutoTuner::candidates
+     */
+    std::size_t candidate = 0;
+    /**
+     * The highest throughput measured since the tuning started, in tasks per nanosecond
+     */
+    double bestThroughput = 0;
+    /**
+     * The setting with the highest throughput
+     */
+    TuningSetting best;
+    /**
+     * The setting of the current round
+     */
+    TuningSetting current;
+    /**
+     * The mean execution time of the first round after settling, 0 if not measured yet
+     */
+    std::chrono::nanoseconds baselineExecutionTime{0};
+    /**
+     * See AutoTuner::numberOfCalibrations()
+     */
+    std::size_t calibrations = 0;
+};
+
+#endif
@@ -0,0 +1,327 @@
+#ifndef QT_MULTITHREADING_CONFIGURATION_H
+#define QT_MULTITHREADING_CONFIGURATION_H
+
+#include <QDir>
+#include <QString>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include "Admission.h"
+#include "RemoteWorkers.h"
+#include "ResultReducer.h"
+
+/**
+ * Optional settings of a Controller, which are handed to the WorkerController on construction. \n
+ * A default constructed configuration leads to the same behaviour as not giving a configuration at all.
+ *
+ * Example: \n
+ * ControllerConfiguration<int, int> configuration; \n
+ * configuration.spillMemoryBudget = 512 * 1024 * 1024; \n
+ * Controller<int, int> controller(std::move(processor), std::move(worker), 4, configuration);
+ *
+ * @tparam T The data type of the task to fulfill
+ * @tparam R The data type of the result calculated during fulfilling the task
+ */
+template<typename T, typename R>
+struct ControllerConfiguration {
+    /**
+     * The number of bytes the queued tasks of the WorkerController may occupy in memory. \n
+     * Tasks queued beyond this budget are written to spill files and read back when the queue drains.
+     * 0 disables spilling, which means the queue is only bounded by the available memory.
+     *
+     * Notice: Spilling is only supported for tasks satisfying Serializable, the budget is ignored otherwise.
+     */
+    std::size_t spillMemoryBudget = 0;
+
+    /**
+     * The directory in which spill files are created. \n
+     * Should be on a local disk, since the files are written and read in large sequential chunks.
+     */
+    QString spillDirectory = QDir::tempPath();
+
+    /**
+     * The number of tasks written to a single spill file
+     */
+    std::size_t spillChunkSize = 65536;
+
+    /**
+     * Returns the number of bytes a task occupies in memory, used for the memory accounting. \n
+     * If not given, sizeof(T) is used, which does not include memory owned by the task, e.g. by a std::vector.
+     */
+    std::function<std::size_t(const T &)> taskSize;
+
+    /**
+     * Returns the number of bytes a result occupies in memory, used for the memory accounting. \n
+     * If not given, sizeof(R) is used, which does not include memory owned by the result, e.g. by a std::vector.
+     */
+    std::function<std::size_t(const R &)> resultSize;
+
+    /**
+     * The number of bytes the queued tasks, the in-flight tasks and the results waiting for the Processor
+     * may occupy together, see Metrics. \n
+     * When giving new tasks would exceed the budget, Processor::extendQueue() and TaskSubmitter block until enough
+     * memory has been released, see ControllerConfiguration::memoryBudgetTimeout, while the Processor still processes
+     * its events, so that pending results are received. The WorkerController rejects the tasks still not fitting,
+     * see AdmissionResult::rejected. 0 disables the budget.
+     *
+     * Notice: New tasks are always accepted when nothing is accounted, even if they exceed the budget on their own.
+     */
+    std::size_t memoryBudget = 0;
+
+    /**
+     * The longest time Processor::extendQueue() and TaskSubmitter wait for new tasks to fit into
+     * ControllerConfiguration::memoryBudget, the tasks are given to the WorkerController afterwards anyway,
+     * which rejects the ones not fitting. Bounds the wait of a Processor whose results are never going to be released,
+     * e.g. because its Worker are stuck.
+     */
+    std::chrono::milliseconds memoryBudgetTimeout{10000};
+
+    /**
+     * The longest time a task should wait in the queue of the WorkerController before being sent to a Worker. \n
+     * The wait of every new task is estimated from the queue depth and the rate at which the Worker drain the queue,
+     * see QueueWaitEstimator. Tasks whose estimate exceeds the target are handled according to
+     * ControllerConfiguration::admissionPolicy, see AdmissionResult. Bounding the queue wait keeps the latency of the
+     * admitted tasks bounded under overload. 0 disables the admission control.
+     *
+     * Notice: Every task is admitted until the first Worker finished a task, since the drain rate is unknown until then.
+     */
+    std::chrono::nanoseconds queueWaitTarget{0};
+
+    /**
+     * What happens to tasks exceeding ControllerConfiguration::queueWaitTarget
+     */
+    AdmissionPolicy admissionPolicy = AdmissionPolicy::Reject;
+
+    /**
+     * The resolution of the TimerWheel holding the tasks given with Controller::scheduleAt() and
+     * Controller::scheduleEvery(), a scheduled task is given to the queue up to one tick late
+     */
+    std::chrono::nanoseconds schedulerTick = std::chrono::milliseconds(1);
+
+    /**
+     * The number of tasks a TaskSubmitter collects before giving them to the queue of the WorkerController at once,
+     * larger batches cost less per task, smaller ones let the tasks wait shorter in the buffer of the producer
+     */
+    std::size_t submitterBatchSize = 64;
+
+    /**
+     * The largest number of tasks sent to a Worker at once, which fulfills them one after another without waiting
+     * for the WorkerController in between. \n
+     * Larger batches hide the round trip to the WorkerController for short tasks, but may leave Worker idle while
+     * others still have tasks of their batch to fulfill. The queue is spread evenly over the ready Worker, so a Worker
+     * only gets a full batch, if there are enough tasks for all of them.
+     *
+     * Notice: Tasks are always sent one at a time with ControllerConfiguration::hedging.
+     */
+    std::size_t dispatchBatchSize = 1;
+
+    /**
+     * If set to \p true, the number of Worker tasks are given to and ControllerConfiguration::dispatchBatchSize are
+     * chosen while running, by measuring the throughput of candidate settings on the actual tasks in rounds of
+     * ControllerConfiguration::autoTuningRound, see AutoTuner. \n
+     * The number of threads set is the largest number of Worker used, the other Worker stay idle, but keep running
+     * so that switching between settings is cheap. See MetricsSnapshot::tunedWorkers for the chosen setting.
+     */
+    bool autoTuning = false;
+
+    /**
+     * The length of a round of the AutoTuner, long enough to complete many tasks
+     */
+    std::chrono::nanoseconds autoTuningRound = std::chrono::milliseconds(200);
+
+    /**
+     * The largest dispatch batch size tried by the AutoTuner
+     */
+    std::size_t autoTuningMaxBatchSize = 64;
+
+    /**
+     * The relative change of the mean execution time of the tasks, which starts the tuning over once settled,
+     * e.g. 0.5 if tasks taking 50 % longer or shorter need another setting
+     */
+    double autoTuningDrift = 0.5;
+
+    /**
+     * If set to \p true, a task running longer than ControllerConfiguration::hedgingPercentile of the recent
+     * execution times is sent a second time to a Worker, which would be idle otherwise. \n
+     * The Worker finishing first sends its result, the other one discards its result and may stop early by checking
+     * Worker::isTaskCancelled(). Reduces the tail latency, e.g. near the end of a batch, at the cost of doing some
+     * tasks twice, see MetricsSnapshot::hedgeRate().
+     *
+     * Notice: Only use it for idempotent tasks, since every task may be fulfilled twice.
+     */
+    bool hedging = false;
+
+    /**
+     * The percentile of the execution times, which a task has to exceed to be hedged, see ControllerConfiguration::hedging
+     */
+    double hedgingPercentile = 0.95;
+
+    /**
+     * If set to \p true, Processor::receiveResult() is called directly in the thread of the Worker which calculated
+     * the result, instead of sending the result to the thread of the Processor. \n
+     * Removes the hop between the threads and the single Processor thread as bottleneck, if handling the results
+     * is expensive. The Processor has to follow this contract then:
+     *  - receiveResult() is called concurrently from all Worker threads, so it has to be thread-safe
+     *  - receiveResult() must not call setNumberOfThreads(), clearQueue() or extendQueue() directly,
+     *    but post a call to the thread of the Processor, e.g. with invokeInContext() and Qt::QueuedConnection
+     *  - receiveResult() blocks the Worker, which is not ready for a new task until it returned
+     */
+    bool concurrentResults = false;
+
+    /**
+     * If set, every Worker folds its results into its own clone of this ResultReducer in its own thread,
+     * instead of sending them to the Processor, whose receiveResult() is then never called. \n
+     * The Processor requests the merged state of all Worker with Processor::collectReduction()
+     * and receives it with Processor::receiveReduction().
+     */
+    std::shared_ptr<const ResultReducer<R>> resultReducer;
+
+    /**
+     * The number of Processor instances receiving results, each running in its own thread. \n
+     * The additional shards are created with Processor::clone(), every shard stays single-threaded,
+     * so that receiveResult() needs no locks, while handling the results scales with the number of shards.
+     * Every Worker sends its results to the shard Processor::shardIndex() equal to its index modulo the number of
+     * shards, unless ControllerConfiguration::resultShardKey is set. \n
+     * Tasks may be given by every shard, the one given to the Controller is the shard with the index 0.
+     */
+    std::size_t processorShards = 1;
+
+    /**
+     * If set, every result is sent to the shard with the index equal to the returned key modulo the number of shards,
+     * see ControllerConfiguration::processorShards, so that all results with the same key are received by the
+     * same shard, in the order they have been sent by a Worker
+     */
+    std::function<std::size_t(const R &)> resultShardKey;
+
+    /**
+     * If set to \p true, every Worker sends its results via its own lock-free ResultChannel instead of the event queue of
+     * the Processor, which is shared by all Worker and protected by a mutex. \n
+     * The Processor is notified once per drain instead of once per result and drains the channels in round-robin batches
+     * of ControllerConfiguration::resultBatchSize results, see ResultInbox. Has no effect with
+     * ControllerConfiguration::concurrentResults or ControllerConfiguration::resultReducer.
+     */
+    bool resultChannels = false;
+
+    /**
+     * The number of results a ResultChannel allocates at once, when its allocated slots are in use
+     */
+    std::size_t resultChannelSegmentSize = 1024;
+
+    /**
+     * The number of results a ResultEmitter sends to the Processor at once, see StreamingWorker
+     */
+    std::size_t resultBatchSize = 64;
+
+    /**
+     * The shortest time between two incomplete batches of a ResultEmitter, a result pushed after a longer pause is
+     * sent at once, see StreamingWorker
+     */
+    std::chrono::nanoseconds resultBatchInterval = std::chrono::milliseconds(10);
+
+    /**
+     * If set to \p true, Worker are not started when setting the number of threads,
+     * but only when there are tasks waiting for them, up to the set number of threads. \n
+     * Useful when creating many Controller at once, see also Controller::preWarm().
+     */
+    bool lazyWorkerStart = false;
+
+    /**
+     * If set to \p true, every Worker measures hardware performance counters (cycles, instructions, cache misses)
+     * and software counters (CPU time, context switches, page faults) around every task, see PerfCounterGroup. \n
+     * Falls back to the software counters if the hardware counters are not available.
+     * The values are summed up per Worker and per task class, see Controller::perfCounters().
+     */
+    bool perfCounters = false;
+
+    /**
+     * If set to \p true, every Worker measures its CPU time and its voluntary and involuntary context switches
+     * around every task, see ThreadUsage. \n
+     * The efficiency of every Worker, i.e. CPU time divided by wall time, is available through
+     * MetricsSnapshot::workers. Costs two system calls before and after every task.
+     */
+    bool workerUsage = false;
+
+    /**
+     * The file the JSON of Controller::introspect() is written to on request, see Introspector. \n
+     * Empty disables the requests by ControllerConfiguration::introspectionSignal and
+     * ControllerConfiguration::introspectionSocket.
+     */
+    QString introspectionFile;
+
+    /**
+     * The POSIX signal requesting to write the introspection file, e.g. SIGUSR1, 0 to not install a signal handler. \n
+     * The signal handler is installed process-wide, so all Controller of a process should use the same signal.
+     */
+    int introspectionSignal = 0;
+
+    /**
+     * The path of a local Unix socket requesting to write the introspection file when connected to,
+     * the connection receives the JSON as well, e.g. with "socat - UNIX-CONNECT:<path>". Empty to not listen.
+     */
+    QString introspectionSocket;
+
+    /**
+     * Creates the backend giving tasks to Worker running in other processes, e.g. on other machines, see RemoteWorkers
+     * and TcpRemoteWorkers. Called once, the backend lives in the thread of the WorkerController. \n
+     * Tasks are only sent to remote Worker, if no local Worker is ready, so the number of threads may be set to 0 to
+     * only use remote Worker. The results are handed to the Processor like the ones of local Worker.
+     *
+     * Notice: Tasks and results have to satisfy Serializable to be sent over a network.
+     * Hedging does not apply to tasks sent to remote Worker.
+     */
+    std::function<std::unique_ptr<RemoteWorkers<T, R>>()> remoteWorkers;
+
+    /**
+     * How long the destructor of the Controller waits for the queued and running tasks to finish, before requesting
+     * their cancellation, see Controller::shutdown(). \n
+     * If both this and ControllerConfiguration::shutdownCancelTimeout are 0, the destructor waits without limit.
+     */
+    std::chrono::milliseconds shutdownDrainTimeout{0};
+
+    /**
+     * How long the destructor of the Controller waits for the running tasks to be cancelled and the threads to stop,
+     * before leaving the threads of stuck Worker running, see Controller::shutdown(). \n
+     * If both this and ControllerConfiguration::shutdownDrainTimeout are 0, the destructor waits without limit.
+     */
+    std::chrono::milliseconds shutdownCancelTimeout{0};
+
+    /**
+     * Returns the class of a task, used to sum up the performance counters per kind of task,
+     * see ControllerConfiguration::perfCounters. \n
+     * Called in the thread of the Worker before fulfilling the task. If not given, all tasks are of class 0.
+     */
+    std::function<std::size_t(const T &)> taskClass;
+
+    /**
+     * See ControllerConfiguration::taskSize
+     *
+     * @param task The task to get the size of
+     * @return The number of bytes the task occupies in memory
+     */
+    [[nodiscard]] inline std::size_t sizeOfTask(const T &task) const {
+        return this->taskSize ? this->taskSize(task) : sizeof(T);
+    }
+
+    /**
+     * See ControllerConfiguration::resultSize
+     *
+     * @param result The result to get the size of
+     * @return The number of bytes the result occupies in memory
+     */
+    [[nodiscard]] inline std::size_t sizeOfResult(const R &result) const {
+        return this->resultSize ? this->resultSize(result) : sizeof(R);
+    }
+
+    /**
+     * See ControllerConfiguration::taskClass
+     *
+     * @param task The task to get the class of
+     * @return The class of the task
+     */
+    [[nodiscard]] inline std::size_t classOfTask(const T &task) const {
+        return this->taskClass ? this->taskClass(task) : 0;
+    }
+};
+
+#endif
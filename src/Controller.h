@@ -3,8 +3,20 @@
 
 #include <QObject>
 #include <QThread>
+#include <QString>
 #include <memory>
 #include <cstddef>
+#include <limits>
+#include <chrono>
+#include <algorithm>
+#include "Configuration.h"
+#include "Introspection.h"
+#include "Metrics.h"
+#include "PerfCounters.h"
+#include "Recording.h"
+#include "ShutdownReport.h"
+#include "TaskSubmitter.h"
+#include "TimerWheel.h"
 #include "WorkerController.h"
 #include "Worker.h"
 #include "Processor.h"
@@ -34,31 +46,420 @@ public:
      */
     Controller(std::unique_ptr<Processor<T, R>> processor, std::unique_ptr<Worker<T, R>> worker,
                      const std::size_t numberOfThreads, QObject *const parent = nullptr)
+            : Controller(std::move(processor), std::move(worker), numberOfThreads,
+                         ControllerConfiguration<T, R>(), parent) {}
+
+    /**
+     * Constructor used to initialize the Controller with optional settings
+     *
+     * @param processor The Processor to use
+     * @param worker The prototype Worker which will be cloned
+     * @param numberOfThreads The number of threads to use, which is the same as the number of Worker to use
+     * @param configuration The optional settings, see ControllerConfiguration
+     * @param parent    Another QObject to use as parent for the controller, if wanted.
+     *                  See: https://doc.qt.io/qt-5/qobject.html#QObject
+     */
+    Controller(std::unique_ptr<Processor<T, R>> processor, std::unique_ptr<Worker<T, R>> worker,
+                     const std::size_t numberOfThreads, const ControllerConfiguration<T, R> &configuration,
+                     QObject *const parent = nullptr)
             : QObject(parent) {
         // setup WorkerController and the corresponding thread
         std::unique_ptr<WorkerController<T, R>> workerController = std::unique_ptr<WorkerController<T, R>>(
-                new WorkerController<T, R>(std::move(worker), std::move(processor), numberOfThreads)
+                new WorkerController<T, R>(std::move(worker), std::move(processor), numberOfThreads, configuration)
         );
-        workerController->moveToThread(&this->workerControllerThread);
-        this->workerControllerThread.start();
+        this->workerController = workerController.get();
+        workerController->moveToThread(this->workerControllerThread.get());
+        this->workerControllerThread->start();
         QObject::connect(
-                &this->workerControllerThread, &QThread::finished, workerController.release(), &QObject::deleteLater
+                this->workerControllerThread.get(), &QThread::finished,
+                workerController.release(), &QObject::deleteLater
         );
+
+        // the backend for remote workers has to live in the thread of the WorkerController
+        if (configuration.remoteWorkers) {
+            invokeInContext(
+                    static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                    &WorkerController<T, R>::startRemoteWorkers,
+                    this->workerController
+            );
+        }
+
+        // listen for requests to write the introspection file
+        if (!configuration.introspectionFile.isEmpty() &&
+            (configuration.introspectionSignal || !configuration.introspectionSocket.isEmpty())) {
+            this->introspector = std::make_unique<Introspector>(
+                    [this]() -> IntrospectionSnapshot { return this->introspect(); },
+                    configuration.introspectionFile, configuration.introspectionSignal,
+                    configuration.introspectionSocket
+            );
+        }
     }
 
     /**
-     * Stops the WorkerController and thus everything else
+     * Stops the WorkerController and thus everything else. \n
+     * Waits without limit, unless ControllerConfiguration::shutdownDrainTimeout or
+     * ControllerConfiguration::shutdownCancelTimeout is set, see Controller::shutdown().
      */
     ~Controller() override {
-        workerControllerThread.quit();
-        workerControllerThread.wait();
+        // already stopped with shutdown()
+        if (!this->workerController) {
+            return;
+        }
+
+        const std::chrono::milliseconds drainTimeout = this->workerController->configuration.shutdownDrainTimeout;
+        const std::chrono::milliseconds cancelTimeout = this->workerController->configuration.shutdownCancelTimeout;
+        if (drainTimeout.count() || cancelTimeout.count()) {
+            const ShutdownReport report = this->shutdown(drainTimeout, cancelTimeout);
+            if (!report.isClean()) {
+                qWarning("Controller: %s", qPrintable(report.toString()));
+            }
+            return;
+        }
+
+        // stop taking snapshots before the WorkerController is gone
+        this->introspector.reset();
+        this->workerControllerThread->quit();
+        this->workerControllerThread->wait();
+    }
+
+    /**
+     * Stops the WorkerController and thus everything else within a deadline, so that a Worker stuck in
+     * fulfillTask() cannot keep the process from exiting:
+     *
+     * 1. Drain: waits up to \p drainTimeout for the queued and running tasks to finish and their results
+     *    to reach the Processor.
+     * 2. Cancel: discards the queued tasks, rejects new ones and requests the running tasks to be cancelled,
+     *    see Worker::isTaskCancelled(), then waits up to \p cancelTimeout for them.
+     * 3. Join or detach: without a busy Worker, the threads are stopped and joined. Otherwise, the threads are
+     *    left running, the WorkerController and everything it owns are leaked on purpose, since a running QThread
+     *    must not be destroyed.
+     *
+     * Afterwards, the other methods of this Controller do nothing and return empty values, e.g. an empty
+     * MetricsSnapshot. A TaskSubmitter created before must not be used anymore.
+     *
+     * @param drainTimeout How long to wait for the tasks to finish, before requesting their cancellation
+     * @param cancelTimeout How long to wait for the cancellation and the threads, before detaching
+     * @return Which Worker have been stuck and which tasks have been in flight, see ShutdownReport::toString()
+     */
+    inline ShutdownReport shutdown(const std::chrono::milliseconds &drainTimeout,
+                                   const std::chrono::milliseconds &cancelTimeout) {
+        ShutdownReport report;
+        if (!this->workerController) {
+            return report;
+        }
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const Metrics &liveMetrics = this->workerController->metrics;
+
+        // stop taking snapshots before the WorkerController is gone
+        this->introspector.reset();
+
+        report.drained = this->waitUntil(start + drainTimeout, [&liveMetrics]() -> bool {
+            return !liveMetrics.queuedTasks.load(std::memory_order_relaxed) &&
+                   !liveMetrics.deprioritizedTasks.load(std::memory_order_relaxed) &&
+                   !liveMetrics.inFlightTasks.load(std::memory_order_relaxed) &&
+                   !liveMetrics.pendingResults.load(std::memory_order_relaxed);
+        });
+
+        const std::chrono::steady_clock::time_point cancelDeadline = std::chrono::steady_clock::now() + cancelTimeout;
+        if (!report.drained) {
+            IntrospectionSnapshot snapshot;
+            invokeInContext(
+                    static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                    &WorkerController<T, R>::requestShutdown,
+                    this->workerController, snapshot, report.discardedTasks
+            );
+            std::size_t localInFlightTasks = 0;
+            for (const WorkerIntrospection &worker : snapshot.workers) {
+                if (worker.busy) {
+                    report.inFlightTasks.push_back(worker);
+                    localInFlightTasks += 1 + worker.batchedTaskIds.size();
+                }
+            }
+            report.remoteInFlightTasks = snapshot.metrics.inFlightTasks -
+                                         std::min(localInFlightTasks, snapshot.metrics.inFlightTasks);
+
+            const bool cancelled = this->waitUntil(cancelDeadline, [&liveMetrics]() -> bool {
+                return !liveMetrics.inFlightTasks.load(std::memory_order_relaxed);
+            });
+            if (!cancelled) {
+                invokeInContext(
+                        static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                        &WorkerController<T, R>::introspect,
+                        this->workerController, snapshot
+                );
+                for (const WorkerIntrospection &worker : snapshot.workers) {
+                    if (worker.busy) {
+                        report.stuckWorkers.push_back(worker);
+                    }
+                }
+            }
+        }
+
+        // the WorkerController waits for its Worker when destroyed, which a stuck Worker would never let it finish,
+        // without one the threads stop as soon as their current event returned, thus they are joined without a limit
+        if (report.stuckWorkers.empty()) {
+            this->workerControllerThread->quit();
+            this->workerControllerThread->wait();
+        } else {
+            report.detached = true;
+            static_cast<void>(this->workerControllerThread.release());
+        }
+        this->workerController = nullptr;
+        report.duration = std::chrono::steady_clock::now() - start;
+        return report;
+    }
+
+    /**
+     * Starts Worker ahead of time when using ControllerConfiguration::lazyWorkerStart,
+     * so that the first tasks do not have to wait for the Worker to be started. \n
+     * Never starts more Worker than the number of threads to use.
+     *
+     * @param numberOfThreads The number of Worker which should be running when this method returns
+     */
+    inline void preWarm(const std::size_t numberOfThreads = std::numeric_limits<std::size_t>::max()) {
+        if (!this->workerController) {
+            return;
+        }
+
+        invokeInContext(
+                static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                &WorkerController<T, R>::preWarm,
+                this->workerController, numberOfThreads
+        );
+    }
+
+    /**
+     * Creates a handle to give tasks to the queue of the WorkerController from any thread, without going through
+     * the Processor. Every producer thread should use its own TaskSubmitter, see TaskSubmitter for details.
+     *
+     * @return The new TaskSubmitter, which must not outlive this Controller,
+     *         one discarding all tasks once stopped with shutdown()
+     */
+    [[nodiscard]] inline TaskSubmitter<T, R> submitter() {
+        if (!this->workerController) {
+            return TaskSubmitter<T, R>(nullptr, nullptr, nullptr);
+        }
+
+        return TaskSubmitter<T, R>(
+                this->workerController, &this->workerController->configuration, &this->workerController->metrics
+        );
+    }
+
+    /**
+     * Returns where remote Worker have to connect to, see ControllerConfiguration::remoteWorkers,
+     * e.g. "127.0.0.1:4711" for TcpRemoteWorkers
+     *
+     * @return The address of the backend for remote Worker, empty if there is none
+     */
+    [[nodiscard]] inline QString remoteWorkersAddress() const {
+        if (!this->workerController) {
+            return QString();
+        }
+
+        QString address;
+        invokeInContext(
+                static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                &WorkerController<T, R>::remoteWorkersAddress,
+                this->workerController, address
+        );
+        return address;
+    }
+
+    /**
+     * Gives a task to the queue of the WorkerController at a given time, e.g. to retry a task after a delay,
+     * may be called from any thread. \n
+     * The scheduled tasks are kept in a TimerWheel in the thread of the WorkerController, so that millions of them
+     * cost no QTimer each, see ControllerConfiguration::schedulerTick for the resolution.
+     *
+     * @param task The task to give to the queue
+     * @param due The time to give the task to the queue at, tasks due in the past are given at once
+     * @return The id to cancel the scheduled task with cancelScheduled()
+     */
+    inline TimerId scheduleAt(const T &task, const std::chrono::steady_clock::time_point &due) {
+        return this->schedule(task, due, std::chrono::nanoseconds(0));
+    }
+
+    /**
+     * Gives a copy of a task to the queue of the WorkerController periodically, e.g. to refresh something,
+     * until cancelled with cancelScheduled(), may be called from any thread. \n
+     * Periods missed while the WorkerController has been busy are skipped, a single copy is given for all of them.
+     *
+     * @param task The task to give to the queue
+     * @param period The time between two copies of the task, the first one is given after one period
+     * @return The id to cancel the scheduled task with cancelScheduled()
+     */
+    inline TimerId scheduleEvery(const T &task, const std::chrono::nanoseconds &period) {
+        return this->schedule(task, std::chrono::steady_clock::now() + period, period);
+    }
+
+    /**
+     * Cancels a task given with scheduleAt() or scheduleEvery(), may be called from any thread
+     *
+     * @param id The id returned when scheduling the task
+     * @return \p true if the task has been waiting for its time, \p false if it has been given to the queue already
+     */
+    inline bool cancelScheduled(const TimerId id) {
+        if (!this->workerController) {
+            return false;
+        }
+
+        bool cancelled = false;
+        invokeInContext(
+                static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                &WorkerController<T, R>::cancelScheduledTask,
+                this->workerController, id, cancelled
+        );
+        return cancelled;
+    }
+
+    /**
+     * Starts recording every task given to the WorkerController, when and to which Worker it has been sent and how
+     * long fulfilling it took, see TaskRecorder. \n
+     * A running recording is stopped first. The recording can be re-driven with TaskReplayer.
+     *
+     * @param fileName The file to write the recording to, which is overwritten
+     * @return \p true if the file could be opened, \p false otherwise
+     */
+    inline bool startRecording(const QString &fileName) {
+        if (!this->workerController) {
+            return false;
+        }
+
+        bool started = false;
+        invokeInContext(
+                static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                &WorkerController<T, R>::startRecording,
+                this->workerController, fileName, started
+        );
+        return started;
+    }
+
+    /**
+     * Stops recording and writes all buffered records to the file, see Controller::startRecording()
+     */
+    inline void stopRecording() {
+        if (!this->workerController) {
+            return;
+        }
+
+        invokeInContext(
+                static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                &WorkerController<T, R>::stopRecording,
+                this->workerController
+        );
+    }
+
+    /**
+     * Returns the performance counters summed up per Worker and per task class,
+     * only measured with ControllerConfiguration::perfCounters
+     *
+     * @return The summed up performance counters
+     */
+    [[nodiscard]] inline PerfCounterReport perfCounters() const {
+        if (!this->workerController) {
+            return PerfCounterReport();
+        }
+
+        PerfCounterReport report;
+        invokeInContext(
+                static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                &WorkerController<T, R>::perfCounters,
+                this->workerController, report
+        );
+        return report;
+    }
+
+    /**
+     * Takes a snapshot of the queue depth, the state of every Worker including the age of its current task,
+     * the pending results and the connections of every Signal, may be called from any thread. \n
+     * The WorkerController fills the snapshot between two events, so dispatching is only delayed by copying the
+     * state of the Worker. See ControllerConfiguration::introspectionFile for writing snapshots on request.
+     *
+     * @return The snapshot, use IntrospectionSnapshot::toJson() to convert it to JSON
+     */
+    [[nodiscard]] inline IntrospectionSnapshot introspect() const {
+        if (!this->workerController) {
+            return IntrospectionSnapshot();
+        }
+
+        IntrospectionSnapshot snapshot;
+        invokeInContext(
+                static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                &WorkerController<T, R>::introspect,
+                this->workerController, snapshot
+        );
+        snapshot.signalConnections = SignalProvider::connectionCounts();
+        return snapshot;
+    }
+
+    /**
+     * Returns the current memory accounting, may be called from any thread
+     *
+     * @return A copy of the Metrics of the WorkerController
+     */
+    [[nodiscard]] inline MetricsSnapshot metrics() const {
+        if (!this->workerController) {
+            return MetricsSnapshot();
+        }
+
+        return this->workerController->metrics.snapshot();
     }
 
 private:
+    /**
+     * Polls a condition until it is met or a deadline has passed, see Controller::shutdown()
+     *
+     * @tparam Condition The type of \p condition
+     * @param deadline The time to give up at
+     * @param condition Returns \p true once met, called from the calling thread
+     * @return \p true if \p condition has been met, \p false if the deadline passed before
+     */
+    template<typename Condition>
+    inline bool waitUntil(const std::chrono::steady_clock::time_point &deadline, const Condition condition) const {
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            QThread::msleep(1);
+        }
+        return true;
+    }
+
+    /**
+     * Schedules a task, see scheduleAt() and scheduleEvery()
+     *
+     * @param task The task to give to the queue
+     * @param due The time to give the task to the queue at
+     * @param period The time between two copies of the task, 0 to give the task once
+     * @return The id to cancel the scheduled task with cancelScheduled()
+     */
+    inline TimerId schedule(const T &task, const std::chrono::steady_clock::time_point &due,
+                            const std::chrono::nanoseconds &period) {
+        if (!this->workerController) {
+            return 0;
+        }
+
+        TimerId id = 0;
+        invokeInContext(
+                static_cast<QObject *>(this->workerController), Qt::BlockingQueuedConnection,
+                &WorkerController<T, R>::scheduleTask,
+                this->workerController, task, due, period, id
+        );
+        return id;
+    }
+
     /**
      * Thread containing the WorkerController
      */
-    QThread workerControllerThread;
+    std::unique_ptr<QThread> workerControllerThread = std::make_unique<QThread>();
+    /**
+     * The WorkerController, owned by Controller::workerControllerThread, nullptr once stopped with shutdown()
+     */
+    WorkerController<T, R> *workerController = nullptr;
+    /**
+     * Writes the introspection file on request, only set with ControllerConfiguration::introspectionFile
+     */
+    std::unique_ptr<Introspector> introspector;
 };
 
 #endif
@@ -0,0 +1,126 @@
+#ifndef QT_MULTITHREADING_HEDGING_H
+#define QT_MULTITHREADING_HEDGING_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Shared by a task and its duplicate, see ControllerConfiguration::hedging. \n
+ * The Worker finishing first claims the task and sends its result, the other one discards its result.
+ */
+class TaskClaim {
+public:
+    /**
+     * Claims the task, called by a Worker after having fulfilled it
+     *
+     * @param sinceClaimed Set to the time since the task has been claimed by the other Worker, if not the first claim
+     * @return \p true if this is the first claim, which means the result has to be sent, \p false otherwise
+     */
+    inline bool claim(std::chrono::nanoseconds &sinceClaimed) {
+        // the time of the first claim marks the task as claimed, the time since the epoch of the clock is never 0
+        const std::chrono::steady_clock::duration now = std::chrono::steady_clock::now().time_since_epoch();
+        std::chrono::steady_clock::rep unclaimed = 0;
+        if (this->claimedAt.compare_exchange_strong(unclaimed, now.count(), std::memory_order_acq_rel)) {
+            return true;
+        }
+        sinceClaimed = now - std::chrono::steady_clock::duration(unclaimed);
+        return false;
+    }
+
+    /**
+     * Returns, whether the task has been claimed already, which means a Worker still fulfilling it may stop
+     *
+     * @return \p true if the task has been claimed, \p false otherwise
+     */
+    [[nodiscard]] inline bool isClaimed() const {
+        return this->claimedAt.load(std::memory_order_acquire) != 0;
+    }
+
+private:
+    /**
+     * The time of the first claim in ticks of std::chrono::steady_clock, 0 if not claimed yet
+     */
+    std::atomic<std::chrono::steady_clock::rep> claimedAt = 0;
+};
+
+/**
+ * Keeps the execution times of the most recent tasks to calculate a percentile, e.g. the p95 used for hedging
+ */
+class ExecutionTimeWindow {
+public:
+    /**
+     * Adds the execution time of a task, replacing the oldest one when the window is full
+     *
+     * @param executionTime The execution time of the task
+     */
+    inline void add(const std::chrono::nanoseconds executionTime) {
+        if (this->executionTimes.size() < ExecutionTimeWindow::size) {
+            this->executionTimes.push_back(executionTime);
+        } else {
+            this->executionTimes[this->next] = executionTime;
+        }
+        this->next = (this->next + 1) % ExecutionTimeWindow::size;
+        ++this->addedSinceCalculation;
+    }
+
+    /**
+     * Returns a percentile of the execution times in the window. \n
+     * Recalculated only after enough new execution times have been added, since it sorts a copy of the window.
+     *
+     * @param fraction The percentile in [0, 1]
+     * @return The percentile, std::chrono::nanoseconds::max() while there are less than
+     *         ExecutionTimeWindow::minimumSamples execution times
+     */
+    inline std::chrono::nanoseconds percentile(const double fraction) {
+        if (this->executionTimes.size() < ExecutionTimeWindow::minimumSamples) {
+            return std::chrono::nanoseconds::max();
+        }
+        if (fraction != this->calculatedFraction ||
+            this->addedSinceCalculation >= ExecutionTimeWindow::minimumSamples) {
+            std::vector<std::chrono::nanoseconds> sorted = this->executionTimes;
+            const auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+            std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(index), sorted.end());
+            this->calculated = sorted[index];
+            this->calculatedFraction = fraction;
+            this->addedSinceCalculation = 0;
+        }
+        return this->calculated;
+    }
+
+    /**
+     * The number of execution times needed for a percentile
+     */
+    static constexpr std::size_t minimumSamples = 32;
+    /**
+     * The number of execution times kept
+     */
+    static constexpr std::size_t size = 1024;
+
+private:
+    /**
+     * The execution times, used as ring buffer once full
+     */
+    std::vector<std::chrono::nanoseconds> executionTimes;
+    /**
+     * The index the next execution time is written to
+     */
+    std::size_t next = 0;
+    /**
+     * The number of execution times added since the last calculation
+     */
+    std::size_t addedSinceCalculation = 0;
+    /**
+     * The fraction of the last calculation
+     */
+    double calculatedFraction = -1;
+    /**
+     * The result of the last calculation
+     */
+    std::chrono::nanoseconds calculated{0};
+};
+
+#endif
@@ -0,0 +1,460 @@
+#ifndef QT_MULTITHREADING_HUGEPAGEALLOCATOR_H
+#define QT_MULTITHREADING_HUGEPAGEALLOCATOR_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__linux__)
+
+#include <sys/mman.h>
+
+#endif
+
+/**
+ * Trait used to opt a task type into queue storage backed by huge pages, see HugePageAllocator. \n
+ * Worth it for queues reaching gigabytes, where the misses of the TLB (the cache of the address translations of the
+ * CPU) become noticeable: a 2 MB page needs a single TLB entry, where 512 normal pages of 4 KB need one each.
+ * Applies to the queue of the WorkerController including its deprioritized tasks and the tail buffer of the spill
+ * queue, also in combination with SoAStorageEnabled.
+ *
+ * Example: \n
+ * template<> struct HugePagesEnabled<return_tuple> : std::true_type {};
+ *
+ * @tparam T The data type of the task to fulfill
+ */
+template<typename T>
+struct HugePagesEnabled : std::false_type {
+};
+
+/**
+ * The memory taken from the operating system by the HugePageArena
+ */
+struct HugePageStatistics {
+    /**
+     * The number of bytes mapped, including the free blocks kept for reuse
+     */
+    std::size_t mappedBytes = 0;
+    /**
+     * The number of mapped bytes backed by explicit huge pages, see HugePageArena::useExplicitPages()
+     */
+    std::size_t explicitBytes = 0;
+    /**
+     * The number of bytes handed out and not deallocated yet, rounded up to the size of the blocks
+     */
+    std::size_t allocatedBytes = 0;
+};
+
+/**
+ * The process-wide memory behind every HugePageAllocator. \n
+ * Memory is mapped in regions aligned to 2 MB, for which the kernel is asked to use transparent huge pages with
+ * madvise(MADV_HUGEPAGE). If explicit huge pages are enabled with useExplicitPages() and the pool reserved with
+ * /proc/sys/vm/nr_hugepages has free pages, they are used instead. If neither is available, e.g. since transparent
+ * huge pages are set to "never", the memory simply stays backed by normal pages.
+ *
+ * Containers allocate many small blocks (e.g. the 512 byte blocks of a std::deque), which would end up on their own
+ * pages when mapped one by one. Thus blocks up to 1 MB are carved from shared 2 MB chunks, with a free list for every
+ * power of two size, so that a queue of millions of tasks only spans as many huge pages as it needs. Freed blocks are
+ * kept for reuse and only returned to the operating system when the process exits. Larger blocks get a mapping of
+ * their own, which is unmapped when deallocated.
+ *
+ * Thread-safe, but guarded by a single mutex, since the containers of the framework are only used by the thread of
+ * the WorkerController. On other systems than Linux, the memory is taken from operator new.
+ */
+class HugePageArena {
+public:
+    /**
+     * The size of a huge page on x86-64 and of the regions mapped
+     */
+    static constexpr std::size_t hugePageSize = std::size_t(2) * 1024 * 1024;
+    /**
+     * The alignment of all blocks, which is also the smallest block size
+     */
+    static constexpr std::size_t blockAlignment = 64;
+
+    HugePageArena(const HugePageArena &) = delete;
+
+    HugePageArena &operator=(const HugePageArena &) = delete;
+
+    /**
+     * Returns the arena shared by all HugePageAllocator
+     *
+     * @return The arena, which is never destroyed, so that containers destroyed during the exit can still deallocate
+     */
+    static inline HugePageArena &instance() {
+        static HugePageArena *const arena = new HugePageArena();
+        return *arena;
+    }
+
+    /**
+     * Chooses whether explicit huge pages are tried before transparent huge pages. \n
+     * Off by default, since the pool of explicit huge pages is usually reserved for a specific application.
+     * Only affects regions mapped afterwards.
+     *
+     * @param enabled \p true to try explicit huge pages first
+     */
+    inline void useExplicitPages(const bool enabled) {
+        this->explicitPages.store(enabled, std::memory_order_relaxed);
+    }
+
+    /**
+     * Allocates a block
+     *
+     * @param bytes The number of bytes
+     * @return The block aligned to HugePageArena::blockAlignment, nullptr if no memory could be mapped
+     */
+    inline void *allocate(const std::size_t bytes) {
+#if defined(__linux__)
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (bytes > HugePageArena::largestPooledBlock) {
+            const std::size_t regionBytes = HugePageArena::roundUp(bytes, HugePageArena::hugePageSize);
+            bool explicitRegion = false;
+            void *const region = this->map(regionBytes, explicitRegion);
+            if (region) {
+                this->statistics.allocatedBytes += regionBytes;
+                if (explicitRegion) {
+                    this->explicitRegions.insert(region);
+                }
+            }
+            return region;
+        }
+
+        const std::size_t sizeClass = HugePageArena::sizeClassOf(bytes);
+        if (!this->freeBlocks[sizeClass] && !this->carve(sizeClass)) {
+            return nullptr;
+        }
+        FreeBlock *const block = this->freeBlocks[sizeClass];
+        this->freeBlocks[sizeClass] = block->next;
+        this->statistics.allocatedBytes += HugePageArena::blockSizeOf(sizeClass);
+        return block;
+#else
+        return ::operator new(bytes, std::align_val_t(HugePageArena::blockAlignment), std::nothrow);
+#endif
+    }
+
+    /**
+     * Deallocates a block
+     *
+     * @param block The block returned by allocate()
+     * @param bytes The number of bytes given to allocate()
+     */
+    inline void deallocate(void *const block, const std::size_t bytes) {
+#if defined(__linux__)
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (bytes > HugePageArena::largestPooledBlock) {
+            const std::size_t regionBytes = HugePageArena::roundUp(bytes, HugePageArena::hugePageSize);
+            munmap(block, regionBytes);
+            this->statistics.mappedBytes -= regionBytes;
+            this->statistics.allocatedBytes -= regionBytes;
+            if (this->explicitRegions.erase(block)) {
+                this->statistics.explicitBytes -= regionBytes;
+            }
+            return;
+        }
+
+        const std::size_t sizeClass = HugePageArena::sizeClassOf(bytes);
+        this->pushFreeBlock(block, sizeClass);
+        this->statistics.allocatedBytes -= HugePageArena::blockSizeOf(sizeClass);
+#else
+        Q_UNUSED(bytes)
+        ::operator delete(block, std::align_val_t(HugePageArena::blockAlignment));
+#endif
+    }
+
+    /**
+     * Returns how much memory has been taken from the operating system
+     *
+     * @return A copy of the statistics
+     */
+    [[nodiscard]] inline HugePageStatistics memory() {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->statistics;
+    }
+
+private:
+    /**
+     * A free block, linked into the free list of its size
+     */
+    struct FreeBlock {
+        /**
+         * The next free block of the same size, nullptr if it is the last one
+         */
+        FreeBlock *next;
+    };
+
+    /**
+     * The largest block carved from the shared chunks, larger blocks are mapped on their own
+     */
+    static constexpr std::size_t largestPooledBlock = HugePageArena::hugePageSize / 2;
+    /**
+     * The number of block sizes, the powers of two from HugePageArena::blockAlignment to
+     * HugePageArena::largestPooledBlock
+     */
+    static constexpr std::size_t numberOfSizeClasses = 15;
+
+    static_assert((HugePageArena::blockAlignment << (HugePageArena::numberOfSizeClasses - 1)) ==
+                  HugePageArena::largestPooledBlock, "every power of two block size needs a size class");
+
+    /**
+     * Only HugePageArena::instance() creates the arena
+     */
+    HugePageArena() = default;
+
+    /**
+     * Rounds up to a multiple of a power of two
+     *
+     * @param bytes The number of bytes to round up
+     * @param multiple The power of two
+     * @return The rounded up number of bytes
+     */
+    static constexpr std::size_t roundUp(const std::size_t bytes, const std::size_t multiple) {
+        return (bytes + multiple - 1) & ~(multiple - 1);
+    }
+
+    /**
+     * Returns the size class of a block
+     *
+     * @param bytes The number of bytes needed, at most HugePageArena::largestPooledBlock
+     * @return The index of the smallest block size fitting \p bytes
+     */
+    static constexpr std::size_t sizeClassOf(const std::size_t bytes) {
+        std::size_t sizeClass = 0;
+        while (HugePageArena::blockSizeOf(sizeClass) < bytes) {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    /**
+     * Returns the size of the blocks of a size class
+     *
+     * @param sizeClass The index of the size class
+     * @return The number of bytes
+     */
+    static constexpr std::size_t blockSizeOf(const std::size_t sizeClass) {
+        return HugePageArena::blockAlignment << sizeClass;
+    }
+
+    /**
+     * Links a block into the free list of its size class
+     *
+     * @param block The free block
+     * @param sizeClass The size class of \p block
+     */
+    inline void pushFreeBlock(void *const block, const std::size_t sizeClass) {
+        FreeBlock *const freeBlock = static_cast<FreeBlock *>(block);
+        freeBlock->next = this->freeBlocks[sizeClass];
+        this->freeBlocks[sizeClass] = freeBlock;
+    }
+
+    /**
+     * Carves a new block of a size class from the current chunk, a new chunk is mapped if the current one is full. \n
+     * The rest of a full chunk is split into the free lists of the smaller size classes, so that nothing is wasted.
+     *
+     * @param sizeClass The size class of the block
+     * @return \p true if a free block of \p sizeClass is available now, \p false if no memory could be mapped
+     */
+    inline bool carve(const std::size_t sizeClass) {
+        const std::size_t blockSize = HugePageArena::blockSizeOf(sizeClass);
+        if (static_cast<std::size_t>(this->chunkEnd - this->chunkCursor) < blockSize) {
+            for (std::size_t restClass = HugePageArena::numberOfSizeClasses; restClass-- > 0;) {
+                while (static_cast<std::size_t>(this->chunkEnd - this->chunkCursor) >=
+                       HugePageArena::blockSizeOf(restClass)) {
+                    this->pushFreeBlock(this->chunkCursor, restClass);
+                    this->chunkCursor += HugePageArena::blockSizeOf(restClass);
+                }
+            }
+            bool explicitChunk = false;
+            char *const chunk = static_cast<char *>(this->map(HugePageArena::hugePageSize, explicitChunk));
+            if (!chunk) {
+                return false;
+            }
+            this->chunkCursor = chunk;
+            this->chunkEnd = chunk + HugePageArena::hugePageSize;
+        }
+        this->pushFreeBlock(this->chunkCursor, sizeClass);
+        this->chunkCursor += blockSize;
+        return true;
+    }
+
+#if defined(__linux__)
+
+    /**
+     * Maps a region aligned to HugePageArena::hugePageSize, backed by huge pages if possible
+     *
+     * @param bytes The size of the region, a multiple of HugePageArena::hugePageSize
+     * @param explicitRegion Set to \p true if the region is backed by explicit huge pages
+     * @return The region, nullptr if it could not be mapped
+     */
+    inline void *map(const std::size_t bytes, bool &explicitRegion) {
+        explicitRegion = false;
+        if (this->explicitPages.load(std::memory_order_relaxed)) {
+            void *const region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (region != MAP_FAILED) {
+                this->statistics.mappedBytes += bytes;
+                this->statistics.explicitBytes += bytes;
+                explicitRegion = true;
+                return region;
+            }
+        }
+
+        // the kernel only uses transparent huge pages for aligned ranges, thus map more and trim to the alignment
+        const std::size_t paddedBytes = bytes + HugePageArena::hugePageSize;
+        char *const padded = static_cast<char *>(mmap(nullptr, paddedBytes, PROT_READ | PROT_WRITE,
+                                                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (padded == MAP_FAILED) {
+            return nullptr;
+        }
+        char *const region = padded + (HugePageArena::hugePageSize -
+                                       reinterpret_cast<std::uintptr_t>(padded) % HugePageArena::hugePageSize) %
+                                      HugePageArena::hugePageSize;
+        if (region != padded) {
+            munmap(padded, static_cast<std::size_t>(region - padded));
+        }
+        if (region + bytes != padded + paddedBytes) {
+            munmap(region + bytes, static_cast<std::size_t>(padded + paddedBytes - (region + bytes)));
+        }
+#if defined(MADV_HUGEPAGE)
+        // fails harmlessly, if transparent huge pages are disabled
+        madvise(region, bytes, MADV_HUGEPAGE);
+#endif
+        this->statistics.mappedBytes += bytes;
+        return region;
+    }
+
+#else
+
+    /**
+     * Nothing is mapped on other systems than Linux, see HugePageArena::allocate()
+     *
+     * @return nullptr
+     */
+    inline void *map(const std::size_t, bool &explicitRegion) {
+        explicitRegion = false;
+        return nullptr;
+    }
+
+#endif
+
+    /**
+     * Protects everything but HugePageArena::explicitPages
+     */
+    std::mutex mutex;
+    /**
+     * See useExplicitPages()
+     */
+    std::atomic<bool> explicitPages = false;
+    /**
+     * The free blocks, one list per size class
+     */
+    std::array<FreeBlock *, HugePageArena::numberOfSizeClasses> freeBlocks{};
+    /**
+     * The start of the part of the current chunk, from which no blocks have been carved yet
+     */
+    char *chunkCursor = nullptr;
+    /**
+     * The end of the current chunk
+     */
+    char *chunkEnd = nullptr;
+    /**
+     * The regions mapped on their own, which are backed by explicit huge pages
+     */
+    std::unordered_set<void *> explicitRegions;
+    /**
+     * See memory()
+     */
+    HugePageStatistics statistics;
+};
+
+/**
+ * Allocator taking its memory from the HugePageArena, to be used with the containers of the standard library. \n
+ * Used for the queue of the WorkerController if HugePagesEnabled has been specialized for the task type, and may be
+ * used for large state shared by all Worker as well, e.g. with HugePageVector or std::allocate_shared().
+ *
+ * Notice: Only supports types aligned to at most HugePageArena::blockAlignment.
+ *
+ * @tparam T The data type to allocate
+ */
+template<typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+
+    /**
+     * Converting constructor needed by the containers to allocate their internal types
+     *
+     * @tparam U The data type the other allocator allocates
+     */
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U> &) noexcept {}
+
+    /**
+     * Allocates storage for \p n elements
+     *
+     * @param n The number of elements
+     * @return The uninitialized storage
+     */
+    [[nodiscard]] inline T *allocate(const std::size_t n) {
+        static_assert(alignof(T) <= HugePageArena::blockAlignment, "HugePageAllocator does not support the alignment");
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void *const storage = HugePageArena::instance().allocate(n * sizeof(T));
+        if (!storage) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(storage);
+    }
+
+    /**
+     * Deallocates storage returned by allocate()
+     *
+     * @param storage The storage
+     * @param n The number of elements given to allocate()
+     */
+    inline void deallocate(T *const storage, const std::size_t n) noexcept {
+        HugePageArena::instance().deallocate(storage, n * sizeof(T));
+    }
+
+    /**
+     * All HugePageAllocator share the HugePageArena, thus any of them may deallocate what another one allocated
+     *
+     * @tparam U The data type the other allocator allocates
+     * @return Always \p true
+     */
+    template<typename U>
+    inline bool operator==(const HugePageAllocator<U> &) const noexcept {
+        return true;
+    }
+};
+
+/**
+ * A std::vector backed by huge pages, e.g. for large read-only state shared by all Worker
+ *
+ * @tparam T The data type of the elements
+ */
+template<typename T>
+using HugePageVector = std::vector<T, HugePageAllocator<T>>;
+
+/**
+ * The allocator of the containers storing tasks, a HugePageAllocator if HugePagesEnabled has been specialized for
+ * \p T, the std::allocator otherwise
+ *
+ * @tparam T The data type of the task to fulfill
+ */
+template<typename T>
+using TaskAllocator = std::conditional_t<HugePagesEnabled<T>::value, HugePageAllocator<T>, std::allocator<T>>;
+
+#endif
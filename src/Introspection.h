@@ -0,0 +1,498 @@
+#ifndef QT_MULTITHREADING_INTROSPECTION_H
+#define QT_MULTITHREADING_INTROSPECTION_H
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QSaveFile>
+#include <QSocketNotifier>
+#include <QString>
+#include <QThread>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Magic.h"
+#include "Metrics.h"
+
+#if defined(__unix__)
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#endif
+
+/**
+ * The state of a single Worker, as seen by the WorkerController
+ */
+struct WorkerIntrospection {
+    /**
+     * The index of the Worker
+     */
+    std::size_t index = 0;
+    /**
+     * Whether the Worker is fulfilling a task, or the task is waiting in the event queue of the Worker
+     */
+    bool busy = false;
+    /**
+     * The id of the task the Worker is busy with, see RecordedSubmission::id
+     */
+    std::uint64_t taskId = 0;
+    /**
+     * The time since the task has been sent to the Worker, 0 if the Worker is idle
+     */
+    std::chrono::nanoseconds taskAge{0};
+    /**
+     * The ids of the tasks sent together with the current one, which the Worker fulfills after it,
+     * see ControllerConfiguration::dispatchBatchSize
+     */
+    std::vector<std::uint64_t> batchedTaskIds;
+};
+
+/**
+ * The state of a Controller at a point in time, see Controller::introspect()
+ */
+struct IntrospectionSnapshot {
+    /**
+     * The time the snapshot has been taken
+     */
+    std::chrono::system_clock::time_point time;
+    /**
+     * The number of threads set, which may be larger than the number of running Worker when using lazy worker start
+     */
+    std::size_t targetNumberOfThreads = 0;
+    /**
+     * The state of every running Worker
+     */
+    std::vector<WorkerIntrospection> workers;
+    /**
+     * The queue depth, the pending result events and everything else Controller::metrics() returns
+     */
+    MetricsSnapshot metrics;
+    /**
+     * The number of connections of every existing Signal
+     */
+    std::vector<SignalConnections> signalConnections;
+
+    /**
+     * Converts the snapshot to JSON
+     *
+     * @return The snapshot as indented JSON
+     */
+    [[nodiscard]] inline QByteArray toJson() const {
+        QJsonObject queue;
+        queue["tasks"] = static_cast<qint64>(this->metrics.queuedTasks);
+        queue["bytes"] = static_cast<qint64>(this->metrics.queuedBytes);
+        queue["spilledTasks"] = static_cast<qint64>(this->metrics.spilledTasks);
+        queue["spillReadFailures"] = static_cast<qint64>(this->metrics.spillReadFailures);
+        queue["deprioritizedTasks"] = static_cast<qint64>(this->metrics.deprioritizedTasks);
+        queue["rejectedTasks"] = static_cast<qint64>(this->metrics.rejectedTasks);
+        queue["scheduledTasks"] = static_cast<qint64>(this->metrics.scheduledTasks);
+        queue["estimatedWaitMicroseconds"] = static_cast<qint64>(
+                std::chrono::duration_cast<std::chrono::microseconds>(this->metrics.estimatedQueueWait).count()
+        );
+
+        QJsonArray workerArray;
+        for (const WorkerIntrospection &worker : this->workers) {
+            QJsonObject workerObject;
+            workerObject["index"] = static_cast<qint64>(worker.index);
+            workerObject["state"] = worker.busy ? "busy" : "idle";
+            if (worker.busy) {
+                workerObject["taskId"] = static_cast<qint64>(worker.taskId);
+                workerObject["taskAgeMicroseconds"] = static_cast<qint64>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(worker.taskAge).count()
+                );
+            }
+            if (!worker.batchedTaskIds.empty()) {
+                QJsonArray batchedArray;
+                for (const std::uint64_t batchedTaskId : worker.batchedTaskIds) {
+                    batchedArray.append(static_cast<qint64>(batchedTaskId));
+                }
+                workerObject["batchedTaskIds"] = batchedArray;
+            }
+            workerArray.append(workerObject);
+        }
+
+        QJsonObject results;
+        results["pending"] = static_cast<qint64>(this->metrics.pendingResults);
+        results["pendingBytes"] = static_cast<qint64>(this->metrics.pendingResultBytes);
+
+        QJsonObject hedging;
+        hedging["completedTasks"] = static_cast<qint64>(this->metrics.completedTasks);
+        hedging["hedgedTasks"] = static_cast<qint64>(this->metrics.hedgedTasks);
+        hedging["hedgeWins"] = static_cast<qint64>(this->metrics.hedgeWins);
+        hedging["savedMicroseconds"] = static_cast<qint64>(
+                std::chrono::duration_cast<std::chrono::microseconds>(this->metrics.hedgeSavedTime).count()
+        );
+
+        QJsonObject remote;
+        remote["connections"] = static_cast<qint64>(this->metrics.remoteConnections);
+        remote["reassignedTasks"] = static_cast<qint64>(this->metrics.reassignedTasks);
+
+        QJsonObject tuning;
+        tuning["workers"] = static_cast<qint64>(this->metrics.tunedWorkers);
+        tuning["batchSize"] = static_cast<qint64>(this->metrics.tunedBatchSize);
+        tuning["calibrations"] = static_cast<qint64>(this->metrics.tuningCalibrations);
+
+        QJsonArray signalArray;
+        for (const SignalConnections &signal : this->signalConnections) {
+            QJsonObject signalObject;
+            signalObject["name"] = signal.name;
+            signalObject["address"] = QString::number(signal.address, 16);
+            signalObject["connections"] = static_cast<qint64>(signal.connections);
+            signalArray.append(signalObject);
+        }
+
+        QJsonObject root;
+        root["timeMilliseconds"] = static_cast<qint64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                this->time.time_since_epoch()
+        ).count());
+        root["targetNumberOfThreads"] = static_cast<qint64>(this->targetNumberOfThreads);
+        root["queue"] = queue;
+        root["inFlightTasks"] = static_cast<qint64>(this->metrics.inFlightTasks);
+        root["workers"] = workerArray;
+        root["results"] = results;
+        root["hedging"] = hedging;
+        root["remote"] = remote;
+        root["tuning"] = tuning;
+        root["signals"] = signalArray;
+        return QJsonDocument(root).toJson(QJsonDocument::Indented);
+    }
+};
+
+/**
+ * Writes IntrospectionSnapshot as JSON to a file on request, see ControllerConfiguration::introspectionFile. \n
+ * A dump is requested by a POSIX signal, e.g. SIGUSR1, or by connecting to a local Unix socket,
+ * which additionally receives the JSON before being closed.
+ *
+ * Requests are handled in a thread of its own, which asks the WorkerController for the snapshot between two events
+ * and writes the file afterwards, so that dispatching tasks is not stopped while writing.
+ *
+ * Notice: The signal handler stays installed after destruction, it then simply does nothing.
+ * At most Introspector::maximumSignalled instances may listen to signals at once.
+ */
+class Introspector {
+public:
+    /**
+     * Constructor used to start the thread and to listen for requests
+     *
+     * @param snapshot Takes the snapshot, called in the thread of the Introspector
+     * @param fileName The file to write the JSON to
+     * @param signalNumber The POSIX signal requesting a dump, 0 to not listen to signals
+     * @param socketName The path of the local Unix socket requesting a dump, empty to not listen to a socket
+     */
+    Introspector(std::function<IntrospectionSnapshot()> snapshot, const QString &fileName, const int signalNumber,
+                 const QString &socketName)
+            : snapshot(std::move(snapshot)), fileName(fileName), socketName(socketName) {
+        this->context.moveToThread(&this->thread);
+        this->thread.start();
+        invokeInContext(
+                &this->context, Qt::BlockingQueuedConnection,
+                [this, signalNumber]() -> void { this->listen(signalNumber); }
+        );
+    }
+
+    /**
+     * Stops listening for requests and stops the thread
+     */
+    ~Introspector() {
+        invokeInContext(
+                &this->context, Qt::BlockingQueuedConnection,
+                [this]() -> void {
+                    this->signalNotifier.reset();
+                    this->socketNotifier.reset();
+                }
+        );
+        this->thread.quit();
+        this->thread.wait();
+        this->close();
+    }
+
+    Introspector(const Introspector &) = delete;
+
+    Introspector &operator=(const Introspector &) = delete;
+
+    /**
+     * Takes a snapshot and writes it to the file, may be called from any thread
+     *
+     * @return \p true if the file could be written, \p false otherwise
+     */
+    inline bool dump() {
+        bool written = false;
+        invokeInContext(
+                &this->context, Qt::BlockingQueuedConnection,
+                [this, &written]() -> void { written = !this->write().isEmpty(); }
+        );
+        return written;
+    }
+
+    /**
+     * The maximum number of instances listening to signals at once
+     */
+    static constexpr std::size_t maximumSignalled = 16;
+
+private:
+    /**
+     * Takes the snapshot
+     */
+    std::function<IntrospectionSnapshot()> snapshot;
+    /**
+     * The file to write the JSON to
+     */
+    const QString fileName;
+    /**
+     * The path of the local Unix socket, empty if not listening to a socket
+     */
+    const QString socketName;
+    /**
+     * The thread handling the requests
+     */
+    QThread thread;
+    /**
+     * Lives in Introspector::thread, used to execute code in that thread
+     */
+    QObject context;
+    /**
+     * Notifies about requests by signals
+     */
+    std::unique_ptr<QSocketNotifier> signalNotifier;
+    /**
+     * Notifies about connections to the socket
+     */
+    std::unique_ptr<QSocketNotifier> socketNotifier;
+    /**
+     * The socket pair the signal handler writes to, the first one is read by the Introspector
+     */
+    int signalPipe[2] = {-1, -1};
+    /**
+     * The listening local Unix socket
+     */
+    int serverSocket = -1;
+    /**
+     * The write ends of the socket pairs of all instances listening to signals, read by the signal handler
+     */
+    static inline std::array<std::atomic<int>, maximumSignalled> signalledSockets = {};
+    /**
+     * The number of signal handlers currently running, so that a descriptor removed from
+     * Introspector::signalledSockets is only closed once no signal handler can write to it anymore
+     */
+    static inline std::atomic<int> runningHandlers = 0;
+
+    /**
+     * Takes a snapshot and writes it to the file
+     *
+     * @return The written JSON, empty if the file could not be written
+     */
+    inline QByteArray write() {
+        const QByteArray json = this->snapshot().toJson();
+        QSaveFile file(this->fileName);
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit()) {
+            qWarning("Introspector: could not write the introspection file");
+            return QByteArray();
+        }
+        return json;
+    }
+
+    /**
+     * Starts listening for requests, called in the thread of the Introspector
+     *
+     * @param signalNumber See Introspector::Introspector()
+     */
+    inline void listen(const int signalNumber) {
+#if defined(__unix__)
+        if (signalNumber && socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, this->signalPipe) == 0) {
+            fcntl(this->signalPipe[1], F_SETFL, O_NONBLOCK);
+            bool registered = false;
+            for (std::atomic<int> &signalledSocket : Introspector::signalledSockets) {
+                int expected = 0;
+                // 0 marks a free entry, the descriptors are stored incremented by one
+                if (signalledSocket.compare_exchange_strong(expected, this->signalPipe[1] + 1)) {
+                    registered = true;
+                    break;
+                }
+            }
+
+            if (registered) {
+                struct sigaction action{};
+                action.sa_handler = &Introspector::handleSignal;
+                sigemptyset(&action.sa_mask);
+                action.sa_flags = SA_RESTART;
+                sigaction(signalNumber, &action, nullptr);
+
+                this->signalNotifier = std::make_unique<QSocketNotifier>(this->signalPipe[0], QSocketNotifier::Read);
+                QObject::connect(
+                        this->signalNotifier.get(), &QSocketNotifier::activated, &this->context,
+                        [this]() -> void { this->signalled(); }
+                );
+            } else {
+                qWarning("Introspector: too many instances listening to signals");
+            }
+        }
+
+        if (!this->socketName.isEmpty()) {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            const QByteArray path = this->socketName.toLocal8Bit();
+            if (static_cast<std::size_t>(path.size()) >= sizeof(address.sun_path)) {
+                qWarning("Introspector: the path of the socket is too long");
+                return;
+            }
+            std::copy(path.constData(), path.constData() + path.size(), address.sun_path);
+
+            // a socket file left behind by a previous process would let bind() fail
+            if (!Introspector::removeSocketFile(path.constData())) {
+                qWarning("Introspector: the path of the socket is in use");
+                return;
+            }
+            this->serverSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (this->serverSocket < 0 ||
+                bind(this->serverSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+                ::listen(this->serverSocket, 4) != 0) {
+                qWarning("Introspector: could not listen on the socket");
+                return;
+            }
+
+            this->socketNotifier = std::make_unique<QSocketNotifier>(this->serverSocket, QSocketNotifier::Read);
+            QObject::connect(
+                    this->socketNotifier.get(), &QSocketNotifier::activated, &this->context,
+                    [this]() -> void { this->accepted(); }
+            );
+        }
+#else
+        Q_UNUSED(signalNumber)
+#endif
+    }
+
+    /**
+     * Handles the requests by signals, called in the thread of the Introspector
+     */
+    inline void signalled() {
+#if defined(__unix__)
+        // several signals may have been coalesced, one dump covers all of them
+        char buffer[64];
+        while (recv(this->signalPipe[0], buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {}
+        this->write();
+#endif
+    }
+
+    /**
+     * Handles a connection to the socket, called in the thread of the Introspector
+     */
+    inline void accepted() {
+#if defined(__unix__)
+        const int connection = accept4(this->serverSocket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0) {
+            return;
+        }
+        const QByteArray json = this->write();
+        for (qint64 sent = 0; sent < json.size();) {
+            const ssize_t bytes = send(connection, json.constData() + sent, json.size() - sent, MSG_NOSIGNAL);
+            if (bytes <= 0) {
+                break;
+            }
+            sent += bytes;
+        }
+        ::close(connection);
+#endif
+    }
+
+    /**
+     * Closes all descriptors, called after the thread has been stopped
+     */
+    inline void close() {
+#if defined(__unix__)
+        if (this->signalPipe[1] >= 0) {
+            for (std::atomic<int> &signalledSocket : Introspector::signalledSockets) {
+                int expected = this->signalPipe[1] + 1;
+                signalledSocket.compare_exchange_strong(expected, 0);
+            }
+            // a signal handler may have loaded the descriptor before it has been removed,
+            // closing it meanwhile would let the handler write to whatever reuses the descriptor
+            while (Introspector::runningHandlers.load()) {
+                QThread::yieldCurrentThread();
+            }
+        }
+        for (int *descriptor : {&this->signalPipe[0], &this->signalPipe[1], &this->serverSocket}) {
+            if (*descriptor >= 0) {
+                ::close(*descriptor);
+                *descriptor = -1;
+            }
+        }
+        if (!this->socketName.isEmpty()) {
+            Introspector::removeSocketFile(this->socketName.toLocal8Bit().constData());
+        }
+#endif
+    }
+
+    /**
+     * Removes a stale local Unix socket, but nothing else, e.g. if the path has been mistaken for a regular file. \n
+     * A socket is only stale if nothing accepts connections on it, so that the socket of another running process,
+     * e.g. a second instance started with the same path, is left alone.
+     *
+     * @param path The path of the socket, shorter than sockaddr_un::sun_path
+     * @return \p true if the path is free now, \p false if it is used by something else
+     */
+    static inline bool removeSocketFile(const char *const path) {
+#if defined(__unix__)
+        struct stat status{};
+        if (lstat(path, &status) != 0) {
+            return errno == ENOENT;
+        }
+        if (!S_ISSOCK(status.st_mode)) {
+            return false;
+        }
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+        const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe < 0) {
+            return false;
+        }
+        const bool answered = ::connect(probe, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0 ||
+                              errno != ECONNREFUSED;
+        ::close(probe);
+        return !answered && unlink(path) == 0;
+#else
+        Q_UNUSED(path)
+        return true;
+#endif
+    }
+
+    /**
+     * The signal handler, which only writes a byte to the socket pair of every instance, which is async-signal-safe
+     *
+     * @param signalNumber The received signal
+     */
+    static inline void handleSignal(const int signalNumber) {
+        Q_UNUSED(signalNumber)
+#if defined(__unix__)
+        const int savedErrno = errno;
+        // announced before loading the descriptors, see Introspector::close()
+        Introspector::runningHandlers.fetch_add(1);
+        for (const std::atomic<int> &signalledSocket : Introspector::signalledSockets) {
+            const int descriptor = signalledSocket.load();
+            if (descriptor) {
+                const char byte = 0;
+                [[maybe_unused]] const ssize_t written = ::write(descriptor - 1, &byte, 1);
+            }
+        }
+        Introspector::runningHandlers.fetch_sub(1);
+        errno = savedErrno;
+#endif
+    }
+};
+
+#endif
@@ -7,6 +7,9 @@
 #include <QRecursiveMutex>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QString>
+#include <atomic>
+#include <cstddef>
 #include <utility>
 #include <functional>
 #include <unordered_map>
@@ -15,6 +18,8 @@
 #include <tuple>
 #include <unordered_set>
 
+#include "ThreadParker.h"
+
 /**
  * This function allows to invoke another function in the event loop of a given \p context
  * without using Qt Signals or Slots.
@@ -34,9 +39,11 @@ inline bool invokeInContext(QObject *const context, const Qt::ConnectionType con
      * Notice, that this function makes use of std::forward() (https://en.cppreference.com/w/cpp/utility/forward)
      * in combination with "forwarding references" (https://en.cppreference.com/w/cpp/language/reference#Forwarding_references)
      *
-     * It is also being distinguished whether the invoked function call is happening in the same thread or
-     * a Qt::BlockingQueuedConnection is used (if case)
-     * or in another thread without a Qt::BlockingQueuedConnection (else case).
+     * It is also being distinguished whether a Qt::BlockingQueuedConnection is used (first case),
+     * the invoked function call is happening in the same thread (second case)
+     * or in another thread without a Qt::BlockingQueuedConnection (else case). \n
+     * A Qt::BlockingQueuedConnection waits with the ThreadParker of the calling thread instead of the QSemaphore
+     * QMetaObject::invokeMethod() would create for every call, see ThreadParker.
      *
      * This leads to using different lambdas (https://en.cppreference.com/w/cpp/language/lambda)
      * allowing the compiler not to make unneeded constructor calls for the arguments of the function to invoke.
@@ -79,8 +86,32 @@ inline bool invokeInContext(QObject *const context, const Qt::ConnectionType con
      * fire up the Qt Meta-Object compiler. This function may seem like almost nothing, but actually round about
      * 10 hours of work went into this.
      */
-    if (connectionType == Qt::DirectConnection || connectionType == Qt::BlockingQueuedConnection ||
-        (connectionType == Qt::AutoConnection && QThread::currentThread() == context->thread())) {
+    if (connectionType == Qt::BlockingQueuedConnection) {
+        // like QMetaObject::invokeMethod(), do nothing without a context, e.g. once disconnected
+        if (!context) {
+            return false;
+        }
+
+        // waiting for ourselves would never end
+        if (QThread::currentThread() == context->thread()) {
+            qWarning("invokeInContext: Dead lock detected");
+            return false;
+        }
+
+        // the arguments stay alive on our stack, since we wait until the ticket has been destroyed,
+        // which reuses the ThreadParker of this thread instead of a new QSemaphore for every call
+        ThreadParker &parker = ThreadParker::current();
+        if (!QMetaObject::invokeMethod(
+                context,
+                [&, ticket = parker.prepare()]() -> void { std::invoke(callable, std::forward<Args>(args)...); },
+                Qt::QueuedConnection
+        )) {
+            return false;
+        }
+        parker.park();
+        return true;
+    } else if (connectionType == Qt::DirectConnection ||
+               (connectionType == Qt::AutoConnection && QThread::currentThread() == context->thread())) {
 
         return QMetaObject::invokeMethod(
                 context, [&]() -> void { std::invoke(callable, std::forward<Args>(args)...); }, connectionType
@@ -138,6 +169,24 @@ inline void *functionToPointer(Return (*f)(Args...)) {
 
 class SlotProvider;
 
+/**
+ * The number of connections of a Signal, see SignalProvider::connectionCounts()
+ */
+struct SignalConnections {
+    /**
+     * The object name of the Signal, see https://doc.qt.io/qt-5/qobject.html#objectName-prop
+     */
+    QString name;
+    /**
+     * The address of the Signal, to tell apart Signals without a name
+     */
+    quintptr address = 0;
+    /**
+     * The number of Slots connected to the Signal
+     */
+    std::size_t connections = 0;
+};
+
 /**
  * Provides the interface for the template class Signal, which is the usual C++ pure virtual hack
  *
@@ -150,7 +199,85 @@ class SignalProvider {
 public:
     virtual ~SignalProvider() = default;
 
+    /**
+     * Returns the number of connections of every existing Signal, e.g. for Controller::introspect(). \n
+     * Only reads a counter per Signal, so that it never waits for a Signal being emitted.
+     *
+     * @return The number of connections of every existing Signal
+     */
+    static inline std::vector<SignalConnections> connectionCounts() {
+        QMutexLocker registryLocker(&SignalProvider::registryMutex);
+        std::vector<SignalConnections> counts;
+        counts.reserve(SignalProvider::registry.size());
+
+        for (SignalProvider *const signalProvider : SignalProvider::registry) {
+            QMutexLocker nameLocker(&signalProvider->nameMutex);
+            counts.push_back(SignalConnections{
+                    signalProvider->name, reinterpret_cast<quintptr>(signalProvider),
+                    signalProvider->numberOfConnections.load(std::memory_order_relaxed)
+            });
+        }
+
+        return counts;
+    }
+
+protected:
+    /**
+     * The number of Slots connected, kept up to date by the Signal whenever connections change
+     */
+    std::atomic<std::size_t> numberOfConnections = 0;
+
+    /**
+     * Copies the object name of the Signal into SignalProvider::name, called whenever the name changes. \n
+     * connectionCounts() reads the copy instead of the object name itself, which belongs to the thread of the Signal.
+     *
+     * @param newName The new object name of the Signal
+     */
+    inline void nameChanged(const QString &newName) {
+        QMutexLocker nameLocker(&this->nameMutex);
+        this->name = newName;
+    }
+
+    /**
+     * Adds a SignalProvider to SignalProvider::registry, called on construction
+     *
+     * @param signalProvider The SignalProvider to add
+     */
+    static inline void registerSignalProvider(SignalProvider *const signalProvider) {
+        QMutexLocker registryLocker(&SignalProvider::registryMutex);
+        SignalProvider::registry.insert(signalProvider);
+    }
+
+    /**
+     * Removes a SignalProvider from SignalProvider::registry. \n
+     * Has to be called first thing on destruction, so that connectionCounts() never sees a partly destroyed object.
+     *
+     * @param signalProvider The SignalProvider to remove
+     */
+    static inline void deregisterSignalProvider(SignalProvider *const signalProvider) {
+        QMutexLocker registryLocker(&SignalProvider::registryMutex);
+        SignalProvider::registry.erase(signalProvider);
+    }
+
 private:
+    /**
+     * All existing SignalProvider, see connectionCounts()
+     */
+    static inline std::unordered_set<SignalProvider *> registry = std::unordered_set<SignalProvider *>();
+    /**
+     * A mutex that has to be locked, when working with the SignalProvider::registry. \n
+     * No other mutex but SignalProvider::nameMutex is ever locked while holding it.
+     */
+    static inline QMutex registryMutex = QMutex();
+    /**
+     * The object name of the Signal, see nameChanged()
+     */
+    QString name;
+    /**
+     * Protects SignalProvider::name, no other mutex is ever locked while holding it
+     */
+    QMutex nameMutex;
+
     virtual void disconnectLocalInSignal(void *slot, SlotProvider *slotProvider) = 0;
 
     virtual std::unordered_set<SlotProvider *> getConnectedSlots() = 0;
@@ -417,7 +544,13 @@ public:
      *
      * @param parent The pointer to the QObject to be set as parent, if wanted
      */
-    explicit Signal<Args...>(QObject *const parent = nullptr) : SlotProvider(parent) {}
+    explicit Signal<Args...>(QObject *const parent = nullptr) : SlotProvider(parent) {
+        // executed by the thread setting the name, so that the name is never read from another thread
+        QObject::connect(this, &QObject::objectNameChanged, this, [this](const QString &newName) -> void {
+            this->nameChanged(newName);
+        }, Qt::DirectConnection);
+        SignalProvider::registerSignalProvider(this);
+    }
 
     /**
      * Constructor allowing to create a Signal based on the arguments of a given function.
@@ -442,6 +575,7 @@ public:
      * Destructor which notifies all SlotProvider, that are connected in any way to this object, about the destruction
      */
     ~Signal() final {
+        SignalProvider::deregisterSignalProvider(this);
         disconnect(nullptr, static_cast<SignalProvider *>(this), nullptr);
     }
 
@@ -558,7 +692,17 @@ private:
      */
     inline void disconnectLocalInSignal(void *const slot, SlotProvider *const slotProvider) final {
         QMutexLocker connectedSlotsLocker(&this->connectedSlotsMutex);
+        this->disconnectConnectedSlots(slot, slotProvider);
+        this->updateNumberOfConnections();
+    }
 
+    /**
+     * See disconnectLocalInSignal(), Signal::connectedSlotsMutex has to be locked already
+     *
+     * @param slot The pointer to a Slot, whose connections should be removed
+     * @param slotProvider The pointer to a SlotProvider, whose connections should be removed
+     */
+    inline void disconnectConnectedSlots(void *const slot, SlotProvider *const slotProvider) {
         if (!slot && !slotProvider) {
             this->connectedSlots.clear();
         } else if (!slot) {
@@ -583,6 +727,18 @@ private:
         }
     }
 
+    /**
+     * Counts the connected Slots into SignalProvider::numberOfConnections,
+     * Signal::connectedSlotsMutex has to be locked already
+     */
+    inline void updateNumberOfConnections() {
+        std::size_t connections = 0;
+        for (const auto &key_value : this->connectedSlots) {
+            connections += key_value.second.size();
+        }
+        this->numberOfConnections.store(connections, std::memory_order_relaxed);
+    }
+
     /**
      * Returns all SlotProvider, that are connected to this Signal in any way.
      *
@@ -636,6 +792,7 @@ private:
         } else {
             this->connectedSlots[slotProvider] = std::vector{std::make_tuple(slot, functionToAppend)};
         }
+        this->updateNumberOfConnections();
 
         slotProvider->registerConnection(slot, static_cast<SignalProvider *>(this));
     }
@@ -0,0 +1,513 @@
+#ifndef QT_MULTITHREADING_METRICS_H
+#define QT_MULTITHREADING_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "PerfCounters.h"
+#include "ThreadUsage.h"
+
+/**
+ * What a Worker measured while fulfilling a single task, sent to the WorkerController together with
+ * the notification about being ready for a new task
+ */
+struct TaskMeasurement {
+    /**
+     * The wall time spent in Worker::fulfillTask()
+     */
+    std::chrono::nanoseconds fulfillDuration{0};
+    /**
+     * The class of the task, see ControllerConfiguration::taskClass
+     */
+    std::size_t taskClass = 0;
+    /**
+     * The counter values, only measured with ControllerConfiguration::perfCounters, PerfCounterValues::tasks is 0
+     * otherwise
+     */
+    PerfCounterValues counters;
+    /**
+     * The resources used by the thread of the Worker while fulfilling the task,
+     * only measured with ControllerConfiguration::workerUsage
+     */
+    ThreadUsage usage;
+    /**
+     * Whether the result has been discarded, since the duplicate of the task finished first,
+     * see ControllerConfiguration::hedging
+     */
+    bool discarded = false;
+    /**
+     * How long after the duplicate of the task the Worker finished, only set if the result has been discarded
+     */
+    std::chrono::nanoseconds lostBy{0};
+};
+
+/**
+ * How a Worker spent the time fulfilling its tasks, see ControllerConfiguration::workerUsage
+ */
+struct WorkerUsage {
+    /**
+     * The number of fulfilled tasks
+     */
+    std::uint64_t tasks = 0;
+    /**
+     * The wall time spent in Worker::fulfillTask()
+     */
+    std::chrono::nanoseconds wallTime{0};
+    /**
+     * The CPU time spent in Worker::fulfillTask()
+     */
+    std::chrono::nanoseconds cpuTime{0};
+    /**
+     * See ThreadUsage::voluntaryContextSwitches
+     */
+    std::uint64_t voluntaryContextSwitches = 0;
+    /**
+     * See ThreadUsage::involuntaryContextSwitches
+     */
+    std::uint64_t involuntaryContextSwitches = 0;
+
+    /**
+     * Returns the fraction of the wall time, in which the Worker actually used the CPU. \n
+     * A busy Worker with a low efficiency is blocked, e.g. on I/O or locks, or preempted, which is shown by the
+     * voluntary and involuntary context switches. If the efficiency drops when adding threads,
+     * adding more threads no longer helps.
+     *
+     * @return CPU time divided by wall time, 0 if nothing has been measured
+     */
+    [[nodiscard]] inline double efficiency() const {
+        return this->wallTime.count()
+               ? static_cast<double>(this->cpuTime.count()) / static_cast<double>(this->wallTime.count()) : 0;
+    }
+
+    /**
+     * Adds the measurement of a task
+     *
+     * @param measurement The measurement of the task
+     * @return This WorkerUsage
+     */
+    inline WorkerUsage &operator+=(const TaskMeasurement &measurement) {
+        ++this->tasks;
+        this->wallTime += measurement.fulfillDuration;
+        this->cpuTime += measurement.usage.cpuTime;
+        this->voluntaryContextSwitches += measurement.usage.voluntaryContextSwitches;
+        this->involuntaryContextSwitches += measurement.usage.involuntaryContextSwitches;
+        return *this;
+    }
+};
+
+/**
+ * A copy of the Metrics of a Controller, as returned by Controller::metrics(). \n
+ * Every counter is read on its own while the WorkerController and the Worker keep updating them, so the counters
+ * are not mutually consistent, e.g. MetricsSnapshot::queuedTasks and MetricsSnapshot::queuedBytes may stem from
+ * different updates of the queue.
+ */
+struct MetricsSnapshot {
+    /**
+     * The number of tasks queued in the WorkerController, including spilled tasks
+     */
+    std::size_t queuedTasks = 0;
+    /**
+     * The number of bytes the queued tasks occupy in memory, excluding spilled tasks
+     */
+    std::size_t queuedBytes = 0;
+    /**
+     * The number of tasks currently written to spill files
+     */
+    std::size_t spilledTasks = 0;
+    /**
+     * The number of times a spill file could not be read since the start. \n
+     * Its tasks stay queued and the file is read again later.
+     */
+    std::size_t spillReadFailures = 0;
+    /**
+     * The number of tasks in the low priority queue, see AdmissionPolicy::Deprioritize. \n
+     * Not included in MetricsSnapshot::queuedTasks, but included in MetricsSnapshot::queuedBytes.
+     */
+    std::size_t deprioritizedTasks = 0;
+    /**
+     * The number of tasks rejected since the start, see AdmissionPolicy::Reject
+     */
+    std::size_t rejectedTasks = 0;
+    /**
+     * The number of delayed and periodic tasks waiting for their time, see Controller::scheduleAt(),
+     * periodic tasks count once. Not included in MetricsSnapshot::queuedTasks.
+     */
+    std::size_t scheduledTasks = 0;
+    /**
+     * The estimated queue wait of the next task given to the WorkerController, see ControllerConfiguration::queueWaitTarget
+     */
+    std::chrono::nanoseconds estimatedQueueWait{0};
+    /**
+     * The number of tasks sent to Worker, which are either waiting in the event queue of the Worker or being fulfilled
+     */
+    std::size_t inFlightTasks = 0;
+    /**
+     * The number of bytes of the in-flight tasks
+     */
+    std::size_t inFlightTaskBytes = 0;
+    /**
+     * The number of results sent by Worker, which are waiting in the event queue of the Processor
+     */
+    std::size_t pendingResults = 0;
+    /**
+     * The number of bytes of the pending results
+     */
+    std::size_t pendingResultBytes = 0;
+    /**
+     * The memory budget of the Controller, 0 if there is none, see ControllerConfiguration::memoryBudget
+     */
+    std::size_t memoryBudget = 0;
+    /**
+     * The number of tasks fulfilled since the start, not counting discarded duplicates
+     */
+    std::size_t completedTasks = 0;
+    /**
+     * The number of duplicates sent to Worker since the start, see ControllerConfiguration::hedging
+     */
+    std::size_t hedgedTasks = 0;
+    /**
+     * The number of hedged tasks, whose duplicate finished first
+     */
+    std::size_t hedgeWins = 0;
+    /**
+     * The latency saved by the duplicates finishing first, summed up. \n
+     * A lower bound, since the original Worker may stop early, see Worker::isTaskCancelled().
+     */
+    std::chrono::nanoseconds hedgeSavedTime{0};
+    /**
+     * The number of connected remote Worker hosts, see ControllerConfiguration::remoteWorkers
+     */
+    std::size_t remoteConnections = 0;
+    /**
+     * The number of tasks given to another Worker since the start, since the connection to the remote Worker
+     * fulfilling them has been lost
+     */
+    std::size_t reassignedTasks = 0;
+    /**
+     * The number of Worker tasks are given to, chosen by the AutoTuner, see ControllerConfiguration::autoTuning
+     */
+    std::size_t tunedWorkers = 0;
+    /**
+     * The dispatch batch size in use, see ControllerConfiguration::dispatchBatchSize
+     */
+    std::size_t tunedBatchSize = 0;
+    /**
+     * The number of times the AutoTuner started tuning, including the first time
+     */
+    std::size_t tuningCalibrations = 0;
+    /**
+     * The usage of every running Worker, indexed by the index of the Worker,
+     * only measured with ControllerConfiguration::workerUsage
+     */
+    std::vector<WorkerUsage> workers;
+
+    /**
+     * Returns the usage of all Worker together, see WorkerUsage::efficiency()
+     *
+     * @return The summed up usage of all Worker
+     */
+    [[nodiscard]] inline WorkerUsage totalWorkerUsage() const {
+        WorkerUsage total;
+        for (const WorkerUsage &worker : this->workers) {
+            total.tasks += worker.tasks;
+            total.wallTime += worker.wallTime;
+            total.cpuTime += worker.cpuTime;
+            total.voluntaryContextSwitches += worker.voluntaryContextSwitches;
+            total.involuntaryContextSwitches += worker.involuntaryContextSwitches;
+        }
+        return total;
+    }
+
+    /**
+     * Returns the number of bytes counting against the memory budget
+     *
+     * @return The sum of queued, in-flight and pending result bytes
+     */
+    [[nodiscard]] inline std::size_t accountedBytes() const {
+        return this->queuedBytes + this->inFlightTaskBytes + this->pendingResultBytes;
+    }
+
+    /**
+     * Returns the fraction of the completed tasks, which have been hedged, see ControllerConfiguration::hedging
+     *
+     * @return The hedged tasks divided by the completed tasks, 0 if no task has been completed
+     */
+    [[nodiscard]] inline double hedgeRate() const {
+        return this->completedTasks
+               ? static_cast<double>(this->hedgedTasks) / static_cast<double>(this->completedTasks) : 0;
+    }
+};
+
+/**
+ * The live counters of a Controller. \n
+ * Owned by the WorkerController and updated by the WorkerController, the Worker and the Processor from their
+ * respective threads, which is why all counters are atomic. Use Controller::metrics() to read them. \n
+ * The usage of the Worker is only updated by the WorkerController and protected by a mutex instead.
+ */
+class Metrics {
+public:
+    /**
+     * Constructor used to initialize the Metrics
+     *
+     * @param memoryBudget See MetricsSnapshot::memoryBudget
+     */
+    explicit Metrics(const std::size_t memoryBudget = 0) : memoryBudget(memoryBudget) {}
+
+    /**
+     * Copies all counters, each one on its own, see MetricsSnapshot
+     *
+     * @return The copied counters
+     */
+    [[nodiscard]] inline MetricsSnapshot snapshot() const {
+        MetricsSnapshot snapshot;
+        snapshot.queuedTasks = this->queuedTasks.load(std::memory_order_relaxed);
+        snapshot.queuedBytes = this->queuedBytes.load(std::memory_order_relaxed);
+        snapshot.spilledTasks = this->spilledTasks.load(std::memory_order_relaxed);
+        snapshot.spillReadFailures = this->spillReadFailures.load(std::memory_order_relaxed);
+        snapshot.deprioritizedTasks = this->deprioritizedTasks.load(std::memory_order_relaxed);
+        snapshot.rejectedTasks = this->rejectedTasks.load(std::memory_order_relaxed);
+        snapshot.scheduledTasks = this->scheduledTasks.load(std::memory_order_relaxed);
+        snapshot.estimatedQueueWait = std::chrono::nanoseconds(
+                this->estimatedQueueWait.load(std::memory_order_relaxed)
+        );
+        snapshot.inFlightTasks = this->inFlightTasks.load(std::memory_order_relaxed);
+        snapshot.inFlightTaskBytes = this->inFlightTaskBytes.load(std::memory_order_relaxed);
+        snapshot.pendingResults = this->pendingResults.load(std::memory_order_relaxed);
+        snapshot.pendingResultBytes = this->pendingResultBytes.load(std::memory_order_relaxed);
+        snapshot.memoryBudget = this->memoryBudget;
+        snapshot.completedTasks = this->completedTasks.load(std::memory_order_relaxed);
+        snapshot.hedgedTasks = this->hedgedTasks.load(std::memory_order_relaxed);
+        snapshot.hedgeWins = this->hedgeWins.load(std::memory_order_relaxed);
+        snapshot.hedgeSavedTime = std::chrono::nanoseconds(this->hedgeSavedTime.load(std::memory_order_relaxed));
+        snapshot.remoteConnections = this->remoteConnections.load(std::memory_order_relaxed);
+        snapshot.reassignedTasks = this->reassignedTasks.load(std::memory_order_relaxed);
+        snapshot.tunedWorkers = this->tunedWorkers.load(std::memory_order_relaxed);
+        snapshot.tunedBatchSize = this->tunedBatchSize.load(std::memory_order_relaxed);
+        snapshot.tuningCalibrations = this->tuningCalibrations.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(this->workersMutex);
+        snapshot.workers = this->workers;
+        return snapshot;
+    }
+
+    /**
+     * Returns the number of bytes counting against the memory budget, see MetricsSnapshot::accountedBytes()
+     *
+     * @return The sum of queued, in-flight and pending result bytes, including the tasks flushed by a TaskSubmitter
+     *         which the WorkerController has not received yet
+     */
+    [[nodiscard]] inline std::size_t accountedBytes() const {
+        return this->submittedBytes.load(std::memory_order_relaxed) +
+               this->queuedBytes.load(std::memory_order_relaxed) +
+               this->inFlightTaskBytes.load(std::memory_order_relaxed) +
+               this->pendingResultBytes.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns, whether tasks fit into the memory budget in addition to the accounted memory. \n
+     * Always \p true without a budget or while nothing is accounted, so that a batch larger than the budget on its own
+     * is accepted instead of waiting forever, see ControllerConfiguration::memoryBudget.
+     *
+     * @param bytes The number of bytes of the tasks
+     * @param unaccountedBytes The number of bytes already admitted, but not yet added to the counters
+     * @return \p true if the tasks fit, \p false otherwise
+     */
+    [[nodiscard]] inline bool fitsMemoryBudget(const std::size_t bytes, const std::size_t unaccountedBytes = 0) const {
+        const std::size_t accounted = this->accountedBytes() + unaccountedBytes;
+        return !this->memoryBudget || !accounted || accounted + bytes <= this->memoryBudget;
+    }
+
+    /**
+     * Blocks until tasks fit into the memory budget or a deadline passed, see fitsMemoryBudget(). \n
+     * The waiting thread sleeps until memory is released, see releasedBytes(), instead of polling the counters.
+     *
+     * @param bytes The number of bytes of the tasks
+     * @param deadline The time to give up at
+     * @return \p true if the tasks fit, \p false if the deadline passed before
+     */
+    inline bool awaitMemoryBudget(const std::size_t bytes,
+                                  const std::chrono::steady_clock::time_point &deadline) const {
+        if (this->fitsMemoryBudget(bytes)) {
+            return true;
+        }
+
+        std::unique_lock<std::mutex> lock(this->budgetMutex);
+        this->budgetWaiters.fetch_add(1, std::memory_order_relaxed);
+        // pairs with the fence in releasedBytes(), so that either the waiter sees the released memory
+        // or the releasing thread sees the waiter and notifies it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const bool fits = this->budgetReleased.wait_until(lock, deadline, [this, bytes]() -> bool {
+            return this->fitsMemoryBudget(bytes);
+        });
+        this->budgetWaiters.fetch_sub(1, std::memory_order_relaxed);
+        return fits;
+    }
+
+    /**
+     * Wakes the threads waiting in awaitMemoryBudget(), called after decreasing one of the accounted counters. \n
+     * Costs a fence and a load as long as nobody is waiting.
+     */
+    inline void releasedBytes() const {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->budgetWaiters.load(std::memory_order_relaxed)) {
+            // taking the mutex makes sure a waiter, which did not see the released memory, is already waiting
+            {
+                std::lock_guard<std::mutex> lock(this->budgetMutex);
+            }
+            this->budgetReleased.notify_all();
+        }
+    }
+
+    /**
+     * Adds the measurement of a task to the usage of a Worker
+     *
+     * @param workerIndex The index of the Worker
+     * @param measurement The measurement of the task
+     */
+    inline void addWorkerUsage(const std::size_t workerIndex, const TaskMeasurement &measurement) {
+        std::lock_guard<std::mutex> lock(this->workersMutex);
+        if (this->workers.size() <= workerIndex) {
+            this->workers.resize(workerIndex + 1);
+        }
+        this->workers[workerIndex] += measurement;
+    }
+
+    /**
+     * Removes the usage of Worker which are no longer running
+     *
+     * @param numberOfWorkers The number of running Worker
+     */
+    inline void removeWorkerUsage(const std::size_t numberOfWorkers) {
+        std::lock_guard<std::mutex> lock(this->workersMutex);
+        if (this->workers.size() > numberOfWorkers) {
+            this->workers.resize(numberOfWorkers);
+        }
+    }
+
+    /**
+     * See MetricsSnapshot::queuedTasks
+     */
+    std::atomic<std::size_t> queuedTasks = 0;
+    /**
+     * See MetricsSnapshot::queuedBytes
+     */
+    std::atomic<std::size_t> queuedBytes = 0;
+    /**
+     * See MetricsSnapshot::spilledTasks
+     */
+    std::atomic<std::size_t> spilledTasks = 0;
+    /**
+     * See MetricsSnapshot::spillReadFailures
+     */
+    std::atomic<std::size_t> spillReadFailures = 0;
+    /**
+     * See MetricsSnapshot::deprioritizedTasks
+     */
+    std::atomic<std::size_t> deprioritizedTasks = 0;
+    /**
+     * See MetricsSnapshot::rejectedTasks
+     */
+    std::atomic<std::size_t> rejectedTasks = 0;
+    /**
+     * See MetricsSnapshot::scheduledTasks
+     */
+    std::atomic<std::size_t> scheduledTasks = 0;
+    /**
+     * See MetricsSnapshot::estimatedQueueWait, in nanoseconds
+     */
+    std::atomic<std::int64_t> estimatedQueueWait = 0;
+    /**
+     * See MetricsSnapshot::inFlightTasks
+     */
+    std::atomic<std::size_t> inFlightTasks = 0;
+    /**
+     * See MetricsSnapshot::inFlightTaskBytes
+     */
+    std::atomic<std::size_t> inFlightTaskBytes = 0;
+    /**
+     * See MetricsSnapshot::pendingResults
+     */
+    std::atomic<std::size_t> pendingResults = 0;
+    /**
+     * See MetricsSnapshot::pendingResultBytes
+     */
+    std::atomic<std::size_t> pendingResultBytes = 0;
+    /**
+     * The bytes of the tasks flushed by a TaskSubmitter, which are on their way to the WorkerController. \n
+     * Accounted so that further flushes wait for them, not part of MetricsSnapshot, since they are counted as queued
+     * as soon as the WorkerController received them.
+     */
+    std::atomic<std::size_t> submittedBytes = 0;
+    /**
+     * See MetricsSnapshot::completedTasks
+     */
+    std::atomic<std::size_t> completedTasks = 0;
+    /**
+     * See MetricsSnapshot::hedgedTasks
+     */
+    std::atomic<std::size_t> hedgedTasks = 0;
+    /**
+     * See MetricsSnapshot::hedgeWins
+     */
+    std::atomic<std::size_t> hedgeWins = 0;
+    /**
+     * See MetricsSnapshot::hedgeSavedTime, in nanoseconds
+     */
+    std::atomic<std::int64_t> hedgeSavedTime = 0;
+    /**
+     * See MetricsSnapshot::remoteConnections
+     */
+    std::atomic<std::size_t> remoteConnections = 0;
+    /**
+     * See MetricsSnapshot::reassignedTasks
+     */
+    std::atomic<std::size_t> reassignedTasks = 0;
+    /**
+     * See MetricsSnapshot::tunedWorkers
+     */
+    std::atomic<std::size_t> tunedWorkers = 0;
+    /**
+     * See MetricsSnapshot::tunedBatchSize
+     */
+    std::atomic<std::size_t> tunedBatchSize = 0;
+    /**
+     * See MetricsSnapshot::tuningCalibrations
+     */
+    std::atomic<std::size_t> tuningCalibrations = 0;
+    /**
+     * Not a counter, but shared with the Worker the same way: set once Controller::shutdown() requests cancellation,
+     * see Worker::isTaskCancelled()
+     */
+    std::atomic<bool> shutdownRequested = false;
+    /**
+     * See MetricsSnapshot::memoryBudget
+     */
+    const std::size_t memoryBudget;
+
+private:
+    /**
+     * See MetricsSnapshot::workers
+     */
+    std::vector<WorkerUsage> workers;
+    /**
+     * Protects Metrics::workers
+     */
+    mutable std::mutex workersMutex;
+    /**
+     * The number of threads waiting in awaitMemoryBudget()
+     */
+    mutable std::atomic<std::size_t> budgetWaiters = 0;
+    /**
+     * Used together with Metrics::budgetReleased to wait for the memory budget
+     */
+    mutable std::mutex budgetMutex;
+    /**
+     * Notified by releasedBytes()
+     */
+    mutable std::condition_variable budgetReleased;
+};
+
+#endif
@@ -0,0 +1,291 @@
+#ifndef QT_MULTITHREADING_PERFCOUNTERS_H
+#define QT_MULTITHREADING_PERFCOUNTERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "ThreadUsage.h"
+
+#if defined(__linux__)
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#endif
+
+/**
+ * Counter values measured while fulfilling tasks, either of a single task or summed up over many tasks. \n
+ * The hardware counters are only available if PerfCounterValues::hardware is set,
+ * the software counters are always measured.
+ */
+struct PerfCounterValues {
+    /**
+     * The number of measured tasks
+     */
+    std::uint64_t tasks = 0;
+    /**
+     * CPU cycles spent in user space, hardware counter
+     */
+    std::uint64_t cycles = 0;
+    /**
+     * Instructions retired in user space, hardware counter
+     */
+    std::uint64_t instructions = 0;
+    /**
+     * Last level cache misses in user space, hardware counter
+     */
+    std::uint64_t cacheMisses = 0;
+    /**
+     * CPU time of the thread in nanoseconds, software counter
+     */
+    std::uint64_t taskClock = 0;
+    /**
+     * Voluntary and involuntary context switches of the thread, software counter
+     */
+    std::uint64_t contextSwitches = 0;
+    /**
+     * Minor and major page faults of the thread, software counter
+     */
+    std::uint64_t pageFaults = 0;
+    /**
+     * Whether the hardware counters have been measured for all summed up tasks
+     */
+    bool hardware = false;
+
+    /**
+     * Adds the values of other measured tasks
+     *
+     * @param other The values to add
+     * @return This PerfCounterValues
+     */
+    inline PerfCounterValues &operator+=(const PerfCounterValues &other) {
+        this->hardware = (this->hardware || !this->tasks) && other.hardware;
+        this->tasks += other.tasks;
+        this->cycles += other.cycles;
+        this->instructions += other.instructions;
+        this->cacheMisses += other.cacheMisses;
+        this->taskClock += other.taskClock;
+        this->contextSwitches += other.contextSwitches;
+        this->pageFaults += other.pageFaults;
+        return *this;
+    }
+
+    /**
+     * Returns the instructions per cycle, a low value hints at tasks waiting for memory
+     *
+     * @return The instructions per cycle, 0 without hardware counters
+     */
+    [[nodiscard]] inline double instructionsPerCycle() const {
+        return this->cycles ? static_cast<double>(this->instructions) / static_cast<double>(this->cycles) : 0;
+    }
+
+    /**
+     * Returns the cache misses per thousand instructions
+     *
+     * @return The cache misses per thousand instructions, 0 without hardware counters
+     */
+    [[nodiscard]] inline double cacheMissesPerKiloInstruction() const {
+        return this->instructions
+               ? 1000.0 * static_cast<double>(this->cacheMisses) / static_cast<double>(this->instructions) : 0;
+    }
+};
+
+/**
+ * The summed up counter values of a Controller, see Controller::perfCounters()
+ */
+struct PerfCounterReport {
+    /**
+     * The values per Worker, indexed by the index of the Worker
+     */
+    std::vector<PerfCounterValues> perWorker;
+    /**
+     * The values per task class, see ControllerConfiguration::taskClass
+     */
+    std::map<std::size_t, PerfCounterValues> perTaskClass;
+};
+
+/**
+ * Measures PerfCounterValues of the calling thread around single tasks. \n
+ * Opens a group of hardware counters with Linux perf_event_open(), which is read with a single system call.
+ * If the hardware counters are not available, e.g. in virtual machines without a virtual PMU or with a restrictive
+ * /proc/sys/kernel/perf_event_paranoid, only the software counters are measured. \n
+ * The software counters are taken from ThreadUsage.
+ *
+ * Notice: Has to be created, used and destroyed in the thread to measure. Measures nothing on other systems than Linux.
+ */
+class PerfCounterGroup {
+public:
+    /**
+     * Opens the counters for the calling thread
+     */
+    PerfCounterGroup() {
+#if defined(__linux__)
+        this->leader = PerfCounterGroup::openEvent(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (this->leader < 0) {
+            return;
+        }
+        this->instructionsFd = PerfCounterGroup::openEvent(PERF_COUNT_HW_INSTRUCTIONS, this->leader);
+        this->cacheMissesFd = PerfCounterGroup::openEvent(PERF_COUNT_HW_CACHE_MISSES, this->leader);
+        if (this->instructionsFd < 0 || this->cacheMissesFd < 0 ||
+            ioctl(this->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) < 0) {
+            this->close();
+        }
+#endif
+    }
+
+    /**
+     * Closes the counters
+     */
+    ~PerfCounterGroup() {
+        this->close();
+    }
+
+    PerfCounterGroup(const PerfCounterGroup &) = delete;
+
+    PerfCounterGroup &operator=(const PerfCounterGroup &) = delete;
+
+    /**
+     * Returns, whether the hardware counters are available
+     *
+     * @return \p true if the hardware counters are measured, \p false if only the software counters are measured
+     */
+    [[nodiscard]] inline bool hardware() const {
+        return this->leader >= 0;
+    }
+
+    /**
+     * Starts measuring a task
+     */
+    inline void start() {
+        this->startValues = this->read();
+    }
+
+    /**
+     * Stops measuring a task
+     *
+     * @return The values measured since start()
+     */
+    inline PerfCounterValues stop() {
+        const Values end = this->read();
+        PerfCounterValues values;
+        values.tasks = 1;
+        values.hardware = this->hardware();
+        const ThreadUsage usage = end.usage - this->startValues.usage;
+        values.taskClock = static_cast<std::uint64_t>(usage.cpuTime.count());
+        values.contextSwitches = usage.voluntaryContextSwitches + usage.involuntaryContextSwitches;
+        values.pageFaults = usage.pageFaults;
+
+        if (values.hardware) {
+            // the kernel multiplexes the counters if there are not enough of them, which requires scaling
+            const std::uint64_t enabled = end.timeEnabled - this->startValues.timeEnabled;
+            const std::uint64_t running = end.timeRunning - this->startValues.timeRunning;
+            const double scale = running && running < enabled
+                                 ? static_cast<double>(enabled) / static_cast<double>(running) : 1.0;
+            values.cycles = static_cast<std::uint64_t>(
+                    static_cast<double>(end.counters[0] - this->startValues.counters[0]) * scale
+            );
+            values.instructions = static_cast<std::uint64_t>(
+                    static_cast<double>(end.counters[1] - this->startValues.counters[1]) * scale
+            );
+            values.cacheMisses = static_cast<std::uint64_t>(
+                    static_cast<double>(end.counters[2] - this->startValues.counters[2]) * scale
+            );
+        }
+        return values;
+    }
+
+private:
+    /**
+     * The raw values read at a point in time
+     */
+    struct Values {
+        std::uint64_t timeEnabled = 0;
+        std::uint64_t timeRunning = 0;
+        std::uint64_t counters[3] = {0, 0, 0};
+        ThreadUsage usage;
+    };
+
+    /**
+     * The file descriptor of the cycles counter, which leads the group, -1 without hardware counters
+     */
+    int leader = -1;
+    /**
+     * The file descriptor of the instructions counter
+     */
+    int instructionsFd = -1;
+    /**
+     * The file descriptor of the cache misses counter
+     */
+    int cacheMissesFd = -1;
+    /**
+     * The values read by start()
+     */
+    Values startValues;
+
+#if defined(__linux__)
+
+    /**
+     * Opens a hardware counter of the calling thread, counting in user space only
+     *
+     * @param config The PERF_COUNT_HW_* counter to open
+     * @param groupFd The leader of the group, -1 to open a new group
+     * @return The file descriptor, negative on failure
+     */
+    static inline int openEvent(const std::uint64_t config, const int groupFd) {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.config = config;
+        attributes.disabled = groupFd < 0;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+    }
+
+#endif
+
+    /**
+     * Reads all counters
+     *
+     * @return The read values
+     */
+    inline Values read() {
+        Values values;
+#if defined(__linux__)
+        if (this->leader >= 0) {
+            // number of counters, time enabled, time running, counters
+            std::uint64_t buffer[6] = {0, 0, 0, 0, 0, 0};
+            if (::read(this->leader, buffer, sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer)) &&
+                buffer[0] == 3) {
+                values.timeEnabled = buffer[1];
+                values.timeRunning = buffer[2];
+                values.counters[0] = buffer[3];
+                values.counters[1] = buffer[4];
+                values.counters[2] = buffer[5];
+            }
+        }
+#endif
+        values.usage = ThreadUsage::current();
+        return values;
+    }
+
+    /**
+     * Closes all counters
+     */
+    inline void close() {
+#if defined(__linux__)
+        for (int *fd : {&this->cacheMissesFd, &this->instructionsFd, &this->leader}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+#endif
+    }
+};
+
+#endif
@@ -2,9 +2,19 @@
 #define QT_MULTITHREADING_PROCESSOR_H
 
 #include <QObject>
+#include <QCoreApplication>
+#include <algorithm>
+#include <chrono>
 #include <deque>
+#include <memory>
+#include <vector>
 #include <cstddef>
 #include "Magic.h"
+#include "Admission.h"
+#include "Configuration.h"
+#include "Metrics.h"
+#include "ResultChannel.h"
+#include "ResultReducer.h"
 
 /*
  * Forward declaration of the template class used to coordinate everything.
@@ -50,7 +60,9 @@ protected:
      */
     Processor()
             : SlotProvider(nullptr), workerControllerContext(nullptr), workerController(nullptr),
-              setNumberOfThreadsPtr(nullptr), clearQueuePtr(nullptr), extendQueuePtr(nullptr) {}
+              setNumberOfThreadsPtr(nullptr), clearQueuePtr(nullptr), extendQueuePtr(nullptr),
+              collectReductionPtr(nullptr),
+              configuration(nullptr), metrics(nullptr), shard(0) {}
 
     /**
     * See Processor::setNumberOfThreadsPtr
@@ -76,16 +88,66 @@ protected:
 
     /**
      * See Processor::extendQueuePtr
+     *
+     * Blocks as long as the new tasks would exceed the memory budget, see ControllerConfiguration::memoryBudget,
+     * unless called from a slot of this Processor executed while already waiting for the budget. \n
+     * Tasks still not fitting after ControllerConfiguration::memoryBudgetTimeout are rejected.
+     *
+     * @param newTasks The tasks to give to the WorkerController
+     * @return Which tasks have been admitted, only tasks exceeding ControllerConfiguration::queueWaitTarget are
+     *         deprioritized or rejected, which have to be handled by the caller
      */
-    inline void extendQueue(const std::deque<T> &newTasks) {
+    inline AdmissionResult extendQueue(const std::deque<T> &newTasks) {
+        this->awaitMemoryBudget(newTasks);
+        AdmissionResult admission;
         invokeInContext(
                 this->workerControllerContext, Qt::BlockingQueuedConnection,
                 this->extendQueuePtr,
-                this->workerController, newTasks
+                this->workerController, newTasks, admission
+        );
+        return admission;
+    }
+
+    /**
+     * See Processor::collectReductionPtr
+     *
+     * Requests merging the states of all Worker, see ControllerConfiguration::resultReducer, and returns at once. \n
+     * The state of every Worker is taken between two of its tasks, the Worker continue with an empty state afterwards,
+     * so that every result is part of exactly one collected reduction. Neither this Processor nor the WorkerController
+     * wait for the Worker meanwhile, the merged state is given to receiveReduction() once all Worker handed it over.
+     */
+    inline void collectReduction() {
+        invokeInContext(
+                this->workerControllerContext, Qt::QueuedConnection,
+                this->collectReductionPtr,
+                this->workerController, this
         );
     }
 
+    /**
+     * Returns the index of this Processor among the shards, see ControllerConfiguration::processorShards
+     *
+     * @return The index of this shard, 0 for the Processor given to the Controller
+     */
+    [[nodiscard]] inline std::size_t shardIndex() const {
+        return this->shard;
+    }
+
 private:
+    /**
+     * This method is used to clone an existing Processor, only needed with ControllerConfiguration::processorShards.
+     * \n
+     * Like Worker::clone(), this includes ONLY things defined by the user of the framework.
+     *
+     * You may want to notice, that this is a private virtual function.
+     * See https://isocpp.org/wiki/faq/strange-inheritance#private-virtuals
+     *
+     * @return The cloned Processor, nullptr by default, which means this Processor cannot be sharded
+     */
+    virtual std::unique_ptr<Processor<T, R>> clone() {
+        return nullptr;
+    }
+
     /**
      * Method to be implemented when inheriting from this abstract template class. \n
      * This function is going to called when a Worker has finished fulfilling a task and receives that result
@@ -94,10 +156,127 @@ private:
      * You may want to notice, that this is a private virtual function.
      * See https://isocpp.org/wiki/faq/strange-inheritance#private-virtuals
      *
+     * Notice: With ControllerConfiguration::concurrentResults, this function is called concurrently in the threads of
+     * the Worker, see there for the contract it has to follow.
+     *
      * @param result The result which has been calculated during fulfilling of a task
      */
     virtual void receiveResult(R &result) = 0;
 
+    /**
+     * Method to be implemented when using ControllerConfiguration::resultReducer. \n
+     * This function is going to be called with the merged state of all Worker requested with collectReduction(),
+     * cast it to the type of the ResultReducer given with the configuration, e.g. with std::static_pointer_cast.
+     *
+     * You may want to notice, that this is a private virtual function.
+     * See https://isocpp.org/wiki/faq/strange-inheritance#private-virtuals
+     *
+     * @param reducer The merged state, nullptr without ControllerConfiguration::resultReducer
+     */
+    virtual void receiveReduction(const std::shared_ptr<ResultReducer<R>> &reducer) {
+        Q_UNUSED(reducer)
+    }
+
+    /**
+     * Is going to be invoked by the WorkerController with the merged state requested with collectReduction()
+     *
+     * @param reducer The merged state, nullptr without ControllerConfiguration::resultReducer
+     */
+    inline void reductionCollected(const std::shared_ptr<ResultReducer<R>> &reducer) {
+        this->receiveReduction(reducer);
+    }
+
+    /**
+     * Is going to be connected to the Worker so that this Processor will receive the results via this method. \n
+     * Releases the memory accounted for the result before handing it to receiveResult().
+     *
+     * @param result The result which has been calculated during fulfilling of a task
+     * @param resultBytes The number of bytes accounted for \p result
+     */
+    inline void resultReceived(R &result, const std::size_t &resultBytes) {
+        this->metrics->pendingResults.fetch_sub(1, std::memory_order_relaxed);
+        this->metrics->pendingResultBytes.fetch_sub(resultBytes, std::memory_order_relaxed);
+        this->metrics->releasedBytes();
+        this->receiveResult(result);
+    }
+
+    /**
+     * Is going to be connected to the Worker so that this Processor will receive the batches of results sent by a
+     * ResultEmitter via this method, see StreamingWorker. \n
+     * Hands the results to receiveResult() one by one.
+     *
+     * @param results The results sent while a task has been fulfilled
+     * @param resultBytes The number of bytes accounted for \p results
+     */
+    inline void resultsReceived(std::vector<R> &results, const std::size_t &resultBytes) {
+        this->metrics->pendingResults.fetch_sub(results.size(), std::memory_order_relaxed);
+        this->metrics->pendingResultBytes.fetch_sub(resultBytes, std::memory_order_relaxed);
+        this->metrics->releasedBytes();
+        for (R &result : results) {
+            this->receiveResult(result);
+        }
+    }
+
+    /**
+     * Is going to be connected to the Worker so that this Processor drains the ResultChannel of all Worker,
+     * see ControllerConfiguration::resultChannels. \n
+     * Hands the results to receiveResult() one by one. \n
+     * Takes at most ControllerConfiguration::resultBatchSize results per channel, then posts itself again,
+     * so that other events of this Processor are not starved by Worker producing faster than it consumes.
+     *
+     * @param inbox The channels of all Worker sending to this Processor
+     */
+    inline void resultsAvailable(ResultInbox<R> *const &inbox) {
+        const bool remaining = inbox->drain(
+                [this](R &result, const std::size_t resultBytes) -> void {
+                    this->resultReceived(result, resultBytes);
+                },
+                this->configuration->resultBatchSize
+        );
+        if (remaining && inbox->notify()) {
+            invokeInContext(
+                    static_cast<QObject *>(this), Qt::QueuedConnection, &Processor<T, R>::resultsAvailable,
+                    this, inbox
+            );
+        }
+    }
+
+    /**
+     * Blocks until \p newTasks fit into the memory budget, if there is one, at most for
+     * ControllerConfiguration::memoryBudgetTimeout. \n
+     * The events of this Processor are processed meanwhile, since the results waiting for it count against the
+     * budget, too, and are only released once received. Otherwise this thread sleeps until memory is released,
+     * see Metrics::awaitMemoryBudget().
+     *
+     * Notice: Slots of this Processor may thus be executed while waiting,
+     * including receiveResult() calling extendQueue() again. Such a nested call does not wait, so that the
+     * nesting ends after one level, the WorkerController rejects its tasks not fitting into the budget instead.
+     *
+     * @param newTasks The tasks going to be given to the WorkerController
+     */
+    inline void awaitMemoryBudget(const std::deque<T> &newTasks) {
+        if (!this->configuration || !this->configuration->memoryBudget || this->awaitingMemoryBudget) {
+            return;
+        }
+
+        std::size_t newTaskBytes = 0;
+        for (const T &newTask : newTasks) {
+            newTaskBytes += this->configuration->sizeOfTask(newTask);
+        }
+
+        const std::chrono::steady_clock::time_point deadline =
+                std::chrono::steady_clock::now() + this->configuration->memoryBudgetTimeout;
+        this->awaitingMemoryBudget = true;
+        // results posted to this thread are not released while sleeping, thus the events are processed at least
+        // every millisecond, memory released by the WorkerController wakes it up at once
+        while (!this->metrics->awaitMemoryBudget(
+                newTaskBytes, std::min(deadline, std::chrono::steady_clock::now() + std::chrono::milliseconds(1))) &&
+               std::chrono::steady_clock::now() < deadline) {
+            QCoreApplication::processEvents();
+        }
+        this->awaitingMemoryBudget = false;
+    }
+
     /**
      * This function is going to be called to setup all the needed connections between this Processor and the
      * WorkerController.
@@ -110,13 +289,21 @@ private:
      * @param newSetNumberOfThreadsPtr See Processor::setNumberOfThreadsPtr
      * @param newClearQueuePtr See Processor::clearQueuePtr
      * @param newExtendQueuePtr See Processor::extendQueuePtr
+     * @param newCollectReductionPtr See Processor::collectReductionPtr
+     * @param newConfiguration See Processor::configuration
+     * @param newMetrics See Processor::metrics
      */
     inline void
     setupConnections(QObject *const newWorkerControllerContext = nullptr,
                      WorkerController<T, R> *const newWorkerController = nullptr,
                      void (WorkerController<T, R>::* const newSetNumberOfThreadsPtr)(const std::size_t &) = nullptr,
                      void (WorkerController<T, R>::* const newClearQueuePtr)() = nullptr,
-                     void (WorkerController<T, R>::* const newExtendQueuePtr)(const std::deque<T> &) = nullptr) {
+                     void (WorkerController<T, R>::* const newExtendQueuePtr)(const std::deque<T> &,
+                                                                              AdmissionResult &) = nullptr,
+                     void (WorkerController<T, R>::* const newCollectReductionPtr)(
+                             Processor<T, R> *const &) = nullptr,
+                     const ControllerConfiguration<T, R> *const newConfiguration = nullptr,
+                     Metrics *const newMetrics = nullptr) {
         this->workerControllerContext = newWorkerControllerContext;
         // only set new ptr to worker controller if not nullptr
         this->workerController = newWorkerController ? newWorkerController : this->workerController;
@@ -125,6 +312,11 @@ private:
         this->setNumberOfThreadsPtr = newSetNumberOfThreadsPtr ? newSetNumberOfThreadsPtr : this->setNumberOfThreadsPtr;
         this->clearQueuePtr = newClearQueuePtr ? newClearQueuePtr : this->clearQueuePtr;
         this->extendQueuePtr = newExtendQueuePtr ? newExtendQueuePtr : this->extendQueuePtr;
+        this->collectReductionPtr = newCollectReductionPtr ? newCollectReductionPtr : this->collectReductionPtr;
+
+        // only set new ptr to the configuration and the metrics if not nullptr
+        this->configuration = newConfiguration ? newConfiguration : this->configuration;
+        this->metrics = newMetrics ? newMetrics : this->metrics;
     }
 
     /**
@@ -160,7 +352,35 @@ private:
      * Notice: This function is going to be invoked with a Qt::BlockingQueuedConnection, so that the function call is only
      * going to return after the WorkerController has processed the function call.
      */
-    void (WorkerController<T, R>::* extendQueuePtr)(const std::deque<T> &);
+    void (WorkerController<T, R>::* extendQueuePtr)(const std::deque<T> &, AdmissionResult &);
+
+    /**
+     * Can be called to merge the states of the ResultReducer of all Worker
+     *
+     * Notice: This function is going to be invoked with a Qt::QueuedConnection, the merged state is given back
+     * to receiveReduction() of the Processor given as argument.
+     */
+    void (WorkerController<T, R>::* collectReductionPtr)(Processor<T, R> *const &);
+
+    /**
+     * Pointer to the configuration of the relevant WorkerController
+     */
+    const ControllerConfiguration<T, R> *configuration;
+
+    /**
+     * Pointer to the metrics of the relevant WorkerController
+     */
+    Metrics *metrics;
+
+    /**
+     * See shardIndex()
+     */
+    std::size_t shard;
+
+    /**
+     * Whether awaitMemoryBudget() is waiting, so that slots executed meanwhile do not wait again
+     */
+    bool awaitingMemoryBudget = false;
 
     /**
      * In order to be able to set up the connections etc. which is only allowed via a private method, making the
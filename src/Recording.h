@@ -0,0 +1,455 @@
+#ifndef QT_MULTITHREADING_RECORDING_H
+#define QT_MULTITHREADING_RECORDING_H
+
+#include <QFile>
+#include <QString>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+#include "Serialization.h"
+
+/**
+ * The magic bytes and the version at the beginning of every recording
+ */
+inline constexpr char recordingMagic[8] = {'Q', 'T', 'M', 'T', 'R', 'E', 'C', 1};
+
+/**
+ * The types of records in a recording
+ */
+enum class RecordType : std::uint8_t {
+    /**
+     * A task has been given to the WorkerController, see RecordedSubmission
+     */
+    Submission = 1,
+    /**
+     * A Worker finished fulfilling a task, see RecordedCompletion
+     */
+    Completion = 2
+};
+
+/**
+ * Appends an unsigned integer using a variable number of bytes, 7 bits per byte, so that small numbers,
+ * like the time between two records, only take a single byte
+ *
+ * @param writer The BinaryWriter to append to
+ * @param value The value to append
+ */
+inline void writeVarint(BinaryWriter &writer, std::uint64_t value) {
+    while (value >= 0x80) {
+        writer.write(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    writer.write(static_cast<std::uint8_t>(value));
+}
+
+/**
+ * Reads an unsigned integer written with writeVarint()
+ *
+ * @param reader The BinaryReader to read from
+ * @return The read value, 0 if the data is invalid, which also marks \p reader as failed
+ */
+inline std::uint64_t readVarint(BinaryReader &reader) {
+    std::uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64 && reader.ok(); shift += 7) {
+        const auto byte = reader.read<std::uint8_t>();
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return reader.ok() ? value : 0;
+        }
+    }
+    reader.fail();
+    return 0;
+}
+
+/**
+ * A task given to the WorkerController while recording
+ *
+ * @tparam T The data type of the task
+ */
+template<typename T>
+struct RecordedSubmission {
+    /**
+     * The id of the task, counting all tasks ever given to the WorkerController
+     */
+    std::uint64_t id = 0;
+    /**
+     * The time the task has been given, since the recording started
+     */
+    std::chrono::nanoseconds offset{0};
+    /**
+     * The task itself, default constructed if the task could not be serialized while recording
+     */
+    T task{};
+};
+
+/**
+ * A task fulfilled while recording
+ */
+struct RecordedCompletion {
+    /**
+     * See RecordedSubmission::id
+     */
+    std::uint64_t id = 0;
+    /**
+     * The time the task has been sent to a Worker, since the recording started
+     */
+    std::chrono::nanoseconds dispatched{0};
+    /**
+     * The time the WorkerController has been notified about the Worker being done, since the recording started
+     */
+    std::chrono::nanoseconds finished{0};
+    /**
+     * The wall time spent in Worker::fulfillTask(), see TaskMeasurement::fulfillDuration
+     */
+    std::chrono::nanoseconds fulfillDuration{0};
+    /**
+     * The index of the Worker which fulfilled the task, remote Worker are counted behind the local ones,
+     * see RemoteTask::connection
+     */
+    std::uint64_t worker = 0;
+};
+
+/**
+ * Writes the stream of tasks of a WorkerController to a compact binary file, see Controller::startRecording(). \n
+ * Only used from the thread of the WorkerController, records are buffered and written in large chunks.
+ *
+ * The file starts with recordingMagic followed by the records, each consisting of the RecordType, the id of the task
+ * and the time since the previous record as varints. \n
+ * A submission continues with the length of the serialized task and the serialized task, see Serializer. \n
+ * A completion continues with the time between dispatching and finishing, the duration of fulfilling the task and
+ * the index of the Worker.
+ *
+ * Notice: Tasks not satisfying Serializable are recorded with their timestamps only.
+ *
+ * @tparam T The data type of the task
+ */
+template<typename T>
+class TaskRecorder {
+public:
+    /**
+     * Stops recording, see TaskRecorder::stop()
+     */
+    ~TaskRecorder() {
+        this->stop();
+    }
+
+    /**
+     * Starts a new recording, any previous recording is stopped
+     *
+     * @param fileName The file to write to, which is overwritten
+     * @param firstId The id of the next submitted task, completions of tasks with smaller ids are not recorded
+     * @return \p true if the file could be opened, \p false otherwise
+     */
+    inline bool start(const QString &fileName, const std::uint64_t firstId) {
+        this->stop();
+
+        this->file = std::make_unique<QFile>(fileName);
+        if (!this->file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            this->file.reset();
+            return false;
+        }
+
+        this->firstId = firstId;
+        this->origin = std::chrono::steady_clock::now();
+        this->lastOffset = std::chrono::nanoseconds(0);
+        this->buffer.assign(std::begin(recordingMagic), std::end(recordingMagic));
+        return true;
+    }
+
+    /**
+     * Writes all buffered records and closes the file
+     */
+    inline void stop() {
+        if (this->file) {
+            this->flush();
+            this->file->close();
+            this->file.reset();
+        }
+        this->buffer.clear();
+        this->buffer.shrink_to_fit();
+    }
+
+    /**
+     * Returns, whether a recording is running
+     *
+     * @return \p true if a recording is running, \p false otherwise
+     */
+    [[nodiscard]] inline bool isRecording() const {
+        return static_cast<bool>(this->file);
+    }
+
+    /**
+     * Records a task given to the WorkerController
+     *
+     * @param id See RecordedSubmission::id
+     * @param task The task
+     */
+    inline void recordSubmission(const std::uint64_t id, const T &task) {
+        if (!this->file) {
+            return;
+        }
+
+        BinaryWriter writer(this->buffer);
+        this->writeRecordHeader(writer, RecordType::Submission, id, std::chrono::steady_clock::now());
+
+        this->taskBuffer.clear();
+        if constexpr (Serializable<T>) {
+            BinaryWriter taskWriter(this->taskBuffer);
+            taskWriter.write(task);
+        }
+        writeVarint(writer, this->taskBuffer.size());
+        writer.writeBytes(this->taskBuffer.data(), this->taskBuffer.size());
+
+        this->flushIfFull();
+    }
+
+    /**
+     * Records a task a Worker is done with
+     *
+     * @param id See RecordedCompletion::id
+     * @param dispatched The time the task has been sent to the Worker
+     * @param fulfillDuration See RecordedCompletion::fulfillDuration
+     * @param worker See RecordedCompletion::worker
+     */
+    inline void recordCompletion(const std::uint64_t id, const std::chrono::steady_clock::time_point &dispatched,
+                                 const std::chrono::nanoseconds &fulfillDuration, const std::size_t worker) {
+        if (!this->file || id < this->firstId) {
+            return;
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        BinaryWriter writer(this->buffer);
+        this->writeRecordHeader(writer, RecordType::Completion, id, now);
+        writeVarint(writer, TaskRecorder<T>::nonNegative(now - dispatched));
+        writeVarint(writer, TaskRecorder<T>::nonNegative(fulfillDuration));
+        writeVarint(writer, worker);
+
+        this->flushIfFull();
+    }
+
+private:
+    /**
+     * The number of buffered bytes at which the buffer is written to the file
+     */
+    static constexpr std::size_t flushThreshold = 64 * 1024;
+    /**
+     * The file written to, nullptr if not recording
+     */
+    std::unique_ptr<QFile> file;
+    /**
+     * The records not yet written to the file
+     */
+    std::vector<char> buffer;
+    /**
+     * Reused for serializing a single task, whose length has to be known before writing it
+     */
+    std::vector<char> taskBuffer;
+    /**
+     * The time the recording started
+     */
+    std::chrono::steady_clock::time_point origin;
+    /**
+     * The time of the previous record since TaskRecorder::origin
+     */
+    std::chrono::nanoseconds lastOffset{0};
+    /**
+     * See TaskRecorder::start()
+     */
+    std::uint64_t firstId = 0;
+
+    /**
+     * Converts a duration to a number of nanoseconds, negative durations are recorded as 0
+     *
+     * @param duration The duration
+     * @return The number of nanoseconds
+     */
+    static inline std::uint64_t nonNegative(const std::chrono::nanoseconds &duration) {
+        return duration.count() > 0 ? static_cast<std::uint64_t>(duration.count()) : 0;
+    }
+
+    /**
+     * Writes the type, the id and the time since the previous record
+     *
+     * @param writer The BinaryWriter to write to
+     * @param type The RecordType
+     * @param id The id of the task
+     * @param now The time of the record
+     */
+    inline void writeRecordHeader(BinaryWriter &writer, const RecordType type, const std::uint64_t id,
+                                  const std::chrono::steady_clock::time_point &now) {
+        const auto offset = std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(now - this->origin),
+                                     this->lastOffset);
+        writer.write(static_cast<std::uint8_t>(type));
+        writeVarint(writer, id);
+        writeVarint(writer, TaskRecorder<T>::nonNegative(offset - this->lastOffset));
+        this->lastOffset = offset;
+    }
+
+    /**
+     * Writes the buffer to the file, if it exceeds TaskRecorder::flushThreshold
+     */
+    inline void flushIfFull() {
+        if (this->buffer.size() >= TaskRecorder<T>::flushThreshold) {
+            this->flush();
+        }
+    }
+
+    /**
+     * Writes the buffer to the file, a failed write stops the recording
+     */
+    inline void flush() {
+        if (!this->buffer.empty()) {
+            const auto bytes = static_cast<qint64>(this->buffer.size());
+            if (this->file->write(this->buffer.data(), bytes) != bytes) {
+                qWarning("TaskRecorder: could not write recording, stopped recording");
+                this->file.reset();
+            }
+            this->buffer.clear();
+        }
+    }
+};
+
+/**
+ * Reads a recording written by TaskRecorder and re-drives the recorded tasks, e.g. into a Controller with changed
+ * settings, so that scheduling changes can be evaluated against real traffic.
+ *
+ * Example: \n
+ * TaskReplayer<int> replayer; \n
+ * if (replayer.open("tasks.rec")) { \n
+ *     replayer.replay([&](const std::deque<int> &tasks) { extendTasksSignal(tasks); }, 10.0); \n
+ * }
+ *
+ * @tparam T The data type of the task, which has to satisfy Serializable
+ */
+template<typename T> requires Serializable<T>
+class TaskReplayer {
+public:
+    /**
+     * Reads a recording
+     *
+     * @param fileName The recording to read
+     * @return \p true if the recording could be read completely, \p false otherwise,
+     *         in which case all records before the invalid one are available
+     */
+    inline bool open(const QString &fileName) {
+        this->recordedSubmissions.clear();
+        this->recordedCompletions.clear();
+
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        const QByteArray content = file.readAll();
+        BinaryReader reader(std::span<const char>(content.constData(), static_cast<std::size_t>(content.size())));
+
+        const std::span<const char> magic = reader.view(sizeof(recordingMagic));
+        if (!reader.ok() || !std::equal(magic.begin(), magic.end(), std::begin(recordingMagic))) {
+            return false;
+        }
+
+        std::chrono::nanoseconds offset(0);
+        while (reader.remaining()) {
+            const auto type = static_cast<RecordType>(reader.read<std::uint8_t>());
+            const std::uint64_t id = readVarint(reader);
+            offset += std::chrono::nanoseconds(readVarint(reader));
+
+            if (type == RecordType::Submission) {
+                RecordedSubmission<T> submission;
+                submission.id = id;
+                submission.offset = offset;
+                BinaryReader taskReader(reader.view(readVarint(reader)));
+                if (taskReader.remaining()) {
+                    taskReader.read(submission.task);
+                }
+                if (!taskReader.ok()) {
+                    reader.fail();
+                }
+                this->recordedSubmissions.push_back(std::move(submission));
+            } else if (type == RecordType::Completion) {
+                RecordedCompletion completion;
+                completion.id = id;
+                completion.finished = offset;
+                completion.dispatched = offset - std::chrono::nanoseconds(readVarint(reader));
+                completion.fulfillDuration = std::chrono::nanoseconds(readVarint(reader));
+                completion.worker = readVarint(reader);
+                this->recordedCompletions.push_back(completion);
+            } else {
+                reader.fail();
+            }
+
+            if (!reader.ok()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Returns the recorded submissions, ordered by time
+     *
+     * @return The recorded submissions
+     */
+    [[nodiscard]] inline const std::vector<RecordedSubmission<T>> &submissions() const {
+        return this->recordedSubmissions;
+    }
+
+    /**
+     * Returns the recorded completions, ordered by time
+     *
+     * @return The recorded completions
+     */
+    [[nodiscard]] inline const std::vector<RecordedCompletion> &completions() const {
+        return this->recordedCompletions;
+    }
+
+    /**
+     * Gives the recorded tasks to \p submit, keeping the recorded gaps between the submissions. \n
+     * Tasks which are due at the same time are given together. Blocks the calling thread until all tasks are given.
+     *
+     * @param submit Called with the tasks to give, e.g. forwarding them to Processor::extendQueue()
+     * @param speed How much faster than recorded the tasks are given, 1 for the original speed,
+     *              0 to give all tasks at once
+     */
+    inline void replay(const std::function<void(const std::deque<T> &)> &submit, const double speed = 1) const {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::deque<T> dueTasks;
+
+        for (const RecordedSubmission<T> &submission : this->recordedSubmissions) {
+            const std::chrono::steady_clock::time_point due = speed > 0
+                    ? start + std::chrono::duration_cast<std::chrono::nanoseconds>(submission.offset / speed)
+                    : start;
+            if (due > std::chrono::steady_clock::now()) {
+                if (!dueTasks.empty()) {
+                    submit(dueTasks);
+                    dueTasks.clear();
+                }
+                std::this_thread::sleep_until(due);
+            }
+            dueTasks.push_back(submission.task);
+        }
+
+        if (!dueTasks.empty()) {
+            submit(dueTasks);
+        }
+    }
+
+private:
+    /**
+     * See TaskReplayer::submissions()
+     */
+    std::vector<RecordedSubmission<T>> recordedSubmissions;
+    /**
+     * See TaskReplayer::completions()
+     */
+    std::vector<RecordedCompletion> recordedCompletions;
+};
+
+#endif
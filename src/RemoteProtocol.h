@@ -0,0 +1,222 @@
+#ifndef QT_MULTITHREADING_REMOTEPROTOCOL_H
+#define QT_MULTITHREADING_REMOTEPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+#include "Serialization.h"
+
+/**
+ * The version of the protocol spoken between TcpRemoteWorkers and RemoteWorkerHost,
+ * connections announcing another version are closed
+ */
+constexpr std::uint32_t remoteProtocolVersion = 1;
+
+/**
+ * The largest frame accepted, larger frames are treated as a broken connection
+ */
+constexpr std::uint32_t remoteMaxFrameSize = 256u << 20u;
+
+/**
+ * The type of a frame exchanged between TcpRemoteWorkers and RemoteWorkerHost. \n
+ * Every frame consists of the length of the rest of the frame (std::uint32_t), the type (std::uint8_t),
+ * the number of entries (std::uint32_t) and the entries, written with the Serializer of their types:
+ *
+ * - Hello, sent by the RemoteWorkerHost once connected, has one entry: the protocol version (std::uint32_t) and
+ *   the number of tasks the host wants to have in flight (std::uint32_t) \n
+ * - Tasks, sent by TcpRemoteWorkers, has one entry per task: its id (std::uint64_t) and the task \n
+ * - Results, sent by the RemoteWorkerHost, has one entry per finished task: its id (std::uint64_t),
+ *   the time spent fulfilling it (std::chrono::nanoseconds) and its results (std::vector<R>) \n
+ * - Heartbeat, sent by the RemoteWorkerHost while connected, has no entries
+ */
+enum class RemoteMessage : std::uint8_t {
+    Hello = 1,
+    Tasks = 2,
+    Results = 3,
+    Heartbeat = 4
+};
+
+/**
+ * Builds a frame of the remote protocol, see RemoteMessage. \n
+ * Entries are appended one after another, so that a whole batch of tasks or results is sent as a single frame.
+ */
+class RemoteFrameBuilder {
+public:
+    /**
+     * Constructor used to initialize the RemoteFrameBuilder
+     *
+     * @param type The type of the frame
+     */
+    explicit RemoteFrameBuilder(const RemoteMessage type) : writer(buffer) {
+        this->start(type);
+    }
+
+    RemoteFrameBuilder(const RemoteFrameBuilder &) = delete;
+
+    RemoteFrameBuilder &operator=(const RemoteFrameBuilder &) = delete;
+
+    /**
+     * Appends an entry to the frame
+     *
+     * @tparam Fields The data types of the fields of the entry
+     * @param fields The fields of the entry, written with their Serializer
+     */
+    template<typename... Fields>
+    inline void add(const Fields &... fields) {
+        (this->writer.write(fields), ...);
+        ++this->entries;
+    }
+
+    /**
+     * Returns the number of entries appended since the frame has been started
+     *
+     * @return The number of entries
+     */
+    [[nodiscard]] inline std::uint32_t count() const {
+        return this->entries;
+    }
+
+    /**
+     * Completes the frame
+     *
+     * @return The bytes of the frame, valid until the next call to reset()
+     */
+    inline const std::vector<char> &finish() {
+        const auto length = static_cast<std::uint32_t>(this->buffer.size() - sizeof(std::uint32_t));
+        std::memcpy(this->buffer.data(), &length, sizeof(length));
+        std::memcpy(this->buffer.data() + sizeof(length) + sizeof(RemoteMessage), &this->entries,
+                    sizeof(this->entries));
+        return this->buffer;
+    }
+
+    /**
+     * Starts a new frame, keeping the allocated buffer
+     *
+     * @param type The type of the new frame
+     */
+    inline void reset(const RemoteMessage type) {
+        this->buffer.clear();
+        this->start(type);
+    }
+
+private:
+    /**
+     * Writes the header of a frame with placeholders for the length and the number of entries
+     *
+     * @param type The type of the frame
+     */
+    inline void start(const RemoteMessage type) {
+        this->entries = 0;
+        this->writer.write(std::uint32_t(0));
+        this->writer.write(type);
+        this->writer.write(std::uint32_t(0));
+    }
+
+    /**
+     * The bytes of the frame
+     */
+    std::vector<char> buffer;
+    /**
+     * Appends to RemoteFrameBuilder::buffer
+     */
+    BinaryWriter writer;
+    /**
+     * The number of entries appended to the frame
+     */
+    std::uint32_t entries = 0;
+};
+
+/**
+ * Cuts the bytes received from a connection into frames of the remote protocol, see RemoteMessage
+ */
+class RemoteFrameReader {
+public:
+    /**
+     * Appends bytes received from the connection
+     *
+     * @param data Pointer to the received bytes
+     * @param size The number of received bytes
+     */
+    inline void append(const char *const data, const std::size_t size) {
+        // drop the frames already read, before the buffer grows
+        if (this->position && this->position == this->buffer.size()) {
+            this->buffer.clear();
+            this->position = 0;
+        } else if (this->position > this->buffer.size() / 2) {
+            this->buffer.erase(this->buffer.begin(), this->buffer.begin() + static_cast<std::ptrdiff_t>(this->position));
+            this->position = 0;
+        }
+        this->buffer.insert(this->buffer.end(), data, data + size);
+    }
+
+    /**
+     * Returns the next complete frame, if any
+     *
+     * @param type Set to the type of the frame
+     * @param entries Set to the number of entries of the frame
+     * @param payload Set to the entries of the frame, valid until the next call to append()
+     * @return \p true if a frame has been returned, \p false if more bytes are needed or the connection is broken
+     */
+    inline bool next(RemoteMessage &type, std::uint32_t &entries, std::span<const char> &payload) {
+        constexpr std::size_t headerSize = sizeof(std::uint32_t) + sizeof(RemoteMessage) + sizeof(std::uint32_t);
+        const std::size_t available = this->buffer.size() - this->position;
+        if (this->broken || available < headerSize) {
+            return false;
+        }
+
+        std::uint32_t length = 0;
+        std::memcpy(&length, this->buffer.data() + this->position, sizeof(length));
+        if (length > remoteMaxFrameSize || length < headerSize - sizeof(length)) {
+            this->broken = true;
+            return false;
+        }
+        if (available < sizeof(length) + length) {
+            return false;
+        }
+
+        const char *const frame = this->buffer.data() + this->position + sizeof(length);
+        std::memcpy(&type, frame, sizeof(type));
+        std::memcpy(&entries, frame + sizeof(type), sizeof(entries));
+        payload = std::span<const char>(frame + sizeof(type) + sizeof(entries),
+                                        length - sizeof(type) - sizeof(entries));
+        this->position += sizeof(length) + length;
+        return true;
+    }
+
+    /**
+     * Returns, whether the connection sent something which is not a frame
+     *
+     * @return \p true if a frame exceeded remoteMaxFrameSize or was too short, \p false otherwise
+     */
+    [[nodiscard]] inline bool isBroken() const {
+        return this->broken;
+    }
+
+    /**
+     * Forgets all received bytes, e.g. when the connection has been closed
+     */
+    inline void clear() {
+        this->buffer.clear();
+        this->buffer.shrink_to_fit();
+        this->position = 0;
+        this->broken = false;
+    }
+
+private:
+    /**
+     * The received bytes not yet dropped
+     */
+    std::vector<char> buffer;
+    /**
+     * The position of the first byte of the next frame in RemoteFrameReader::buffer
+     */
+    std::size_t position = 0;
+    /**
+     * Whether the connection sent something which is not a frame
+     */
+    bool broken = false;
+};
+
+#endif
@@ -0,0 +1,404 @@
+#ifndef QT_MULTITHREADING_REMOTEWORKERHOST_H
+#define QT_MULTITHREADING_REMOTEWORKERHOST_H
+
+#include <QAbstractSocket>
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "Magic.h"
+#include "RemoteProtocol.h"
+#include "Serialization.h"
+#include "Worker.h"
+
+/**
+ * Optional settings of a RemoteWorkerHost
+ */
+struct RemoteWorkerHostConfiguration {
+    /**
+     * The number of threads to use, which is the same as the number of Worker to use
+     */
+    std::size_t numberOfThreads = static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1));
+
+    /**
+     * The number of tasks per Worker the host wants to have in flight. \n
+     * More than one hides the round trip to the WorkerController, since every Worker has the next task at hand when
+     * done with the current one.
+     */
+    std::size_t pipelineDepth = 2;
+
+    /**
+     * The largest number of results sent at once, results are sent as soon as no other task finished meanwhile
+     */
+    std::size_t resultBatchSize = 64;
+
+    /**
+     * The time to wait before connecting again, after the connection has been lost or could not be established
+     */
+    std::chrono::milliseconds reconnectInterval = std::chrono::seconds(1);
+
+    /**
+     * The time between two heartbeats while connected, has to be less than the timeout of TcpRemoteWorkers
+     */
+    std::chrono::milliseconds heartbeatInterval = std::chrono::seconds(1);
+};
+
+/**
+ * Runs Worker for a WorkerController in another process, e.g. on another machine, see TcpRemoteWorkers. \n
+ * The host connects to the WorkerController, announces how many tasks it wants to have in flight and fulfills the
+ * received tasks with clones of the prototype Worker, each in its own thread, just like the WorkerController does.
+ * The results are sent back in batches.
+ *
+ * When the connection is lost, the tasks not started yet are dropped and the results of the running ones are
+ * discarded, since the WorkerController gives them to other Worker. The host then connects again, until it is deleted.
+ *
+ * Example: \n
+ * QCoreApplication app(argc, argv); \n
+ * RemoteWorkerHost<int, int> host(std::make_unique<ConcreteWorker>(), "127.0.0.1:4711"); \n
+ * return app.exec();
+ *
+ * Notice: Requires the Qt Network module, like TcpRemoteWorkers.
+ * The Worker of a host do not know about a ControllerConfiguration, thus Worker::isTaskCancelled() is always \p false.
+ *
+ * @tparam T The data type of the task to fulfill
+ * @tparam R The data type of the result calculated during fulfilling the task
+ */
+template<typename T, typename R>
+class RemoteWorkerHost : public QObject {
+    static_assert(Serializable<T> && Serializable<R>, "tasks and results have to be Serializable to be sent over TCP");
+
+public:
+    /**
+     * Constructor used to initialize the RemoteWorkerHost, which starts connecting at once
+     *
+     * @param prototypeWorker The prototype Worker which will be cloned
+     * @param hostName The host name or address of the WorkerController, see Controller::remoteWorkersAddress()
+     * @param port The port of the WorkerController
+     * @param configuration The optional settings, see RemoteWorkerHostConfiguration
+     * @param parent Another QObject to use as parent for the host, if wanted
+     */
+    RemoteWorkerHost(std::unique_ptr<Worker<T, R>> prototypeWorker, const QString &hostName, const quint16 port,
+                     const RemoteWorkerHostConfiguration &configuration = RemoteWorkerHostConfiguration(),
+                     QObject *const parent = nullptr)
+            : QObject(parent), prototypeWorker(std::move(prototypeWorker)), hostName(hostName), port(port),
+              configuration(configuration), socket(new QTcpSocket(this)), reconnectTimer(new QTimer(this)),
+              heartbeatTimer(new QTimer(this)) {
+        // setup threads/workers
+        for (std::size_t threadIndex = 0; threadIndex < std::max<std::size_t>(configuration.numberOfThreads, 1);
+             ++threadIndex) {
+            std::unique_ptr<Worker<T, R>> newWorker = this->prototypeWorker->clone();
+            this->threads.emplace_back(std::make_unique<QThread>(), newWorker.get());
+            this->workersReady.push_back(threadIndex);
+
+            QThread &newThread = *std::get<0>(this->threads.back());
+            newWorker->moveToThread(&newThread);
+            newThread.start();
+            QObject::connect(&newThread, &QThread::finished, newWorker.release(), &QObject::deleteLater);
+        }
+
+        this->socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        QObject::connect(this->socket, &QTcpSocket::connected, this, [this]() -> void { this->connected(); });
+        QObject::connect(this->socket, &QTcpSocket::readyRead, this, [this]() -> void { this->receive(); });
+        // covers both, a lost connection and a connection which could not be established
+        QObject::connect(
+                this->socket, &QAbstractSocket::stateChanged, this,
+                [this](const QAbstractSocket::SocketState state) -> void {
+                    if (state == QAbstractSocket::UnconnectedState) {
+                        this->disconnected();
+                    }
+                }
+        );
+
+        this->reconnectTimer->setSingleShot(true);
+        this->reconnectTimer->callOnTimeout([this]() -> void { this->connectToController(); });
+        this->heartbeatTimer->callOnTimeout([this]() -> void { this->sendHeartbeat(); });
+
+        this->connectToController();
+    }
+
+    /**
+     * Constructor used to initialize the RemoteWorkerHost with an address as returned by
+     * Controller::remoteWorkersAddress()
+     *
+     * @param prototypeWorker The prototype Worker which will be cloned
+     * @param address The address of the WorkerController, e.g. "127.0.0.1:4711"
+     * @param configuration The optional settings, see RemoteWorkerHostConfiguration
+     * @param parent Another QObject to use as parent for the host, if wanted
+     */
+    RemoteWorkerHost(std::unique_ptr<Worker<T, R>> prototypeWorker, const QString &address,
+                     const RemoteWorkerHostConfiguration &configuration = RemoteWorkerHostConfiguration(),
+                     QObject *const parent = nullptr)
+            : RemoteWorkerHost(std::move(prototypeWorker), address.left(address.lastIndexOf(':')),
+                               address.mid(address.lastIndexOf(':') + 1).toUShort(), configuration, parent) {}
+
+    /**
+     * Closes the connection and stops all threads
+     */
+    ~RemoteWorkerHost() override {
+        QObject::disconnect(this->socket, nullptr, this, nullptr);
+        this->socket->abort();
+
+        for (auto &threadTuple : this->threads) {
+            std::get<0>(threadTuple)->quit();
+        }
+        for (auto &threadTuple : this->threads) {
+            std::get<0>(threadTuple)->wait();
+        }
+    }
+
+    /**
+     * Returns, whether the host is connected to the WorkerController
+     *
+     * @return \p true if connected, \p false while connecting
+     */
+    [[nodiscard]] inline bool isConnected() const {
+        return this->socket->state() == QAbstractSocket::ConnectedState;
+    }
+
+    /**
+     * Returns the number of tasks fulfilled since the start, including the ones whose results have been discarded
+     *
+     * @return The number of fulfilled tasks
+     */
+    [[nodiscard]] inline std::size_t fulfilledTasks() const {
+        return this->numberOfFulfilledTasks;
+    }
+
+private:
+    /**
+     * Connects to the WorkerController
+     */
+    inline void connectToController() {
+        if (this->socket->state() == QAbstractSocket::UnconnectedState) {
+            this->socket->connectToHost(this->hostName, this->port);
+        }
+    }
+
+    /**
+     * Announces the window to the WorkerController, once connected
+     */
+    inline void connected() {
+        this->reader.clear();
+        RemoteFrameBuilder hello(RemoteMessage::Hello);
+        hello.add(remoteProtocolVersion, static_cast<std::uint32_t>(
+                this->threads.size() * std::max<std::size_t>(this->configuration.pipelineDepth, 1)
+        ));
+        const std::vector<char> &frame = hello.finish();
+        this->socket->write(frame.data(), static_cast<qint64>(frame.size()));
+        this->heartbeatTimer->start(static_cast<int>(this->configuration.heartbeatInterval.count()));
+    }
+
+    /**
+     * Drops everything belonging to the lost connection and connects again after a while
+     */
+    inline void disconnected() {
+        // the results of the running tasks belong to the lost connection
+        ++this->session;
+        this->tasks.clear();
+        this->results.reset(RemoteMessage::Results);
+        this->reader.clear();
+        this->heartbeatTimer->stop();
+        this->reconnectTimer->start(static_cast<int>(this->configuration.reconnectInterval.count()));
+    }
+
+    /**
+     * Reads the tasks received from the WorkerController
+     */
+    inline void receive() {
+        const QByteArray bytes = this->socket->readAll();
+        this->reader.append(bytes.constData(), static_cast<std::size_t>(bytes.size()));
+
+        RemoteMessage type = RemoteMessage::Heartbeat;
+        std::uint32_t entries = 0;
+        std::span<const char> payload;
+        while (this->reader.next(type, entries, payload)) {
+            BinaryReader reader(payload);
+            if (type != RemoteMessage::Tasks) {
+                reader.fail();
+            }
+            for (std::uint32_t entry = 0; entry < entries && reader.ok(); ++entry) {
+                const auto id = reader.read<std::uint64_t>();
+                T task{};
+                reader.read(task);
+                if (reader.ok()) {
+                    this->tasks.emplace_back(id, std::move(task));
+                }
+            }
+            if (!reader.ok()) {
+                qWarning("RemoteWorkerHost: closing a connection sending invalid frames");
+                this->socket->abort();
+                return;
+            }
+        }
+        if (this->reader.isBroken()) {
+            qWarning("RemoteWorkerHost: closing a connection sending invalid frames");
+            this->socket->abort();
+            return;
+        }
+
+        this->dispatch();
+    }
+
+    /**
+     * Gives the received tasks to the ready Worker
+     */
+    inline void dispatch() {
+        while (!this->tasks.empty() && !this->workersReady.empty()) {
+            const std::size_t threadIndex = this->workersReady.back();
+            this->workersReady.pop_back();
+            auto &[id, task] = this->tasks.front();
+            invokeInContext(
+                    static_cast<QObject *>(std::get<1>(this->threads[threadIndex])), Qt::QueuedConnection,
+                    &RemoteWorkerHost<T, R>::fulfillTask,
+                    this, threadIndex, this->session, id, task
+            );
+            this->tasks.pop_front();
+        }
+    }
+
+    /**
+     * Fulfills a task, called in the thread of the Worker
+     *
+     * @param threadIndex The index of the Worker in RemoteWorkerHost::threads
+     * @param taskSession The session the task has been received in, see RemoteWorkerHost::session
+     * @param id The id of the task
+     * @param task The task to fulfill
+     */
+    inline void fulfillTask(const std::size_t &threadIndex, const std::uint64_t &taskSession, const std::uint64_t &id,
+                            T &task) {
+        std::vector<R> taskResults;
+        const std::chrono::steady_clock::time_point fulfillStart = std::chrono::steady_clock::now();
+        std::get<1>(this->threads[threadIndex])->fulfillRemoteTask(task, taskResults);
+        const std::chrono::nanoseconds fulfillDuration = std::chrono::steady_clock::now() - fulfillStart;
+        invokeInContext(
+                static_cast<QObject *>(this), Qt::QueuedConnection,
+                &RemoteWorkerHost<T, R>::taskFulfilled,
+                this, threadIndex, taskSession, id, taskResults, fulfillDuration
+        );
+    }
+
+    /**
+     * Received, when a Worker has fulfilled a task
+     *
+     * @param threadIndex The index of the Worker in RemoteWorkerHost::threads
+     * @param taskSession The session the task has been received in, see RemoteWorkerHost::session
+     * @param id The id of the task
+     * @param taskResults The results of the task
+     * @param fulfillDuration The wall time spent fulfilling the task
+     */
+    inline void taskFulfilled(const std::size_t &threadIndex, const std::uint64_t &taskSession,
+                              const std::uint64_t &id, std::vector<R> &taskResults,
+                              const std::chrono::nanoseconds &fulfillDuration) {
+        ++this->numberOfFulfilledTasks;
+        this->workersReady.push_back(threadIndex);
+
+        if (taskSession == this->session) {
+            this->results.add(id, fulfillDuration, taskResults);
+            if (this->results.count() >= this->configuration.resultBatchSize) {
+                this->sendResults();
+            } else if (!this->resultsScheduled) {
+                // the results of the tasks finishing meanwhile are sent together
+                this->resultsScheduled = true;
+                QTimer::singleShot(0, this, [this]() -> void { this->sendResults(); });
+            }
+        }
+
+        this->dispatch();
+    }
+
+    /**
+     * Sends the collected results to the WorkerController
+     */
+    inline void sendResults() {
+        this->resultsScheduled = false;
+        if (!this->results.count()) {
+            return;
+        }
+        const std::vector<char> &frame = this->results.finish();
+        this->socket->write(frame.data(), static_cast<qint64>(frame.size()));
+        this->results.reset(RemoteMessage::Results);
+    }
+
+    /**
+     * Tells the WorkerController, that the host is alive, even if no task finished for a while
+     */
+    inline void sendHeartbeat() {
+        RemoteFrameBuilder heartbeat(RemoteMessage::Heartbeat);
+        const std::vector<char> &frame = heartbeat.finish();
+        this->socket->write(frame.data(), static_cast<qint64>(frame.size()));
+    }
+
+    /**
+     * The prototype Worker which is going to be cloned to create the real Worker
+     */
+    std::unique_ptr<Worker<T, R>> prototypeWorker;
+    /**
+     * The host name or address of the WorkerController
+     */
+    const QString hostName;
+    /**
+     * The port of the WorkerController
+     */
+    const quint16 port;
+    /**
+     * The optional settings given on construction
+     */
+    const RemoteWorkerHostConfiguration configuration;
+    /**
+     * The connection to the WorkerController
+     */
+    QTcpSocket *socket;
+    /**
+     * Connects again after a while, once the connection has been lost
+     */
+    QTimer *reconnectTimer;
+    /**
+     * Sends a heartbeat every RemoteWorkerHostConfiguration::heartbeatInterval while connected
+     */
+    QTimer *heartbeatTimer;
+    /**
+     * std::vector containing the threads and the corresponding pointers to the Worker
+     */
+    std::vector<std::tuple<std::unique_ptr<QThread>, Worker<T, R> *>> threads;
+    /**
+     * The indices (referring to RemoteWorkerHost::threads) of Worker currently not fulfilling a task
+     */
+    std::vector<std::size_t> workersReady;
+    /**
+     * The received tasks not given to a Worker yet, together with their ids
+     */
+    std::deque<std::pair<std::uint64_t, T>> tasks;
+    /**
+     * Cuts the received bytes into frames
+     */
+    RemoteFrameReader reader;
+    /**
+     * The results not sent yet
+     */
+    RemoteFrameBuilder results{RemoteMessage::Results};
+    /**
+     * Whether sendResults() is going to be called by a timer
+     */
+    bool resultsScheduled = false;
+    /**
+     * Counts the lost connections, so that the results of tasks of a lost connection are discarded
+     */
+    std::uint64_t session = 0;
+    /**
+     * See fulfilledTasks()
+     */
+    std::size_t numberOfFulfilledTasks = 0;
+};
+
+#endif
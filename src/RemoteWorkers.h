@@ -0,0 +1,194 @@
+#ifndef QT_MULTITHREADING_REMOTEWORKERS_H
+#define QT_MULTITHREADING_REMOTEWORKERS_H
+
+#include <QObject>
+#include <QString>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Forward declaration of the template class used to coordinate everything. \n
+ * Needed, since we are going to store pointers to objects of this type.
+ *
+ * For a full description of this template class see WorkerController
+ */
+template<typename T, typename R>
+class WorkerController;
+
+/**
+ * A task sent to a remote Worker, kept by the RemoteWorkers until the results arrived,
+ * so that it can be given to another Worker, if the connection is lost
+ *
+ * @tparam T The data type of the task
+ */
+template<typename T>
+struct RemoteTask {
+    /**
+     * The id of the task, see WorkerController::nextTaskId
+     */
+    std::uint64_t id = 0;
+    /**
+     * The task itself
+     */
+    T task;
+    /**
+     * The number of bytes accounted for the task
+     */
+    std::size_t bytes = 0;
+    /**
+     * The time the task has been sent
+     */
+    std::chrono::steady_clock::time_point dispatched;
+    /**
+     * The index of the connection the task has been sent over, set by the RemoteWorkers
+     */
+    std::size_t connection = 0;
+};
+
+/**
+ * Abstract template class for a backend sending tasks to Worker running in other processes,
+ * see ControllerConfiguration::remoteWorkers. \n
+ * The backend lives in the thread of the WorkerController, which sends it every task for which no local Worker is
+ * ready, as long as the backend has capacity(). The backend hands the results back with taskFinished() and the tasks
+ * of a lost connection with tasksLost(), which gives them to the next ready Worker, local or remote.
+ *
+ * Notice: The WorkerController only depends on this class, so that a backend, like TcpRemoteWorkers, may use
+ * other Qt modules without the core of the framework depending on them.
+ *
+ * @tparam T The data type of the task to fulfill
+ * @tparam R The data type of the result calculated during fulfilling the task
+ */
+template<typename T, typename R>
+class RemoteWorkers : public QObject {
+public:
+    /**
+     * Be explicit about the destructor, since the backend is deleted via a pointer to this class
+     */
+    ~RemoteWorkers() override = default;
+
+protected:
+    /**
+     * The only constructor provided by this abstract class, which is going to be called by all constructors
+     * of inherited classes automatically.
+     */
+    RemoteWorkers()
+            : QObject(nullptr), workerController(nullptr), remoteTaskFinished(nullptr), remoteTasksLost(nullptr) {}
+
+    /**
+     * To be called, when a remote Worker fulfilled a task
+     *
+     * @param task The task as given to send()
+     * @param results The results calculated during fulfilling the task, moved from
+     * @param fulfillDuration The wall time the remote Worker spent fulfilling the task
+     */
+    inline void taskFinished(RemoteTask<T> &task, std::vector<R> &results,
+                             const std::chrono::nanoseconds &fulfillDuration) {
+        if (this->workerController) {
+            (this->workerController->*this->remoteTaskFinished)(task, results, fulfillDuration);
+        }
+    }
+
+    /**
+     * To be called, when the tasks sent over a connection are not going to be fulfilled, e.g. since the connection
+     * has been lost, or when new capacity is available with no tasks lost
+     *
+     * @param tasks The tasks to give to other Worker, moved from, may be empty
+     */
+    inline void tasksLost(std::vector<RemoteTask<T>> &tasks) {
+        if (this->workerController) {
+            (this->workerController->*this->remoteTasksLost)(tasks);
+        }
+    }
+
+private:
+    /**
+     * Starts accepting remote Worker, called once in the thread of the WorkerController
+     *
+     * @return \p true if remote Worker are able to connect, \p false otherwise
+     */
+    virtual bool start() = 0;
+
+    /**
+     * Returns the number of tasks which may be sent right now
+     *
+     * @return The free slots in the windows of all connections
+     */
+    [[nodiscard]] virtual std::size_t capacity() const = 0;
+
+    /**
+     * Sends a task to a remote Worker, only called as long as capacity() is not 0. \n
+     * The task may be held back until flush(), so that the tasks given at once are sent together.
+     *
+     * @param task The task to send, moved from
+     */
+    virtual void send(RemoteTask<T> &task) = 0;
+
+    /**
+     * Sends the tasks held back by send()
+     */
+    virtual void flush() = 0;
+
+    /**
+     * Returns the number of connected remote Worker hosts
+     *
+     * @return The number of connections able to receive tasks
+     */
+    [[nodiscard]] virtual std::size_t connections() const = 0;
+
+    /**
+     * Returns where remote Worker have to connect to, e.g. for starting them
+     *
+     * @return The address in a form understood by the remote Worker, empty if not started
+     */
+    [[nodiscard]] virtual QString address() const = 0;
+
+    /**
+     * This function is going to be called to setup all the needed connections between this backend and the
+     * WorkerController.
+     *
+     * May be called without arguments to invalidate the pointer to the WorkerController so that
+     * results are no longer handed back.
+     *
+     * @param newWorkerController See RemoteWorkers::workerController
+     * @param newRemoteTaskFinished See RemoteWorkers::remoteTaskFinished
+     * @param newRemoteTasksLost See RemoteWorkers::remoteTasksLost
+     */
+    inline void
+    setupConnections(WorkerController<T, R> *const newWorkerController = nullptr,
+                     void (WorkerController<T, R>::* const newRemoteTaskFinished)(
+                             RemoteTask<T> &, std::vector<R> &, const std::chrono::nanoseconds &) = nullptr,
+                     void (WorkerController<T, R>::* const newRemoteTasksLost)(
+                             std::vector<RemoteTask<T>> &) = nullptr) {
+        this->workerController = newWorkerController;
+
+        // only set new function pointers if they are not nullptr
+        this->remoteTaskFinished = newRemoteTaskFinished ? newRemoteTaskFinished : this->remoteTaskFinished;
+        this->remoteTasksLost = newRemoteTasksLost ? newRemoteTasksLost : this->remoteTasksLost;
+    }
+
+    /**
+     * Pointer to the relevant WorkerController, living in the same thread as this backend
+     */
+    WorkerController<T, R> *workerController;
+
+    /**
+     * Going to be called with the results of a task fulfilled by a remote Worker
+     */
+    void (WorkerController<T, R>::* remoteTaskFinished)(RemoteTask<T> &, std::vector<R> &,
+                                                        const std::chrono::nanoseconds &);
+
+    /**
+     * Going to be called with the tasks of a lost connection, which are given to other Worker
+     */
+    void (WorkerController<T, R>::* remoteTasksLost)(std::vector<RemoteTask<T>> &);
+
+    /**
+     * In order to be able to set up the connections etc. which is only allowed via a private method, making the
+     * template class WorkerController a friend is necessary.
+     */
+    friend class WorkerController<T, R>;
+};
+
+#endif
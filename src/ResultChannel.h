@@ -0,0 +1,285 @@
+#ifndef QT_MULTITHREADING_RESULTCHANNEL_H
+#define QT_MULTITHREADING_RESULTCHANNEL_H
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+template<typename R>
+class ResultInbox;
+
+/**
+ * Lock-free single-producer single-consumer queue, carrying the results of one Worker to one Processor,
+ * see ControllerConfiguration::resultChannels. \n
+ * Only the thread of the Worker pushes and only the thread of the Processor pops. The results are stored in segments
+ * of ControllerConfiguration::resultChannelSegmentSize slots, a new segment is linked when the last one is full,
+ * so that a Worker never waits for the Processor, e.g. while the Processor waits for the WorkerController stopping
+ * the Worker. The memory of the results is limited by ControllerConfiguration::memoryBudget like without channels.
+ *
+ * @tparam R The data type of the results
+ */
+template<typename R>
+class ResultChannel {
+public:
+    /**
+     * Constructor for the channel
+     *
+     * @param segmentSize The number of slots allocated at once
+     * @param inbox See ResultChannel::inbox()
+     */
+    ResultChannel(const std::size_t segmentSize, ResultInbox<R> &inbox)
+            : segmentSize(std::max<std::size_t>(segmentSize, 1)), resultInbox(inbox),
+              headSegment(new Segment(this->segmentSize)), tailSegment(headSegment) {}
+
+    ResultChannel(const ResultChannel &) = delete;
+
+    ResultChannel &operator=(const ResultChannel &) = delete;
+
+    ~ResultChannel() {
+        while (this->headSegment) {
+            Segment *next = this->headSegment->next.load(std::memory_order_relaxed);
+            delete this->headSegment;
+            this->headSegment = next;
+        }
+    }
+
+    /**
+     * Pushes a result, called in the thread of the Worker
+     *
+     * @param result The result, which is moved from
+     * @param resultBytes The number of bytes accounted for \p result
+     */
+    inline void push(R &result, const std::size_t resultBytes) {
+        Segment *segment = this->tailSegment;
+        std::size_t written = segment->written.load(std::memory_order_relaxed);
+        if (written == this->segmentSize) {
+            // the segment is only left by the Processor once it is full and the next one is linked
+            auto *next = new Segment(this->segmentSize);
+            segment->next.store(next, std::memory_order_release);
+            this->tailSegment = segment = next;
+            written = 0;
+        }
+        segment->buffer[written].result.emplace(std::move(result));
+        segment->buffer[written].resultBytes = resultBytes;
+        segment->written.store(written + 1, std::memory_order_release);
+    }
+
+    /**
+     * Pops a result and hands it to \p receive, called in the thread of the Processor. \n
+     * The slot is released before \p receive is called, so that \p receive may pop from the channel again.
+     *
+     * @param receive Called with the result and the number of bytes accounted for it
+     * @return \p true if a result has been popped, \p false if the channel is empty
+     */
+    template<typename Receive>
+    inline bool pop(Receive &&receive) {
+        if (this->headIndex == this->segmentSize) {
+            Segment *next = this->headSegment->next.load(std::memory_order_acquire);
+            if (!next) {
+                return false;
+            }
+            delete this->headSegment;
+            this->headSegment = next;
+            this->headIndex = 0;
+        }
+        if (this->headIndex == this->headSegment->written.load(std::memory_order_acquire)) {
+            return false;
+        }
+        Slot &slot = this->headSegment->buffer[this->headIndex++];
+        R result = std::move(*slot.result);
+        const std::size_t resultBytes = slot.resultBytes;
+        slot.result.reset();
+        receive(result, resultBytes);
+        return true;
+    }
+
+    /**
+     * Returns, whether the channel is empty, called in the thread of the Processor
+     *
+     * @return \p true if there are no results to pop, \p false otherwise
+     */
+    [[nodiscard]] inline bool empty() const {
+        if (this->headIndex == this->segmentSize) {
+            return !this->headSegment->next.load(std::memory_order_acquire);
+        }
+        return this->headIndex == this->headSegment->written.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns the ResultInbox of the Processor this channel is sending to
+     *
+     * @return The ResultInbox this channel has been opened with
+     */
+    [[nodiscard]] inline ResultInbox<R> &inbox() const {
+        return this->resultInbox;
+    }
+
+private:
+    /**
+     * A result together with the number of bytes accounted for it
+     */
+    struct Slot {
+        std::optional<R> result;
+        std::size_t resultBytes = 0;
+    };
+
+    /**
+     * A part of the queue, the Worker only writes to the last segment and the Processor only reads from the first one
+     */
+    struct Segment {
+        explicit Segment(const std::size_t size) : buffer(size) {}
+
+        /**
+         * The slots of the segment
+         */
+        std::vector<Slot> buffer;
+        /**
+         * The number of slots written by the Worker
+         */
+        alignas(64) std::atomic<std::size_t> written = 0;
+        /**
+         * The next segment, linked by the Worker once this one is full
+         */
+        std::atomic<Segment *> next = nullptr;
+    };
+
+    /**
+     * See ControllerConfiguration::resultChannelSegmentSize
+     */
+    const std::size_t segmentSize;
+    /**
+     * See inbox()
+     */
+    ResultInbox<R> &resultInbox;
+    /**
+     * The segment the Processor reads from
+     */
+    Segment *headSegment;
+    /**
+     * The index of the next slot the Processor reads in ResultChannel::headSegment
+     */
+    std::size_t headIndex = 0;
+    /**
+     * The segment the Worker writes to
+     */
+    alignas(64) Segment *tailSegment;
+    /**
+     * Whether the Worker pushing to the channel has been stopped, so that the channel can be removed once empty
+     */
+    std::atomic<bool> closed = false;
+
+    /**
+     * In order to mark the channel closed, making the template class ResultInbox a friend is necessary.
+     */
+    friend class ResultInbox<R>;
+};
+
+/**
+ * The ResultChannel of all Worker sending to one Processor, see ControllerConfiguration::resultChannels. \n
+ * Instead of posting an event per result or batch to the event queue of the Processor, which is shared by all Worker,
+ * every Worker pushes to its own ResultChannel. Only the first push after the Processor started draining posts
+ * an event, further pushes are coalesced into it, and the Processor drains all channels in round-robin batches.
+ * A single drain takes at most one batch per channel, so that the Processor keeps processing its other events
+ * while the Worker produce faster than it consumes.
+ *
+ * @tparam R The data type of the results
+ */
+template<typename R>
+class ResultInbox {
+public:
+    /**
+     * Opens a channel for a Worker, called in the thread of the WorkerController
+     *
+     * @param segmentSize See ResultChannel::ResultChannel()
+     * @return The new channel
+     */
+    inline std::shared_ptr<ResultChannel<R>> open(const std::size_t segmentSize) {
+        auto channel = std::make_shared<ResultChannel<R>>(segmentSize, *this);
+        QMutexLocker locker(&this->mutex);
+        this->channels.push_back(channel);
+        return channel;
+    }
+
+    /**
+     * Closes the channel of a stopped Worker, which is removed once drained,
+     * called in the thread of the WorkerController
+     *
+     * @param channel The channel to close
+     */
+    static inline void close(ResultChannel<R> &channel) {
+        channel.closed.store(true, std::memory_order_release);
+    }
+
+    /**
+     * Requests the Processor to drain the channels, called in the thread of a Worker after pushing
+     *
+     * @return \p true if the Processor has to be notified, \p false if a notification is pending already
+     */
+    inline bool notify() {
+        // pairs with the fence in drain(), so that either the Processor sees the pushed results or a new notification
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return !this->notified.exchange(true, std::memory_order_seq_cst);
+    }
+
+    /**
+     * Pops up to one batch from every channel, called in the thread of the Processor when notified. \n
+     * If a channel may hold further results, the caller has to notify itself again, see notify(), so that the rest
+     * is drained after the events queued meanwhile.
+     *
+     * @param receive Called with every result and the number of bytes accounted for it
+     * @param batchSize The number of results popped from a channel at most
+     * @return \p true if a channel has been left with results, \p false if all channels have been drained
+     */
+    template<typename Receive>
+    inline bool drain(Receive &&receive, const std::size_t batchSize) {
+        this->notified.store(false, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        std::vector<std::shared_ptr<ResultChannel<R>>> currentChannels;
+        {
+            QMutexLocker locker(&this->mutex);
+            currentChannels = this->channels;
+        }
+
+        bool remaining = false;
+        for (const std::shared_ptr<ResultChannel<R>> &channel : currentChannels) {
+            std::size_t popped = 0;
+            while (popped < batchSize && channel->pop(receive)) {
+                ++popped;
+            }
+            remaining = remaining || popped == batchSize;
+        }
+
+        // a closed channel does not get new results, so it is removed once it is empty
+        QMutexLocker locker(&this->mutex);
+        this->channels.erase(std::remove_if(
+                this->channels.begin(), this->channels.end(),
+                [](const std::shared_ptr<ResultChannel<R>> &channel) -> bool {
+                    return channel->closed.load(std::memory_order_acquire) && channel->empty();
+                }
+        ), this->channels.end());
+        return remaining;
+    }
+
+private:
+    /**
+     * Protects ResultInbox::channels, which is only accessed when opening a channel and when draining
+     */
+    QMutex mutex;
+    /**
+     * The open channels and the closed ones not drained yet
+     */
+    std::vector<std::shared_ptr<ResultChannel<R>>> channels;
+    /**
+     * Whether a notification to drain the channels is pending
+     */
+    std::atomic<bool> notified = false;
+};
+
+#endif
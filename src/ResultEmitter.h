@@ -0,0 +1,154 @@
+#ifndef QT_MULTITHREADING_RESULTEMITTER_H
+#define QT_MULTITHREADING_RESULTEMITTER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/*
+ * Forward declaration of the abstract template class creating the ResultEmitter. \n
+ * Needed, since we are going to make this class a friend.
+ *
+ * For a full description of this abstract template class see Worker
+ */
+template<typename T, typename R>
+class Worker;
+
+/**
+ * Lets a Worker send results to the Processor while still fulfilling a task, see StreamingWorker::streamTask(). \n
+ * The results are collected in batches, a batch is sent once it contains ControllerConfiguration::resultBatchSize
+ * results or ControllerConfiguration::resultBatchInterval passed since the previous batch has been sent. \n
+ * A result pushed after such a pause is thus sent at once, so that the Processor gets the first results early,
+ * while the Worker never holds more than a batch. Results following within the interval wait for the next push,
+ * flush() or the end of the task.
+ *
+ * Notice: With ControllerConfiguration::hedging, all results are held back until the end of the task,
+ * since only the results of the first of a task and its duplicate to finish may be sent.
+ *
+ * @tparam R The data type of the results
+ */
+template<typename R>
+class ResultEmitter {
+public:
+    ResultEmitter(const ResultEmitter &) = delete;
+
+    ResultEmitter &operator=(const ResultEmitter &) = delete;
+
+    /**
+     * Adds a result to the current batch and sends the batch, if it is due
+     *
+     * @param result The result to send to the Processor
+     */
+    inline void push(const R &result) {
+        this->batch.push_back(result);
+        this->pushed();
+    }
+
+    /**
+     * Adds a result to the current batch and sends the batch, if it is due
+     *
+     * @param result The result to send to the Processor
+     */
+    inline void push(R &&result) {
+        this->batch.push_back(std::move(result));
+        this->pushed();
+    }
+
+    /**
+     * Sends the current batch at once, e.g. before a long computation without results
+     */
+    inline void flush() {
+        if (!this->deferred && !this->batch.empty()) {
+            this->send(this->batch);
+            this->batch.clear();
+            this->lastSend = std::chrono::steady_clock::now();
+        }
+    }
+
+    /**
+     * Returns the number of results pushed so far, including the ones already sent
+     *
+     * @return The number of pushed results
+     */
+    [[nodiscard]] inline std::size_t count() const {
+        return this->numberOfResults;
+    }
+
+private:
+    /**
+     * Constructor used by the Worker for every task
+     *
+     * @param send See ResultEmitter::send
+     * @param batchSize See ResultEmitter::batchSize
+     * @param batchInterval See ResultEmitter::batchInterval
+     * @param deferred See ResultEmitter::deferred
+     */
+    ResultEmitter(std::function<void(std::vector<R> &)> send, const std::size_t batchSize,
+                  const std::chrono::nanoseconds batchInterval, const bool deferred)
+            : send(std::move(send)), batchSize(std::max<std::size_t>(batchSize, 1)), batchInterval(batchInterval),
+              deferred(deferred) {}
+
+    /**
+     * Sends the batch, if it is full or the previous batch has been sent at least ResultEmitter::batchInterval ago
+     */
+    inline void pushed() {
+        ++this->numberOfResults;
+        if (this->batch.size() >= this->batchSize ||
+            std::chrono::steady_clock::now() - this->lastSend >= this->batchInterval) {
+            this->flush();
+        }
+    }
+
+    /**
+     * Sends or discards the remaining results at the end of the task
+     *
+     * @param sendResults \p true to send the remaining results, \p false to discard them
+     */
+    inline void finish(const bool sendResults) {
+        this->deferred = !sendResults;
+        this->flush();
+        this->batch.clear();
+    }
+
+    /**
+     * Sends a batch to the Processor
+     */
+    std::function<void(std::vector<R> &)> send;
+    /**
+     * See ControllerConfiguration::resultBatchSize
+     */
+    const std::size_t batchSize;
+    /**
+     * See ControllerConfiguration::resultBatchInterval
+     */
+    const std::chrono::nanoseconds batchInterval;
+    /**
+     * Whether the results are held back until the end of the task
+     */
+    bool deferred;
+    /**
+     * The results not sent yet
+     */
+    std::vector<R> batch;
+    /**
+     * The time the previous batch has been sent, the epoch of the clock before the first one,
+     * so that the first result is sent at once
+     */
+    std::chrono::steady_clock::time_point lastSend;
+    /**
+     * See count()
+     */
+    std::size_t numberOfResults = 0;
+
+    /**
+     * In order to be able to create the ResultEmitter, whose constructor is private, making the
+     * template class Worker a friend is necessary.
+     */
+    template<typename, typename> friend
+    class Worker;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef QT_MULTITHREADING_RESULTREDUCER_H
+#define QT_MULTITHREADING_RESULTREDUCER_H
+
+#include <memory>
+
+/**
+ * Abstract template class to fold results into a per-Worker state instead of sending every result to the Processor,
+ * see ControllerConfiguration::resultReducer. \n
+ * Every Worker gets its own clone of the prototype given with the configuration and folds its results into it
+ * in its own thread, so no synchronization is needed. The Processor requests the merged state of all Worker with
+ * Processor::collectReduction(), e.g. once all tasks have been fulfilled, and receives it with
+ * Processor::receiveReduction().
+ *
+ * Example: \n
+ * struct Sum : ResultReducer<int> { \n
+ *     long long sum = 0; \n
+ *     void fold(int &result) override { sum += result; } \n
+ *     void merge(ResultReducer<int> &other) override { sum += static_cast<Sum &>(other).sum; } \n
+ *     std::unique_ptr<ResultReducer<int>> clone() const override { return std::make_unique<Sum>(); } \n
+ * };
+ *
+ * @tparam R The data type of the results
+ */
+template<typename R>
+class ResultReducer {
+public:
+    virtual ~ResultReducer() = default;
+
+    /**
+     * Folds a result into the state, called in the thread of the Worker which calculated the result
+     *
+     * @param result The result to fold
+     */
+    virtual void fold(R &result) = 0;
+
+    /**
+     * Merges the state of another reducer into this one, called in the thread of the WorkerController
+     *
+     * @param other A reducer created by clone(), thus of the same type as this one
+     */
+    virtual void merge(ResultReducer<R> &other) = 0;
+
+    /**
+     * Creates a reducer with an empty state
+     *
+     * @return The new reducer of the same type as this one
+     */
+    [[nodiscard]] virtual std::unique_ptr<ResultReducer<R>> clone() const = 0;
+};
+
+#endif
@@ -0,0 +1,364 @@
+#ifndef QT_MULTITHREADING_SERIALIZATION_H
+#define QT_MULTITHREADING_SERIALIZATION_H
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class BinaryWriter;
+
+class BinaryReader;
+
+/**
+ * Customization point used to serialize tasks and results, e.g. for spilling them to disk. \n
+ * The primary template is intentionally left undefined, so that unsupported types are detected at compile time.
+ *
+ * A specialization has to provide two static functions: \n
+ * static void write(BinaryWriter &writer, const T &value); \n
+ * static void read(BinaryReader &reader, T &value);
+ *
+ * Built-in specializations exist for: \n
+ * - trivially copyable types, which are copied as they are in memory with a single std::memcpy \n
+ * - contiguous containers (e.g. std::vector, std::string, std::array of non trivially copyable types),
+ *   which are written as length-prefixed span, with a single std::memcpy for trivially copyable elements \n
+ * - tuple-like types (e.g. std::tuple, std::pair), which are written element by element \n
+ * - std::chrono::duration and std::chrono::time_point, which are written as their tick count
+ *
+ * Notice: The native byte order and the native sizes of the types are used, the serialized data is thus meant
+ * to be read on the same architecture. \n
+ * Specializations for own types have to be declared before the types are used with the framework.
+ *
+ * @tparam T The data type to serialize
+ */
+template<typename T>
+struct Serializer;
+
+/**
+ * Concept satisfied by all types for which a Serializer is available and which can be read back
+ * into a default constructed object.
+ *
+ * @tparam T The data type to check
+ */
+template<typename T>
+concept Serializable = std::default_initializable<T> &&
+                       requires(BinaryWriter &writer, BinaryReader &reader, const T &constValue, T &value) {
+                           Serializer<T>::write(writer, constValue);
+                           Serializer<T>::read(reader, value);
+                       };
+
+/**
+ * Appends serialized data to a buffer. \n
+ * The buffer is owned by the caller, so that it can be reused without allocating again.
+ */
+class BinaryWriter {
+public:
+    /**
+     * Constructor used to initialize the BinaryWriter
+     *
+     * @param buffer The buffer to append the serialized data to
+     */
+    explicit BinaryWriter(std::vector<char> &buffer) : buffer(buffer) {}
+
+    /**
+     * Appends raw bytes
+     *
+     * @param data Pointer to the bytes to append
+     * @param size The number of bytes to append
+     */
+    inline void writeBytes(const void *const data, const std::size_t size) {
+        if (!size) {
+            return;
+        }
+        const std::size_t offset = this->buffer.size();
+        this->buffer.resize(offset + size);
+        std::memcpy(this->buffer.data() + offset, data, size);
+    }
+
+    /**
+     * Appends the serialized form of \p value, see Serializer
+     *
+     * @tparam U The data type of \p value
+     * @param value The value to serialize
+     */
+    template<typename U>
+    inline void write(const U &value) {
+        Serializer<U>::write(*this, value);
+    }
+
+    /**
+     * Returns the number of bytes in the buffer
+     *
+     * @return The number of bytes in the buffer
+     */
+    [[nodiscard]] inline std::size_t size() const {
+        return this->buffer.size();
+    }
+
+private:
+    /**
+     * The buffer to append the serialized data to
+     */
+    std::vector<char> &buffer;
+};
+
+/**
+ * Reads serialized data from a buffer without copying the buffer itself. \n
+ * Reading beyond the end of the buffer does not modify the value to read and marks the reader as failed.
+ */
+class BinaryReader {
+public:
+    /**
+     * Constructor used to initialize the BinaryReader
+     *
+     * @param data The serialized data, which has to stay valid as long as the reader is used
+     */
+    explicit BinaryReader(const std::span<const char> data) : data(data) {}
+
+    /**
+     * Copies raw bytes out of the buffer
+     *
+     * @param destination Pointer to the memory to copy the bytes to
+     * @param size The number of bytes to copy
+     * @return \p true if enough bytes were available, \p false otherwise
+     */
+    inline bool readBytes(void *const destination, const std::size_t size) {
+        const std::span<const char> bytes = this->view(size);
+        if (bytes.size() != size) {
+            return false;
+        }
+        if (size) {
+            std::memcpy(destination, bytes.data(), size);
+        }
+        return true;
+    }
+
+    /**
+     * Returns the next bytes of the buffer without copying them and advances behind them
+     *
+     * @param size The number of bytes to return
+     * @return A std::span referring to the bytes in the buffer, empty if not enough bytes were available
+     */
+    inline std::span<const char> view(const std::size_t size) {
+        if (this->failed || size > this->remaining()) {
+            this->failed = true;
+            return {};
+        }
+        const std::span<const char> bytes = this->data.subspan(this->position, size);
+        this->position += size;
+        return bytes;
+    }
+
+    /**
+     * Reads the serialized form of \p value, see Serializer
+     *
+     * @tparam U The data type of \p value
+     * @param value The value to read into
+     */
+    template<typename U>
+    inline void read(U &value) {
+        Serializer<U>::read(*this, value);
+    }
+
+    /**
+     * Reads a default constructed value, see Serializer
+     *
+     * @tparam U The data type of the value to read
+     * @return The read value
+     */
+    template<typename U>
+    inline U read() {
+        U value{};
+        Serializer<U>::read(*this, value);
+        return value;
+    }
+
+    /**
+     * Returns the number of bytes not yet read
+     *
+     * @return The number of bytes not yet read
+     */
+    [[nodiscard]] inline std::size_t remaining() const {
+        return this->data.size() - this->position;
+    }
+
+    /**
+     * Returns, whether all reads so far have been successful
+     *
+     * @return \p true if no read went beyond the end of the buffer, \p false otherwise
+     */
+    [[nodiscard]] inline bool ok() const {
+        return !this->failed;
+    }
+
+    /**
+     * Marks the reader as failed, e.g. when a Serializer detects invalid data
+     */
+    inline void fail() {
+        this->failed = true;
+    }
+
+private:
+    /**
+     * The serialized data
+     */
+    const std::span<const char> data;
+    /**
+     * The position of the next byte to read
+     */
+    std::size_t position = 0;
+    /**
+     * Whether a read went beyond the end of the buffer
+     */
+    bool failed = false;
+};
+
+/**
+ * Serializer for trivially copyable types, which are copied as they are in memory
+ *
+ * @tparam T The trivially copyable data type
+ */
+template<typename T> requires std::is_trivially_copyable_v<T>
+struct Serializer<T> {
+    static inline void write(BinaryWriter &writer, const T &value) {
+        writer.writeBytes(&value, sizeof(T));
+    }
+
+    static inline void read(BinaryReader &reader, T &value) {
+        reader.readBytes(&value, sizeof(T));
+    }
+};
+
+/**
+ * Serializer for contiguous containers, which are written as element count followed by the elements. \n
+ * The elements of containers of trivially copyable types are copied with a single std::memcpy.
+ *
+ * @tparam T The data type of the container
+ */
+template<typename T> requires (!std::is_trivially_copyable_v<T> && std::ranges::contiguous_range<T> &&
+                               std::ranges::sized_range<T>)
+struct Serializer<T> {
+    /**
+     * The data type of the elements
+     */
+    using Element = std::remove_cv_t<std::ranges::range_value_t<T>>;
+
+    static inline void write(BinaryWriter &writer, const T &value) {
+        const auto size = static_cast<std::uint64_t>(std::ranges::size(value));
+        writer.writeBytes(&size, sizeof(size));
+
+        if constexpr (std::is_trivially_copyable_v<Element>) {
+            writer.writeBytes(std::ranges::data(value), size * sizeof(Element));
+        } else {
+            for (const Element &element : value) {
+                writer.write(element);
+            }
+        }
+    }
+
+    static inline void read(BinaryReader &reader, T &value) {
+        std::uint64_t size = 0;
+        if (!reader.readBytes(&size, sizeof(size))) {
+            return;
+        }
+
+        if constexpr (std::is_trivially_copyable_v<Element>) {
+            if (size > reader.remaining() / sizeof(Element)) {
+                reader.fail();
+                return;
+            }
+            const std::span<const char> bytes = reader.view(size * sizeof(Element));
+            if (!Serializer<T>::resize(value, size)) {
+                reader.fail();
+                return;
+            }
+            if (size) {
+                std::memcpy(std::ranges::data(value), bytes.data(), bytes.size());
+            }
+        } else {
+            if (size > reader.remaining() || !Serializer<T>::resize(value, size)) {
+                reader.fail();
+                return;
+            }
+            for (Element &element : value) {
+                reader.read(element);
+            }
+        }
+    }
+
+private:
+    /**
+     * Resizes \p value, if possible, so that it can hold \p size elements
+     *
+     * @param value The container to resize
+     * @param size The number of elements
+     * @return \p true if the container now holds \p size elements, \p false otherwise
+     */
+    static inline bool resize(T &value, const std::uint64_t size) {
+        if constexpr (requires { value.resize(size); }) {
+            value.resize(size);
+        }
+        return std::ranges::size(value) == size;
+    }
+};
+
+/**
+ * Serializer for tuple-like types, which are written element by element
+ *
+ * @tparam T The tuple-like data type
+ */
+template<typename T> requires (!std::is_trivially_copyable_v<T> && !std::ranges::range<T> &&
+                               requires { std::tuple_size<T>::value; })
+struct Serializer<T> {
+    static inline void write(BinaryWriter &writer, const T &value) {
+        std::apply([&writer](const auto &... elements) -> void { (writer.write(elements), ...); }, value);
+    }
+
+    static inline void read(BinaryReader &reader, T &value) {
+        std::apply([&reader](auto &... elements) -> void { (reader.read(elements), ...); }, value);
+    }
+};
+
+/**
+ * Serializer for std::chrono::duration, which is written as its tick count
+ *
+ * @tparam Rep The type of the tick count
+ * @tparam Period The length of a tick
+ */
+template<typename Rep, typename Period>
+struct Serializer<std::chrono::duration<Rep, Period>> {
+    static inline void write(BinaryWriter &writer, const std::chrono::duration<Rep, Period> &value) {
+        writer.write(value.count());
+    }
+
+    static inline void read(BinaryReader &reader, std::chrono::duration<Rep, Period> &value) {
+        value = std::chrono::duration<Rep, Period>(reader.read<Rep>());
+    }
+};
+
+/**
+ * Serializer for std::chrono::time_point, which is written as the tick count since the epoch of its clock
+ *
+ * @tparam Clock The clock of the time point
+ * @tparam Duration The duration type of the time point
+ */
+template<typename Clock, typename Duration>
+struct Serializer<std::chrono::time_point<Clock, Duration>> {
+    static inline void write(BinaryWriter &writer, const std::chrono::time_point<Clock, Duration> &value) {
+        writer.write(value.time_since_epoch());
+    }
+
+    static inline void read(BinaryReader &reader, std::chrono::time_point<Clock, Duration> &value) {
+        value = std::chrono::time_point<Clock, Duration>(reader.read<Duration>());
+    }
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef QT_MULTITHREADING_SHUTDOWNREPORT_H
+#define QT_MULTITHREADING_SHUTDOWNREPORT_H
+
+#include <QString>
+#include <QStringList>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Introspection.h"
+
+/**
+ * What happened during Controller::shutdown()
+ */
+struct ShutdownReport {
+    /**
+     * Whether all tasks finished in time without requesting the cancellation
+     */
+    bool drained = false;
+    /**
+     * Whether the threads of the Controller have been left running, since they did not stop in time. \n
+     * The WorkerController and its threads are leaked on purpose then, the process should exit soon.
+     */
+    bool detached = false;
+    /**
+     * The number of queued tasks discarded when requesting the cancellation, including the deprioritized ones
+     */
+    std::size_t discardedTasks = 0;
+    /**
+     * The Worker which have been busy when requesting the cancellation, together with their tasks
+     */
+    std::vector<WorkerIntrospection> inFlightTasks;
+    /**
+     * The number of tasks sent to remote Worker which have not been finished when requesting the cancellation,
+     * see ControllerConfiguration::remoteWorkers
+     */
+    std::size_t remoteInFlightTasks = 0;
+    /**
+     * The Worker which did not finish their task after requesting the cancellation
+     */
+    std::vector<WorkerIntrospection> stuckWorkers;
+    /**
+     * The time the shutdown took
+     */
+    std::chrono::nanoseconds duration{0};
+
+    /**
+     * Returns, whether all threads of the Controller stopped
+     *
+     * @return \p true if nothing has been detached, \p false otherwise
+     */
+    [[nodiscard]] inline bool isClean() const {
+        return !this->detached;
+    }
+
+    /**
+     * Describes the shutdown in a single line, meant for logs
+     *
+     * @return E.g. "detached after 2000 ms, 1 stuck Worker: #3 (task 17, running 2400 ms), ..."
+     */
+    [[nodiscard]] inline QString toString() const {
+        const auto milliseconds = [](const std::chrono::nanoseconds &duration) -> QString {
+            return QString::number(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+        };
+
+        QString text = this->detached ? QString("detached after ") : QString("stopped after ");
+        text += milliseconds(this->duration) + " ms";
+        if (this->drained) {
+            return text + ", all tasks finished";
+        }
+
+        QStringList stuck;
+        for (const WorkerIntrospection &worker : this->stuckWorkers) {
+            stuck.append(QString("#") + QString::number(worker.index) + " (task " + QString::number(worker.taskId) +
+                         ", running " + milliseconds(worker.taskAge) + " ms)");
+        }
+        QStringList cancelled;
+        for (const WorkerIntrospection &worker : this->inFlightTasks) {
+            cancelled.append(QString::number(worker.taskId));
+            for (const std::uint64_t batchedTaskId : worker.batchedTaskIds) {
+                cancelled.append(QString::number(batchedTaskId));
+            }
+        }
+
+        text += ", " + QString::number(this->stuckWorkers.size()) + " stuck Worker";
+        if (!stuck.isEmpty()) {
+            text += ": " + stuck.join(", ");
+        }
+        text += ", cancelled tasks: " + (cancelled.isEmpty() ? QString("none") : cancelled.join(", "));
+        text += ", " + QString::number(this->remoteInFlightTasks) + " remote tasks in flight";
+        text += ", " + QString::number(this->discardedTasks) + " queued tasks discarded";
+        return text;
+    }
+};
+
+#endif
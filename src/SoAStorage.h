@@ -0,0 +1,253 @@
+#ifndef QT_MULTITHREADING_SOASTORAGE_H
+#define QT_MULTITHREADING_SOASTORAGE_H
+
+#include <cstddef>
+#include <deque>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "HugePageAllocator.h"
+
+/**
+ * Trait used to opt a tuple-like task or result type into the structure-of-arrays storage provided by SoAStorage. \n
+ * Tuple-like means, that std::tuple_size and std::tuple_element are specialized for the type and that the fields
+ * can be accessed with get<I>() - which is the case for std::tuple, std::pair and std::array and
+ * may be provided for own aggregates as well. See: https://en.cppreference.com/w/cpp/language/structured_binding
+ *
+ * Example: \n
+ * template<> struct SoAStorageEnabled<return_tuple> : std::true_type {};
+ *
+ * @tparam T The data type which may be stored as structure-of-arrays
+ */
+template<typename T>
+struct SoAStorageEnabled : std::false_type {
+};
+
+/**
+ * Container storing tuple-like elements as structure-of-arrays, which means that every field of the elements
+ * is kept in its own contiguous std::vector. \n
+ * The elements thus occupy no padding between their fields, and scanning a single field with column()
+ * (e.g. with SIMD loads) does not touch the memory of the other fields.
+ *
+ * The container offers the subset of the std::deque interface used by the framework,
+ * so that it can be used as queue for tasks, see TaskQueue. \n
+ * Since the elements do not exist as a whole in memory, front() and operator[]() return copies.
+ *
+ * Notice: The queue of the WorkerController is not accessible, the tasks reach the Worker reassembled, one by one or
+ * as std::vector, see ControllerConfiguration::dispatchBatchSize. The columns are thus only available for
+ * own instances, e.g. a Processor collecting its results in a SoAStorage to scan them field by field afterwards.
+ *
+ * Notice: Fields of type bool are not supported, since std::vector<bool> does not store its elements contiguously.
+ *
+ * @tparam T The tuple-like data type to store
+ */
+template<typename T>
+class SoAStorage {
+private:
+    /**
+     * The indices of the fields of \p T
+     */
+    using FieldIndices = std::make_index_sequence<std::tuple_size_v<T>>;
+
+    /**
+     * Creates the type of the columns, which is a std::tuple containing a std::vector for every field of \p T
+     *
+     * @tparam I The indices of the fields of \p T
+     * @return Nothing, only used in unevaluated context
+     */
+    template<std::size_t ...I>
+    static auto columnsType(std::index_sequence<I...>) -> std::tuple<std::vector<
+            std::tuple_element_t<I, T>,
+            typename std::allocator_traits<TaskAllocator<T>>::template rebind_alloc<std::tuple_element_t<I, T>>
+    >...>;
+
+public:
+    /**
+     * The data type of the field with index \p I
+     */
+    template<std::size_t I>
+    using Field = std::tuple_element_t<I, T>;
+
+    /**
+     * Returns the number of stored elements
+     *
+     * @return The number of stored elements
+     */
+    [[nodiscard]] inline std::size_t size() const {
+        return std::get<0>(this->columns).size() - this->head;
+    }
+
+    /**
+     * Returns, whether no elements are stored
+     *
+     * @return \p true if no elements are stored, \p false otherwise
+     */
+    [[nodiscard]] inline bool empty() const {
+        return !this->size();
+    }
+
+    /**
+     * Returns the contiguous storage of the field with index \p I of all stored elements
+     *
+     * @tparam I The index of the field
+     * @return A std::span referring to the field \p I of all stored elements, in order
+     */
+    template<std::size_t I>
+    inline std::span<Field<I>> column() {
+        auto &fieldColumn = std::get<I>(this->columns);
+        return std::span<Field<I>>(fieldColumn.data() + this->head, fieldColumn.size() - this->head);
+    }
+
+    /**
+     * See SoAStorage::column()
+     *
+     * @tparam I The index of the field
+     * @return A std::span referring to the field \p I of all stored elements, in order
+     */
+    template<std::size_t I>
+    inline std::span<const Field<I>> column() const {
+        const auto &fieldColumn = std::get<I>(this->columns);
+        return std::span<const Field<I>>(fieldColumn.data() + this->head, fieldColumn.size() - this->head);
+    }
+
+    /**
+     * Reassembles the element at position \p index
+     *
+     * @param index The position of the element
+     * @return A copy of the element
+     */
+    inline T operator[](const std::size_t index) const {
+        return this->assemble(this->head + index, FieldIndices());
+    }
+
+    /**
+     * Reassembles the first element
+     *
+     * @return A copy of the first element
+     */
+    inline T front() const {
+        return (*this)[0];
+    }
+
+    /**
+     * Appends an element by splitting it into its fields
+     *
+     * @param element The element to append
+     */
+    inline void push_back(const T &element) {
+        this->split(element, FieldIndices());
+    }
+
+    /**
+     * Appends an element by splitting it into its fields
+     *
+     * @param element The element to append
+     */
+    inline void push_back(T &&element) {
+        this->split(std::move(element), FieldIndices());
+    }
+
+    /**
+     * Removes the first element. \n
+     * The storage of removed elements is reclaimed in bulk, as soon as they make up half of the storage,
+     * so that removing is O(1) amortized.
+     */
+    inline void pop_front() {
+        ++this->head;
+        if (this->head == std::get<0>(this->columns).size()) {
+            this->clear();
+        } else if (this->head >= SoAStorage<T>::compactionThreshold &&
+                   this->head * 2 >= std::get<0>(this->columns).size()) {
+            std::apply([head = this->head](auto &... fieldColumns) -> void {
+                (fieldColumns.erase(fieldColumns.begin(), fieldColumns.begin() + head), ...);
+            }, this->columns);
+            this->head = 0;
+        }
+    }
+
+    /**
+     * Reserves storage for at least \p capacity elements in every column
+     *
+     * @param capacity The number of elements to reserve storage for
+     */
+    inline void reserve(const std::size_t capacity) {
+        std::apply([capacity = this->head + capacity](auto &... fieldColumns) -> void {
+            (fieldColumns.reserve(capacity), ...);
+        }, this->columns);
+    }
+
+    /**
+     * Removes all elements
+     */
+    inline void clear() {
+        std::apply([](auto &... fieldColumns) -> void { (fieldColumns.clear(), ...); }, this->columns);
+        this->head = 0;
+    }
+
+    /**
+     * Releases unused storage of all columns
+     */
+    inline void shrink_to_fit() {
+        std::apply([](auto &... fieldColumns) -> void { (fieldColumns.shrink_to_fit(), ...); }, this->columns);
+    }
+
+private:
+    /**
+     * The number of removed elements at which it is considered to reclaim their storage
+     */
+    static constexpr std::size_t compactionThreshold = 1024;
+
+    /**
+     * The columns, one std::vector per field of \p T
+     */
+    decltype(SoAStorage<T>::columnsType(FieldIndices())) columns;
+
+    /**
+     * The position of the first element in the columns, everything in front of it has already been removed
+     */
+    std::size_t head = 0;
+
+    /**
+     * Reassembles the element at position \p index of the columns
+     *
+     * @tparam I The indices of the fields of \p T
+     * @param index The position in the columns
+     * @return A copy of the element
+     */
+    template<std::size_t ...I>
+    inline T assemble(const std::size_t index, std::index_sequence<I...>) const {
+        return T{std::get<I>(this->columns)[index]...};
+    }
+
+    /**
+     * Appends the fields of \p element to the columns
+     *
+     * @tparam Element Either a const reference or an rvalue reference to \p T
+     * @tparam I The indices of the fields of \p T
+     * @param element The element to append
+     */
+    template<typename Element, std::size_t ...I>
+    inline void split(Element &&element, std::index_sequence<I...>) {
+        static_assert(
+                (!std::is_same_v<std::remove_cv_t<Field<I>>, bool> && ...),
+                "SoAStorage does not support fields of type bool"
+        );
+
+        using std::get;
+        (std::get<I>(this->columns).emplace_back(get<I>(std::forward<Element>(element))), ...);
+    }
+};
+
+/**
+ * The container used by the WorkerController to queue tasks. \n
+ * A std::deque, unless SoAStorageEnabled has been specialized for \p T, in which case SoAStorage is being used.
+ * Both are backed by huge pages, if HugePagesEnabled has been specialized for \p T.
+ *
+ * @tparam T The data type of the task to fulfill
+ */
+template<typename T>
+using TaskQueue = std::conditional_t<SoAStorageEnabled<T>::value, SoAStorage<T>, std::deque<T, TaskAllocator<T>>>;
+
+#endif
@@ -0,0 +1,379 @@
+#ifndef QT_MULTITHREADING_SPILLQUEUE_H
+#define QT_MULTITHREADING_SPILLQUEUE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QTemporaryFile>
+#include <QtGlobal>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "SoAStorage.h"
+#include "Serialization.h"
+
+/**
+ * Queue used by the WorkerController to store the tasks going to be sent to Worker. \n
+ * As long as no memory budget is given, this is nothing more than a TaskQueue.
+ *
+ * With a memory budget, tasks queued beyond that budget are collected in a tail buffer, which is written
+ * to a spill file as soon as it reaches the chunk size. The queue thus consists of three parts, in order: \n
+ * The in-memory TaskQueue, the spill files, the tail buffer.
+ *
+ * When the in-memory part drains below half of the budget, the next spill file is read in the background
+ * ("read-ahead"), so that the tasks are usually available in memory before the workers need them.
+ *
+ * Notice: Spilling requires tasks satisfying Serializable, which are written with their Serializer. \n
+ * For other tasks the memory budget is ignored.
+ *
+ * @tparam T The data type of the task to fulfill
+ */
+template<typename T>
+class SpillQueue {
+public:
+    /**
+     * Constructor used to initialize the SpillQueue
+     *
+     * @param memoryBudget See SpillQueue::memoryBudget
+     * @param directory See SpillQueue::directory
+     * @param chunkSize See SpillQueue::chunkSize
+     * @param taskSize See SpillQueue::taskSize
+     */
+    explicit SpillQueue(const std::size_t memoryBudget = 0, QString directory = QString(),
+                        const std::size_t chunkSize = 1, std::function<std::size_t(const T &)> taskSize = nullptr)
+            : memoryBudget(memoryBudget), directory(std::move(directory)), chunkSize(chunkSize ? chunkSize : 1),
+              taskSize(std::move(taskSize)) {}
+
+    /**
+     * Waits for a pending read-ahead, the spill files are removed when their QTemporaryFile is destroyed
+     */
+    ~SpillQueue() {
+        this->clear();
+    }
+
+    /**
+     * Returns the number of queued tasks, including the spilled ones
+     *
+     * @return The number of queued tasks
+     */
+    [[nodiscard]] inline std::size_t size() const {
+        return this->memory.size() + this->spilledTasks + this->tail.size();
+    }
+
+    /**
+     * Returns the number of tasks written to spill files
+     *
+     * @return The number of spilled tasks
+     */
+    [[nodiscard]] inline std::size_t spilled() const {
+        return this->spilledTasks;
+    }
+
+    /**
+     * Returns the number of times a spill file could not be read. \n
+     * The tasks of such a file stay queued, the file is read again later, see SpillQueue::retryRefill()
+     *
+     * @return The number of failed reads since the start
+     */
+    [[nodiscard]] inline std::size_t readFailures() const {
+        return this->failedReads;
+    }
+
+    /**
+     * Returns the number of bytes occupied by the tasks in memory, which are the tasks not written to spill files
+     *
+     * @return The number of bytes
+     */
+    [[nodiscard]] inline std::size_t memoryBytes() const {
+        return this->bytesInMemory;
+    }
+
+    /**
+     * Returns, whether no tasks are queued. \n
+     * Since tasks are always loaded into memory before the in-memory part runs empty,
+     * it is sufficient to look at the in-memory part. \n
+     * The only exception is a spill file, which could not be read, see SpillQueue::retryRefill().
+     *
+     * @return \p true if no tasks are available, \p false otherwise
+     */
+    [[nodiscard]] inline bool empty() const {
+        return this->memory.empty();
+    }
+
+    /**
+     * Returns the first task
+     *
+     * @return The first task, either as reference or by value, depending on the TaskQueue
+     */
+    inline decltype(auto) front() {
+        return this->memory.front();
+    }
+
+    /**
+     * Appends a task, either to the in-memory part or to the tail buffer
+     *
+     * @param task The task to append
+     */
+    inline void push_back(const T &task) {
+        this->bytesInMemory += this->sizeOf(task);
+
+        if (!this->spillingEnabled() ||
+            (this->spillFiles.empty() && this->tail.empty() && this->bytesInMemory <= this->memoryBudget)) {
+            this->memory.push_back(task);
+            return;
+        }
+
+        this->tail.push_back(task);
+        if (this->tail.size() % this->chunkSize == 0) {
+            this->spillTail();
+        }
+    }
+
+    /**
+     * Removes the first task and loads spilled tasks into memory if needed. \n
+     * The size of the task is measured before it is moved out, so that a task with a user given
+     * ControllerConfiguration::taskSize is not measured in its moved-from state.
+     *
+     * @return The removed task
+     */
+    inline T pop_front() {
+        T task = std::move(this->memory.front());
+        this->bytesInMemory -= this->sizeOf(task);
+        this->memory.pop_front();
+        this->refill();
+        return task;
+    }
+
+    /**
+     * Reads the first spill file again, if reading it failed before and the in-memory part ran empty meanwhile. \n
+     * Called by the WorkerController whenever it looks for tasks, so that the spilled tasks are picked up again
+     * once the spill file becomes readable.
+     */
+    inline void retryRefill() {
+        if (this->memory.empty()) {
+            this->refill();
+        }
+    }
+
+    /**
+     * Removes all tasks, including the spill files
+     */
+    inline void clear() {
+        if (this->readAhead.valid()) {
+            this->readAhead.wait();
+            this->readAhead = std::future<QByteArray>();
+        }
+        this->memory.clear();
+        this->tail.clear();
+        this->spillFiles.clear();
+        this->spilledTasks = 0;
+        this->bytesInMemory = 0;
+    }
+
+    /**
+     * Releases unused memory
+     */
+    inline void shrink_to_fit() {
+        this->memory.shrink_to_fit();
+        this->tail.shrink_to_fit();
+    }
+
+private:
+    /**
+     * The number of bytes the in-memory part and the tail buffer may occupy, 0 disables spilling
+     */
+    const std::size_t memoryBudget;
+    /**
+     * The directory to create the spill files in
+     */
+    const QString directory;
+    /**
+     * The number of tasks to write to a single spill file
+     */
+    const std::size_t chunkSize;
+    /**
+     * Returns the number of bytes a task occupies in memory, sizeof(T) is used if not given
+     */
+    const std::function<std::size_t(const T &)> taskSize;
+    /**
+     * The number of bytes occupied by the in-memory part and the tail buffer
+     */
+    std::size_t bytesInMemory = 0;
+    /**
+     * The in-memory part of the queue, containing the oldest tasks
+     */
+    TaskQueue<T> memory;
+    /**
+     * The spill files in the order they have been written, together with the number of tasks they contain
+     */
+    std::deque<std::tuple<std::unique_ptr<QTemporaryFile>, std::size_t>> spillFiles;
+    /**
+     * The number of tasks contained in all spill files
+     */
+    std::size_t spilledTasks = 0;
+    /**
+     * The number of times a spill file could not be read, see SpillQueue::readFailures()
+     */
+    std::size_t failedReads = 0;
+    /**
+     * The tasks queued after the spill files, going to be written to the next spill file
+     */
+    std::vector<T, TaskAllocator<T>> tail;
+    /**
+     * The content of the first spill file, if it is already being read
+     */
+    std::future<QByteArray> readAhead;
+    /**
+     * The buffer used to serialize the tail buffer, kept to not allocate again for every spill file
+     */
+    std::vector<char> spillBuffer;
+
+    /**
+     * Returns, whether tasks are going to be spilled
+     *
+     * @return \p true if a memory budget is given and the tasks are Serializable, \p false otherwise
+     */
+    [[nodiscard]] inline bool spillingEnabled() const {
+        return Serializable<T> && this->memoryBudget;
+    }
+
+    /**
+     * Returns the number of bytes \p task occupies in memory
+     *
+     * @param task The task to get the size of
+     * @return The number of bytes, see SpillQueue::taskSize
+     */
+    [[nodiscard]] inline std::size_t sizeOf(const T &task) const {
+        return this->taskSize ? this->taskSize(task) : sizeof(T);
+    }
+
+    /**
+     * Writes the tail buffer to a new spill file. \n
+     * If that fails, the tasks are kept in memory and writing is tried again when the next chunk is complete.
+     */
+    inline void spillTail() {
+        if constexpr (Serializable<T>) {
+            auto spillFile = std::make_unique<QTemporaryFile>(this->directory + "/qt_multithreading_spill_XXXXXX");
+
+            this->spillBuffer.clear();
+            BinaryWriter writer(this->spillBuffer);
+            for (const T &task : this->tail) {
+                writer.write(task);
+            }
+            const auto bytes = static_cast<qint64>(this->spillBuffer.size());
+
+            if (!spillFile->open() || spillFile->write(this->spillBuffer.data(), bytes) != bytes) {
+                qWarning("SpillQueue: could not write spill file, keeping the tasks in memory");
+                return;
+            }
+            spillFile->close();
+
+            for (const T &task : this->tail) {
+                this->bytesInMemory -= this->sizeOf(task);
+            }
+            this->spilledTasks += this->tail.size();
+            this->spillFiles.emplace_back(std::move(spillFile), this->tail.size());
+            this->tail.clear();
+        }
+    }
+
+    /**
+     * Starts the read-ahead of the first spill file, if it is not already running
+     */
+    inline void startReadAhead() {
+        if (this->readAhead.valid()) {
+            return;
+        }
+
+        this->readAhead = std::async(
+                std::launch::async,
+                [fileName = std::get<0>(this->spillFiles.front())->fileName()]() -> QByteArray {
+                    QFile spillFile(fileName);
+                    return spillFile.open(QIODevice::ReadOnly) ? spillFile.readAll() : QByteArray();
+                }
+        );
+    }
+
+    /**
+     * Appends the tasks of the first spill file to the in-memory part and removes the file. \n
+     * Blocks, if the read-ahead has not finished yet.
+     *
+     * The file is only removed if all of its tasks could be read. Otherwise nothing is appended, the file is kept
+     * and reading it is tried again on the next refill, so that neither tasks are lost nor the order of the queue,
+     * which the ids of the tasks are derived from, changes.
+     *
+     * @return \p true if the tasks have been appended, \p false otherwise
+     */
+    inline bool loadSpillFile() {
+        if constexpr (Serializable<T>) {
+            this->startReadAhead();
+            const QByteArray content = this->readAhead.get();
+            const std::size_t numberOfTasks = std::get<1>(this->spillFiles.front());
+
+            BinaryReader reader(
+                    std::span<const char>(content.constData(), static_cast<std::size_t>(content.size()))
+            );
+            std::vector<T> loadedTasks;
+            loadedTasks.reserve(numberOfTasks);
+            for (std::size_t taskIndex = 0; taskIndex < numberOfTasks && reader.ok(); ++taskIndex) {
+                T task = reader.read<T>();
+                if (reader.ok()) {
+                    loadedTasks.push_back(std::move(task));
+                }
+            }
+            if (loadedTasks.size() != numberOfTasks) {
+                if (!this->failedReads++) {
+                    qWarning("SpillQueue: could not read spill file, trying again later");
+                }
+                return false;
+            }
+
+            for (T &task : loadedTasks) {
+                this->bytesInMemory += this->sizeOf(task);
+                this->memory.push_back(std::move(task));
+            }
+            this->spilledTasks -= numberOfTasks;
+            this->spillFiles.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Moves spilled or tail buffered tasks into memory, as soon as the in-memory part drains below half the budget. \n
+     * Keeps the invariant, that the in-memory part is only empty if the whole queue is empty, as long as the spill
+     * files can be read.
+     */
+    inline void refill() {
+        if (!this->spillingEnabled()) {
+            return;
+        }
+
+        const bool belowLowWatermark = this->bytesInMemory * 2 < this->memoryBudget;
+
+        if (!this->spillFiles.empty()) {
+            if (belowLowWatermark) {
+                this->startReadAhead();
+            }
+            if (this->memory.empty() || (this->readAhead.valid() &&
+                                         this->readAhead.wait_for(std::chrono::seconds(0)) ==
+                                         std::future_status::ready)) {
+                this->loadSpillFile();
+            }
+        } else if (!this->tail.empty() && (this->memory.empty() || belowLowWatermark)) {
+            for (const T &task : this->tail) {
+                this->memory.push_back(task);
+            }
+            this->tail.clear();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef QT_MULTITHREADING_STREAMINGWORKER_H
+#define QT_MULTITHREADING_STREAMINGWORKER_H
+
+#include "ResultEmitter.h"
+#include "Worker.h"
+
+/**
+ * Abstract template class for Worker producing a stream of results per task, e.g. tiles of an image or matches of
+ * a search. \n
+ * Instead of fulfillTask(), the user of the framework implements streamTask(), which pushes results to the given
+ * ResultEmitter while the task is still running, and clone(). The Processor receives every pushed result and the
+ * returned last result with receiveResult(), in the order they have been pushed.
+ *
+ * Compared to collecting everything in one result, the Processor gets the first results early and the Worker only
+ * holds a batch of results at a time, see ControllerConfiguration::resultBatchSize.
+ *
+ * Example: \n
+ * Match streamTask(Text &text, ResultEmitter<Match> &emitter) override { \n
+ *     for (...) emitter.push(match); \n
+ *     return Match::endOfText(text); \n
+ * }
+ *
+ * @tparam T The data type of the task to fulfill
+ * @tparam R The data type of the results calculated during fulfilling the task
+ */
+template<typename T, typename R>
+class StreamingWorker : public Worker<T, R> {
+protected:
+    /**
+     * The only constructor provided by this abstract class, see Worker::Worker()
+     */
+    StreamingWorker() = default;
+
+private:
+    /**
+     * Method to be implemented when inheriting from this abstract template class. \n
+     * Is going to contain the logic to handle the given task and to push the results.
+     *
+     * @param task The task to fulfill
+     * @param emitter Sends the pushed results to the Processor
+     * @return The last result, which is sent after all pushed results
+     */
+    R streamTask(T &task, ResultEmitter<R> &emitter) override = 0;
+
+    /**
+     * Never called, since streamTask() replaces it
+     *
+     * @param task The task to fulfill
+     * @return Nothing, since it is never called
+     */
+    R fulfillTask(T &task) final {
+        Q_UNUSED(task)
+        Q_UNREACHABLE();
+    }
+};
+
+#endif
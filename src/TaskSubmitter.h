@@ -0,0 +1,220 @@
+#ifndef QT_MULTITHREADING_TASKSUBMITTER_H
+#define QT_MULTITHREADING_TASKSUBMITTER_H
+
+#include <QObject>
+#include <QThread>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <utility>
+#include "Magic.h"
+#include "Admission.h"
+#include "Configuration.h"
+#include "Metrics.h"
+
+/*
+ * Forward declaration of the template class used to coordinate everything. \n
+ * Needed, since we are going to store a pointer to an object of this type.
+ *
+ * For a full description of this template class see WorkerController
+ */
+template<typename T, typename R>
+class WorkerController;
+
+/*
+ * Forward declaration of the template class creating the TaskSubmitter. \n
+ * Needed, since we are going to make this class a friend.
+ *
+ * For a full description of this template class see Controller
+ */
+template<typename T, typename R>
+class Controller;
+
+/**
+ * Handle to give tasks to the WorkerController from any thread, created with Controller::submitter(). \n
+ * Processor::extendQueue() may only be called from the thread of the Processor, so other producers had to hop into
+ * that thread first with a blocking call per submission. Instead, every producer thread gets its own TaskSubmitter,
+ * which collects the tasks in its own buffer and merges the buffer into the queue of the WorkerController with a single
+ * queued call, once it holds ControllerConfiguration::submitterBatchSize tasks. Producers thus share nothing but the
+ * event queue of the WorkerController, which they access once per batch.
+ *
+ * Notice: A TaskSubmitter is used by one thread at a time and must not outlive its Controller. It should not be used
+ * by the Processor, its shards or the WorkerController, since waiting for the memory budget would block their events,
+ * flushes from these threads skip the wait, use Processor::extendQueue() there instead. The buffered tasks are
+ * only given to the WorkerController with the next full batch, flush() or the destructor, so call flush() when a
+ * producer pauses. Tasks are deprioritized or rejected like with Processor::extendQueue(), since the batches are
+ * given without waiting for their outcome, the outcomes are summed up in admission().
+ *
+ * @tparam T The data type of the task to fulfill
+ * @tparam R The data type of the result calculated during fulfilling the task
+ */
+template<typename T, typename R>
+class TaskSubmitter {
+public:
+    TaskSubmitter(const TaskSubmitter &) = delete;
+
+    TaskSubmitter &operator=(const TaskSubmitter &) = delete;
+
+    /**
+     * Moves the buffer of another TaskSubmitter, e.g. to hand the TaskSubmitter to the producer thread
+     *
+     * @param other The TaskSubmitter whose buffered tasks are taken over
+     */
+    TaskSubmitter(TaskSubmitter &&other) noexcept
+            : workerController(other.workerController), configuration(other.configuration), metrics(other.metrics),
+              tally(other.tally), buffer(std::move(other.buffer)) {
+        other.buffer.clear();
+    }
+
+    /**
+     * Gives the buffered tasks to the WorkerController
+     */
+    ~TaskSubmitter() {
+        this->flush();
+    }
+
+    /**
+     * Adds a task to the buffer and gives the buffer to the WorkerController, once it is full
+     *
+     * @param task The task to fulfill
+     */
+    inline void submit(const T &task) {
+        this->buffer.push_back(task);
+        this->submitted();
+    }
+
+    /**
+     * Adds a task to the buffer and gives the buffer to the WorkerController, once it is full
+     *
+     * @param task The task to fulfill
+     */
+    inline void submit(T &&task) {
+        this->buffer.push_back(std::move(task));
+        this->submitted();
+    }
+
+    /**
+     * Gives the buffered tasks to the WorkerController at once. \n
+     * Blocks as long as the tasks would exceed the memory budget, see ControllerConfiguration::memoryBudget.
+     */
+    inline void flush() {
+        if (this->buffer.empty() || !this->workerController) {
+            return;
+        }
+        // the threads of the Controller must not block, the WorkerController rejects tasks beyond the budget anyway
+        const std::size_t batchBytes =
+                this->workerController->isOwnThread(QThread::currentThread()) ? 0 : this->awaitMemoryBudget();
+        // the outcome of the queued call is not waited for, but added to the tally,
+        // the buffer is moved into the queued call instead of being copied
+        std::deque<T> batch = std::move(this->buffer);
+        this->buffer = std::deque<T>();
+        invokeInContext(
+                static_cast<QObject *>(this->workerController), Qt::QueuedConnection,
+                &WorkerController<T, R>::submitQueue,
+                this->workerController, std::move(batch), batchBytes, this->tally
+        );
+    }
+
+    /**
+     * Returns the outcome of the batches given to the WorkerController so far, see AdmissionResult. \n
+     * Batches still on their way to the WorkerController are not included yet, the buffered tasks neither.
+     *
+     * Notice: Rejected tasks are not queued and are lost, unless the producer submits them again.
+     *
+     * @return The numbers of admitted, deprioritized and rejected tasks of all flushed batches
+     */
+    [[nodiscard]] inline AdmissionResult admission() const {
+        return this->tally->sum();
+    }
+
+    /**
+     * Returns the number of tasks not given to the WorkerController yet
+     *
+     * @return The number of buffered tasks
+     */
+    [[nodiscard]] inline std::size_t buffered() const {
+        return this->buffer.size();
+    }
+
+private:
+    /**
+     * Constructor used by the Controller
+     *
+     * @param workerController See TaskSubmitter::workerController
+     * @param configuration See TaskSubmitter::configuration
+     * @param metrics See TaskSubmitter::metrics
+     */
+    TaskSubmitter(WorkerController<T, R> *const workerController,
+                  const ControllerConfiguration<T, R> *const configuration, Metrics *const metrics)
+            : workerController(workerController), configuration(configuration), metrics(metrics),
+              tally(std::make_shared<AdmissionTally>()) {}
+
+    /**
+     * Gives the buffer to the WorkerController, if it is full
+     */
+    inline void submitted() {
+        // created after Controller::shutdown(), nothing is going to take the tasks
+        if (!this->workerController) {
+            this->buffer.clear();
+            return;
+        }
+
+        if (this->buffer.size() >= this->configuration->submitterBatchSize) {
+            this->flush();
+        }
+    }
+
+    /**
+     * Blocks until the buffered tasks fit into the memory budget, if there is one, like Processor::extendQueue(),
+     * at most for ControllerConfiguration::memoryBudgetTimeout. \n
+     * Accounts the buffered tasks until the WorkerController received them, see Metrics::submittedBytes, so that
+     * further flushes wait for them as well.
+     *
+     * @return The number of bytes accounted for the buffered tasks, 0 without a budget
+     */
+    inline std::size_t awaitMemoryBudget() const {
+        if (!this->configuration->memoryBudget) {
+            return 0;
+        }
+
+        std::size_t bufferedBytes = 0;
+        for (const T &task : this->buffer) {
+            bufferedBytes += this->configuration->sizeOfTask(task);
+        }
+
+        static_cast<void>(this->metrics->awaitMemoryBudget(
+                bufferedBytes, std::chrono::steady_clock::now() + this->configuration->memoryBudgetTimeout));
+        this->metrics->submittedBytes.fetch_add(bufferedBytes, std::memory_order_relaxed);
+        return bufferedBytes;
+    }
+
+    /**
+     * The WorkerController receiving the tasks, nullptr if created after Controller::shutdown()
+     */
+    WorkerController<T, R> *workerController;
+    /**
+     * The configuration of the WorkerController
+     */
+    const ControllerConfiguration<T, R> *configuration;
+    /**
+     * The metrics of the WorkerController, used for the memory budget
+     */
+    Metrics *metrics;
+    /**
+     * See admission(), shared with the queued calls to the WorkerController
+     */
+    std::shared_ptr<AdmissionTally> tally;
+    /**
+     * The tasks not given to the WorkerController yet
+     */
+    std::deque<T> buffer;
+
+    /**
+     * In order to be able to create the TaskSubmitter, whose constructor is private, making the
+     * template class Controller a friend is necessary.
+     */
+    friend class Controller<T, R>;
+};
+
+#endif
@@ -0,0 +1,381 @@
+#ifndef QT_MULTITHREADING_TCPREMOTEWORKERS_H
+#define QT_MULTITHREADING_TCPREMOTEWORKERS_H
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QObject>
+#include <QString>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include "RemoteProtocol.h"
+#include "RemoteWorkers.h"
+#include "Serialization.h"
+
+/**
+ * Backend for remote Worker connecting over TCP, see ControllerConfiguration::remoteWorkers and RemoteWorkerHost. \n
+ * Every RemoteWorkerHost announces how many tasks it wants to have in flight, its window, when connecting. Tasks are
+ * sent as soon as a window has room, so that the host always has the next tasks at hand while fulfilling the current
+ * ones, and all tasks given at once are sent as a single frame per connection. The host sends the results back in
+ * batches, too, see RemoteMessage.
+ *
+ * The tasks of a connection which is closed, or which has not been heard of for longer than the timeout, are given
+ * to other Worker. A RemoteWorkerHost reconnects on its own, so that a restarted host simply gets new tasks.
+ *
+ * Example: \n
+ * configuration.remoteWorkers = []() -> std::unique_ptr<RemoteWorkers<int, int>> { \n
+ *     return std::make_unique<TcpRemoteWorkers<int, int>>(QHostAddress::Any, 4711); \n
+ * };
+ *
+ * Notice: Requires the Qt Network module, the rest of the framework only requires the Qt Core module.
+ * Tasks and results are serialized with their Serializer, thus in native byte order.
+ *
+ * @tparam T The data type of the task to fulfill
+ * @tparam R The data type of the result calculated during fulfilling the task
+ */
+template<typename T, typename R>
+class TcpRemoteWorkers : public RemoteWorkers<T, R> {
+    static_assert(Serializable<T> && Serializable<R>, "tasks and results have to be Serializable to be sent over TCP");
+
+public:
+    /**
+     * Constructor used to initialize the TcpRemoteWorkers
+     *
+     * @param listenAddress The address to accept connections on, e.g. QHostAddress::Any for all interfaces
+     * @param listenPort The port to accept connections on, 0 to choose a free one, see address()
+     * @param timeout The longest time a connection may be silent before its tasks are given to other Worker,
+     *                0 to wait until the connection is closed, see RemoteWorkerHostConfiguration::heartbeatInterval
+     */
+    explicit TcpRemoteWorkers(const QHostAddress &listenAddress = QHostAddress(QHostAddress::LocalHost),
+                              const quint16 listenPort = 0,
+                              const std::chrono::milliseconds timeout = std::chrono::seconds(10))
+            : RemoteWorkers<T, R>(), listenAddress(listenAddress), listenPort(listenPort), timeout(timeout) {}
+
+    /**
+     * Closes all connections without handing back their tasks
+     */
+    ~TcpRemoteWorkers() override {
+        for (const std::shared_ptr<Host> &host : this->hosts) {
+            QObject::disconnect(host->socket, nullptr, this, nullptr);
+            host->socket->abort();
+        }
+    }
+
+private:
+    /**
+     * A connected RemoteWorkerHost
+     */
+    struct Host {
+        /**
+         * The connection to the host, a child of TcpRemoteWorkers::server
+         */
+        QTcpSocket *socket = nullptr;
+        /**
+         * The index of the connection, counting all connections ever accepted, see RemoteTask::connection
+         */
+        std::size_t index = 0;
+        /**
+         * The number of tasks the host wants to have in flight, 0 until the host said hello
+         */
+        std::size_t window = 0;
+        /**
+         * The tasks sent to the host, by their id
+         */
+        std::map<std::uint64_t, RemoteTask<T>> inFlight;
+        /**
+         * The tasks held back until flush()
+         */
+        RemoteFrameBuilder pending{RemoteMessage::Tasks};
+        /**
+         * Cuts the received bytes into frames
+         */
+        RemoteFrameReader reader;
+        /**
+         * The time the last frame of the host has been received
+         */
+        std::chrono::steady_clock::time_point lastHeard;
+    };
+
+    /**
+     * See RemoteWorkers::start()
+     *
+     * @return \p true if listening, \p false otherwise
+     */
+    inline bool start() override {
+        this->server = new QTcpServer(this);
+        QObject::connect(this->server, &QTcpServer::newConnection, this, [this]() -> void { this->accept(); });
+        if (!this->server->listen(this->listenAddress, this->listenPort)) {
+            return false;
+        }
+
+        if (this->timeout.count()) {
+            auto *timeoutTimer = new QTimer(this);
+            timeoutTimer->callOnTimeout([this]() -> void { this->dropSilentHosts(); });
+            timeoutTimer->start(static_cast<int>(std::max<std::int64_t>(this->timeout.count() / 4, 1)));
+        }
+        return true;
+    }
+
+    /**
+     * See RemoteWorkers::capacity()
+     *
+     * @return The free slots in the windows of all hosts
+     */
+    [[nodiscard]] inline std::size_t capacity() const override {
+        std::size_t free = 0;
+        for (const std::shared_ptr<Host> &host : this->hosts) {
+            free += host->window - std::min(host->window, host->inFlight.size());
+        }
+        return free;
+    }
+
+    /**
+     * See RemoteWorkers::send(), the task goes to the host with the most room in its window
+     *
+     * @param task The task to send
+     */
+    inline void send(RemoteTask<T> &task) override {
+        Host *target = nullptr;
+        std::size_t targetFree = 0;
+        for (const std::shared_ptr<Host> &host : this->hosts) {
+            const std::size_t free = host->window - std::min(host->window, host->inFlight.size());
+            if (free > targetFree) {
+                target = host.get();
+                targetFree = free;
+            }
+        }
+        if (!target) {
+            return;
+        }
+
+        task.connection = target->index;
+        target->pending.add(task.id, task.task);
+        const std::uint64_t id = task.id;
+        target->inFlight.emplace(id, std::move(task));
+    }
+
+    /**
+     * See RemoteWorkers::flush(), writes one frame per host. \n
+     * While receiving results, the tasks sent meanwhile are held back until all results of the frame are handed back.
+     */
+    inline void flush() override {
+        if (this->receiving) {
+            return;
+        }
+        for (const std::shared_ptr<Host> &host : this->hosts) {
+            if (host->pending.count()) {
+                const std::vector<char> &frame = host->pending.finish();
+                host->socket->write(frame.data(), static_cast<qint64>(frame.size()));
+                host->pending.reset(RemoteMessage::Tasks);
+            }
+        }
+    }
+
+    /**
+     * See RemoteWorkers::connections()
+     *
+     * @return The number of hosts, which said hello
+     */
+    [[nodiscard]] inline std::size_t connections() const override {
+        return static_cast<std::size_t>(std::count_if(
+                this->hosts.begin(), this->hosts.end(),
+                [](const std::shared_ptr<Host> &host) -> bool { return host->window; }
+        ));
+    }
+
+    /**
+     * See RemoteWorkers::address()
+     *
+     * @return The address and port listening on, e.g. "127.0.0.1:4711", empty if not listening
+     */
+    [[nodiscard]] inline QString address() const override {
+        if (!this->server || !this->server->isListening()) {
+            return QString();
+        }
+        return this->server->serverAddress().toString() + ":" + QString::number(this->server->serverPort());
+    }
+
+    /**
+     * Accepts the pending connections
+     */
+    inline void accept() {
+        while (QTcpSocket *socket = this->server->nextPendingConnection()) {
+            auto host = std::make_shared<Host>();
+            host->socket = socket;
+            host->index = this->nextHostIndex++;
+            host->lastHeard = std::chrono::steady_clock::now();
+            // the frames are small and latency matters more than the number of packets
+            socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            Host *hostPointer = host.get();
+            QObject::connect(socket, &QTcpSocket::readyRead, this, [this, hostPointer]() -> void {
+                this->receive(hostPointer);
+            });
+            QObject::connect(socket, &QTcpSocket::disconnected, this, [this, hostPointer]() -> void {
+                this->drop(hostPointer);
+            });
+            this->hosts.push_back(std::move(host));
+        }
+    }
+
+    /**
+     * Reads the frames received from a host
+     *
+     * @param hostPointer The host, which is ignored if it has been dropped already
+     */
+    inline void receive(Host *const hostPointer) {
+        // keep the host alive, even if it is dropped while handing back the results
+        const std::shared_ptr<Host> host = this->find(hostPointer);
+        if (!host) {
+            return;
+        }
+
+        const QByteArray bytes = host->socket->readAll();
+        host->reader.append(bytes.constData(), static_cast<std::size_t>(bytes.size()));
+        host->lastHeard = std::chrono::steady_clock::now();
+
+        bool windowOpened = false;
+        bool valid = true;
+        RemoteMessage type = RemoteMessage::Heartbeat;
+        std::uint32_t entries = 0;
+        std::span<const char> payload;
+        this->receiving = true;
+        while (valid && host->reader.next(type, entries, payload)) {
+            BinaryReader reader(payload);
+            if (type == RemoteMessage::Hello && entries == 1) {
+                const auto version = reader.read<std::uint32_t>();
+                const auto window = reader.read<std::uint32_t>();
+                if (reader.ok() && version != remoteProtocolVersion) {
+                    qWarning("TcpRemoteWorkers: closing a connection speaking another protocol version");
+                    reader.fail();
+                } else if (reader.ok()) {
+                    host->window = std::max<std::size_t>(window, 1);
+                    windowOpened = true;
+                }
+            } else if (type == RemoteMessage::Results) {
+                for (std::uint32_t entry = 0; entry < entries && reader.ok(); ++entry) {
+                    const auto id = reader.read<std::uint64_t>();
+                    const auto fulfillDuration = reader.read<std::chrono::nanoseconds>();
+                    std::vector<R> results;
+                    reader.read(results);
+                    // results of tasks not sent to this host are ignored
+                    const auto inFlightTask = host->inFlight.find(id);
+                    if (!reader.ok() || inFlightTask == host->inFlight.end()) {
+                        continue;
+                    }
+                    RemoteTask<T> task = std::move(inFlightTask->second);
+                    host->inFlight.erase(inFlightTask);
+                    this->taskFinished(task, results, fulfillDuration);
+                }
+            } else if (type != RemoteMessage::Heartbeat) {
+                reader.fail();
+            }
+            // the host may have been dropped while handing back the results
+            valid = reader.ok() && this->find(hostPointer);
+        }
+        this->receiving = false;
+
+        if (this->find(hostPointer) && (!valid || host->reader.isBroken())) {
+            qWarning("TcpRemoteWorkers: closing a connection sending invalid frames");
+            this->drop(hostPointer);
+        } else if (windowOpened) {
+            // nothing is lost, but there is room for new tasks
+            std::vector<RemoteTask<T>> noTasks;
+            this->tasksLost(noTasks);
+        }
+        this->flush();
+    }
+
+    /**
+     * Closes the connection to a host and gives its tasks to other Worker
+     *
+     * @param hostPointer The host, which is ignored if it has been dropped already
+     */
+    inline void drop(Host *const hostPointer) {
+        const std::shared_ptr<Host> host = this->find(hostPointer);
+        if (!host) {
+            return;
+        }
+        this->hosts.erase(std::find(this->hosts.begin(), this->hosts.end(), host));
+
+        QObject::disconnect(host->socket, nullptr, this, nullptr);
+        host->socket->abort();
+        host->socket->deleteLater();
+
+        std::vector<RemoteTask<T>> lostTasks;
+        lostTasks.reserve(host->inFlight.size());
+        for (auto &[id, task] : host->inFlight) {
+            lostTasks.push_back(std::move(task));
+        }
+        host->inFlight.clear();
+        this->tasksLost(lostTasks);
+    }
+
+    /**
+     * Drops the hosts which have not sent anything for longer than TcpRemoteWorkers::timeout
+     */
+    inline void dropSilentHosts() {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::vector<Host *> silentHosts;
+        for (const std::shared_ptr<Host> &host : this->hosts) {
+            if (now - host->lastHeard > this->timeout) {
+                silentHosts.push_back(host.get());
+            }
+        }
+        for (Host *const host : silentHosts) {
+            qWarning("TcpRemoteWorkers: closing a silent connection");
+            this->drop(host);
+        }
+    }
+
+    /**
+     * Returns the connected host for a pointer
+     *
+     * @param hostPointer The pointer to the host
+     * @return The host, nullptr if it has been dropped already
+     */
+    [[nodiscard]] inline std::shared_ptr<Host> find(const Host *const hostPointer) const {
+        const auto host = std::find_if(
+                this->hosts.begin(), this->hosts.end(),
+                [hostPointer](const std::shared_ptr<Host> &candidate) -> bool { return candidate.get() == hostPointer; }
+        );
+        return host == this->hosts.end() ? nullptr : *host;
+    }
+
+    /**
+     * The address to accept connections on
+     */
+    const QHostAddress listenAddress;
+    /**
+     * The port to accept connections on, 0 to choose a free one
+     */
+    const quint16 listenPort;
+    /**
+     * The longest time a connection may be silent, 0 for no limit
+     */
+    const std::chrono::milliseconds timeout;
+    /**
+     * Accepts the connections, created by start() in the thread of the WorkerController
+     */
+    QTcpServer *server = nullptr;
+    /**
+     * The connected hosts
+     */
+    std::vector<std::shared_ptr<Host>> hosts;
+    /**
+     * The index the next accepted connection is going to get
+     */
+    std::size_t nextHostIndex = 0;
+    /**
+     * Whether the results of a frame are being handed back, see flush()
+     */
+    bool receiving = false;
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef QT_MULTITHREADING_THREADPARKER_H
+#define QT_MULTITHREADING_THREADPARKER_H
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Lets a thread wait until another thread wakes it up, used by invokeInContext() for Qt::BlockingQueuedConnection. \n
+ * Every thread has exactly one ThreadParker, which is reused for all of its blocking calls, instead of creating a
+ * QSemaphore for every call like QMetaObject::invokeMethod() does. The thread only sleeps in the kernel, if the call
+ * did not finish during a short spin, and it is only woken up with a system call, if it actually sleeps.
+ *
+ * On Linux, the ThreadParker uses a futex directly, elsewhere std::atomic::wait(), which is built on the same idea.
+ */
+class ThreadParker {
+public:
+    /**
+     * Releases the ThreadParker of a thread waiting in park(), once destroyed. \n
+     * Travels with the invoked function, so that the waiting thread is released as soon as the function has been
+     * invoked, or when it is discarded without being invoked, e.g. since the context has been deleted,
+     * just like the QSemaphore of a QMetaCallEvent.
+     */
+    class Ticket {
+    public:
+        /**
+         * Constructor used to initialize the Ticket
+         *
+         * @param parker The ThreadParker to release, which has to be prepared already
+         */
+        explicit Ticket(ThreadParker &parker) : parker(&parker) {}
+
+        Ticket(const Ticket &) = delete;
+
+        Ticket &operator=(const Ticket &) = delete;
+
+        /**
+         * Moves the duty to release the ThreadParker, so that only the last owner releases it
+         *
+         * @param other The moved from Ticket, which no longer releases the ThreadParker
+         */
+        Ticket(Ticket &&other) noexcept : parker(other.parker) {
+            other.parker = nullptr;
+        }
+
+        Ticket &operator=(Ticket &&) = delete;
+
+        /**
+         * Releases the ThreadParker, unless moved from
+         */
+        ~Ticket() {
+            if (this->parker) {
+                this->parker->unpark();
+            }
+        }
+
+    private:
+        /**
+         * The ThreadParker to release, nullptr if moved from
+         */
+        ThreadParker *parker;
+    };
+
+    ThreadParker(const ThreadParker &) = delete;
+
+    ThreadParker &operator=(const ThreadParker &) = delete;
+
+    /**
+     * Returns the ThreadParker of the calling thread
+     *
+     * @return The ThreadParker of the calling thread, created on first use
+     */
+    static inline ThreadParker &current() {
+        thread_local ThreadParker parker;
+        return parker;
+    }
+
+    /**
+     * Arms the ThreadParker for the next call of park(), has to be called before handing out a Ticket
+     *
+     * @return The Ticket to hand to the thread, which is going to release the calling thread
+     */
+    inline Ticket prepare() {
+        this->state.store(ThreadParker::armed, std::memory_order_relaxed);
+        return Ticket(*this);
+    }
+
+    /**
+     * Blocks the calling thread until the Ticket handed out by prepare() has been destroyed
+     */
+    inline void park() {
+        // the call may have finished already, or is going to finish soon
+        for (int spin = 0; spin < ThreadParker::spins; ++spin) {
+            if (this->state.load(std::memory_order_acquire) == ThreadParker::released) {
+                return;
+            }
+        }
+
+        // announce sleeping, so that unpark() knows, it has to wake us up
+        std::uint32_t expected = ThreadParker::armed;
+        if (!this->state.compare_exchange_strong(expected, ThreadParker::sleeping, std::memory_order_acquire)) {
+            return;
+        }
+        while (this->state.load(std::memory_order_acquire) == ThreadParker::sleeping) {
+#if defined(__linux__)
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&this->state), FUTEX_WAIT_PRIVATE,
+                    ThreadParker::sleeping, nullptr, nullptr, 0);
+#else
+            this->state.wait(ThreadParker::sleeping, std::memory_order_acquire);
+#endif
+        }
+    }
+
+private:
+    /**
+     * Only ThreadParker::current() creates ThreadParker
+     */
+    ThreadParker() = default;
+
+    /**
+     * The ThreadParker has been prepared, the parked thread has not gone to sleep yet
+     */
+    static constexpr std::uint32_t armed = 0;
+    /**
+     * The ThreadParker has been released
+     */
+    static constexpr std::uint32_t released = 1;
+    /**
+     * The ThreadParker has been prepared and the parked thread is sleeping in the kernel
+     */
+    static constexpr std::uint32_t sleeping = 2;
+    /**
+     * The number of times park() checks for the release, before going to sleep
+     */
+    static constexpr int spins = 128;
+
+    /**
+     * Releases the parked thread, called by the Ticket
+     */
+    inline void unpark() {
+        if (this->state.exchange(ThreadParker::released, std::memory_order_release) == ThreadParker::sleeping) {
+#if defined(__linux__)
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&this->state), FUTEX_WAKE_PRIVATE, 1,
+                    nullptr, nullptr, 0);
+#else
+            this->state.notify_one();
+#endif
+        }
+    }
+
+    /**
+     * One of ThreadParker::armed, ThreadParker::released and ThreadParker::sleeping
+     */
+    std::atomic<std::uint32_t> state = ThreadParker::released;
+
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "a futex is a plain 32 bit word");
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef QT_MULTITHREADING_THREADUSAGE_H
+#define QT_MULTITHREADING_THREADUSAGE_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__linux__)
+
+#include <sys/resource.h>
+
+#endif
+
+/**
+ * The resources used by the calling thread, or the difference between two points in time. \n
+ * Read from CLOCK_THREAD_CPUTIME_ID and getrusage(RUSAGE_THREAD), the context switches and page faults are
+ * only available on Linux.
+ */
+struct ThreadUsage {
+    /**
+     * The CPU time consumed by the thread
+     */
+    std::chrono::nanoseconds cpuTime{0};
+    /**
+     * Context switches caused by the thread waiting, e.g. for I/O or a lock
+     */
+    std::uint64_t voluntaryContextSwitches = 0;
+    /**
+     * Context switches caused by the scheduler preempting the thread, e.g. because there are more threads than cores
+     */
+    std::uint64_t involuntaryContextSwitches = 0;
+    /**
+     * Minor and major page faults of the thread
+     */
+    std::uint64_t pageFaults = 0;
+
+    /**
+     * Reads the resources used by the calling thread so far
+     *
+     * @return The resources used so far
+     */
+    static inline ThreadUsage current() {
+        ThreadUsage usage;
+
+        timespec cpuTime{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime);
+        usage.cpuTime = std::chrono::seconds(cpuTime.tv_sec) + std::chrono::nanoseconds(cpuTime.tv_nsec);
+
+#if defined(__linux__)
+        rusage resources{};
+        getrusage(RUSAGE_THREAD, &resources);
+        usage.voluntaryContextSwitches = static_cast<std::uint64_t>(resources.ru_nvcsw);
+        usage.involuntaryContextSwitches = static_cast<std::uint64_t>(resources.ru_nivcsw);
+        usage.pageFaults = static_cast<std::uint64_t>(resources.ru_minflt + resources.ru_majflt);
+#endif
+        return usage;
+    }
+
+    /**
+     * Returns the resources used between two points in time
+     *
+     * @param start The resources used at the earlier point in time
+     * @return The difference
+     */
+    inline ThreadUsage operator-(const ThreadUsage &start) const {
+        ThreadUsage difference;
+        difference.cpuTime = this->cpuTime - start.cpuTime;
+        difference.voluntaryContextSwitches = this->voluntaryContextSwitches - start.voluntaryContextSwitches;
+        difference.involuntaryContextSwitches = this->involuntaryContextSwitches - start.involuntaryContextSwitches;
+        difference.pageFaults = this->pageFaults - start.pageFaults;
+        return difference;
+    }
+};
+
+#endif
@@ -0,0 +1,374 @@
+#ifndef QT_MULTITHREADING_TIMERWHEEL_H
+#define QT_MULTITHREADING_TIMERWHEEL_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * Identifies a timer of a TimerWheel, see Controller::scheduleAt() and Controller::scheduleEvery(). \n
+ * Never 0 for a scheduled timer, so that 0 can be used for "no timer".
+ */
+using TimerId = std::uint64_t;
+
+/**
+ * Hierarchical timer wheel holding a payload per timer, e.g. a task to give to the WorkerController when it is due. \n
+ * Time is divided into ticks. TimerWheel::levels wheels of TimerWheel::slotsPerLevel slots each cover
+ * the next 2^32 ticks, a timer is put into the slot of the lowest wheel covering its due tick and moved down
+ * to a lower wheel, whenever the current tick reaches its slot. Timers further in the future wait in the highest wheel
+ * and are moved again, until they are within reach.
+ *
+ * Scheduling and cancelling are O(1), the timers are kept in a pool and linked into their slots by index, so that
+ * millions of pending timers only cost their payload and a few words each. A timer fires in the first call to
+ * advance() at or after its due tick, never early, but up to one tick late.
+ *
+ * Notice: Not thread-safe, used only in the thread of the WorkerController.
+ *
+ * @tparam P The data type of the payload
+ */
+template<typename P>
+class TimerWheel {
+public:
+    /**
+     * Constructor for the wheel
+     *
+     * @param tick The resolution of the wheel
+     * @param start The time of the tick 0
+     */
+    explicit TimerWheel(const std::chrono::nanoseconds tick = std::chrono::milliseconds(1),
+                        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now())
+            : tick(std::max(tick, std::chrono::nanoseconds(1))), start(start) {
+        this->heads.fill(TimerWheel::none);
+    }
+
+    /**
+     * Schedules a timer
+     *
+     * @param due The time the timer fires at, timers due in the past fire with the next call to advance()
+     * @param payload The payload handed to the callback of advance()
+     * @param period If not zero, the timer fires every \p period after \p due until it is cancelled
+     * @return The id of the timer, used to cancel it
+     */
+    inline TimerId schedule(const std::chrono::steady_clock::time_point due, P payload,
+                            const std::chrono::nanoseconds period = std::chrono::nanoseconds(0)) {
+        std::uint32_t index;
+        if (this->freeNodes.empty()) {
+            index = static_cast<std::uint32_t>(this->nodes.size());
+            this->nodes.emplace_back();
+        } else {
+            index = this->freeNodes.back();
+            this->freeNodes.pop_back();
+        }
+        Node &node = this->nodes[index];
+        node.payload.emplace(std::move(payload));
+        node.dueTick = std::max(this->tickOf(due), this->currentTick + 1);
+        node.periodTicks = period.count() > 0 ? std::max<std::uint64_t>(period / this->tick, 1) : 0;
+        this->link(index);
+        ++this->numberOfTimers;
+        return TimerWheel::idOf(index, node.generation);
+    }
+
+    /**
+     * Cancels a timer, a periodic timer does not fire again
+     *
+     * @param id The id returned by schedule()
+     * @return \p true if the timer has been pending, \p false if it fired already or has been cancelled
+     */
+    inline bool cancel(const TimerId id) {
+        const auto index = static_cast<std::uint32_t>(id & 0xFFFFFFFFu);
+        if (!id || index >= this->nodes.size() || this->nodes[index].generation != static_cast<std::uint32_t>(id >> 32) ||
+            !this->nodes[index].payload) {
+            return false;
+        }
+        this->unlink(index);
+        this->release(index);
+        return true;
+    }
+
+    /**
+     * Fires all timers due until \p now
+     *
+     * @param now The current time
+     * @param fire Called with the payload of every due timer, in the order of their due ticks,
+     *             must not schedule or cancel timers of this wheel
+     */
+    template<typename Fire>
+    inline void advance(const std::chrono::steady_clock::time_point now, Fire &&fire) {
+        const std::uint64_t targetTick = this->tickOf(now);
+        if (!this->numberOfTimers) {
+            this->currentTick = std::max(this->currentTick, targetTick);
+            return;
+        }
+        while (this->currentTick < targetTick && this->numberOfTimers) {
+            // skip the ticks without timers to fire or to move down
+            this->currentTick = std::min(this->nextTick(), targetTick);
+            // move the timers of the reached slots of the higher wheels down, starting with the highest one
+            for (std::size_t level = TimerWheel::levels - 1; level > 0; --level) {
+                if (!(this->currentTick & ((std::uint64_t(1) << (level * TimerWheel::bitsPerLevel)) - 1))) {
+                    this->relink(level, this->slotOf(level, this->currentTick));
+                }
+            }
+            this->expire(this->slotOf(0, this->currentTick), targetTick, fire);
+        }
+        this->currentTick = std::max(this->currentTick, targetTick);
+    }
+
+    /**
+     * Returns the time advance() has to be called at next, which is the due time of the next timer, if it is in the
+     * lowest wheel, or the time its timer moves down otherwise
+     *
+     * @return The time, std::nullopt if there are no timers
+     */
+    [[nodiscard]] inline std::optional<std::chrono::steady_clock::time_point> nextAdvance() const {
+        if (!this->numberOfTimers) {
+            return std::nullopt;
+        }
+        return this->start + this->tick * static_cast<std::int64_t>(this->nextTick());
+    }
+
+    /**
+     * Returns the number of pending timers
+     *
+     * @return The number of timers scheduled and not fired or cancelled yet, periodic timers count once
+     */
+    [[nodiscard]] inline std::size_t size() const {
+        return this->numberOfTimers;
+    }
+
+private:
+    /**
+     * Returns the next tick with a slot to fire or to move down, see nextAdvance()
+     */
+    [[nodiscard]] inline std::uint64_t nextTick() const {
+        std::uint64_t nextTick = std::numeric_limits<std::uint64_t>::max();
+        for (std::size_t level = 0; level < TimerWheel::levels; ++level) {
+            const std::uint64_t shift = level * TimerWheel::bitsPerLevel;
+            for (std::uint64_t offset = 1; offset <= TimerWheel::slotsPerLevel; ++offset) {
+                // the tick at which the slot is reached, the slots of the higher wheels at the start of their range
+                const std::uint64_t slotTick = ((this->currentTick >> shift) + offset) << shift;
+                if (slotTick >= nextTick) {
+                    break;
+                }
+                if (this->heads[level * TimerWheel::slotsPerLevel + this->slotOf(level, slotTick)] != TimerWheel::none) {
+                    nextTick = slotTick;
+                    break;
+                }
+            }
+        }
+        return nextTick;
+    }
+
+    /**
+     * A timer, linked into the list of its slot
+     */
+    struct Node {
+        /**
+         * The payload, std::nullopt while the node is free
+         */
+        std::optional<P> payload;
+        /**
+         * The tick the timer fires at
+         */
+        std::uint64_t dueTick = 0;
+        /**
+         * The period in ticks, 0 if the timer fires once
+         */
+        std::uint64_t periodTicks = 0;
+        /**
+         * The previous and next node in the slot, TimerWheel::none at the ends of the list
+         */
+        std::uint32_t previous = TimerWheel::none;
+        std::uint32_t next = TimerWheel::none;
+        /**
+         * The slot the node is linked into, an index in TimerWheel::heads
+         */
+        std::uint32_t slot = 0;
+        /**
+         * Incremented whenever the node is released, so that ids of fired or cancelled timers do not match
+         */
+        std::uint32_t generation = 1;
+    };
+
+    /**
+     * The number of bits of a tick covered by one wheel
+     */
+    static constexpr std::size_t bitsPerLevel = 8;
+    /**
+     * The number of slots per wheel
+     */
+    static constexpr std::uint64_t slotsPerLevel = std::uint64_t(1) << TimerWheel::bitsPerLevel;
+    /**
+     * The number of wheels
+     */
+    static constexpr std::size_t levels = 4;
+    /**
+     * Marks the end of a list
+     */
+    static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+    /**
+     * Combines the index and the generation of a node to a TimerId
+     */
+    static inline TimerId idOf(const std::uint32_t index, const std::uint32_t generation) {
+        return (static_cast<TimerId>(generation) << 32) | index;
+    }
+
+    /**
+     * Returns the tick of a time point, rounded up so that timers never fire early
+     */
+    [[nodiscard]] inline std::uint64_t tickOf(const std::chrono::steady_clock::time_point time) const {
+        if (time <= this->start) {
+            return 0;
+        }
+        const std::chrono::nanoseconds sinceStart = time - this->start;
+        return static_cast<std::uint64_t>((sinceStart + this->tick - std::chrono::nanoseconds(1)) / this->tick);
+    }
+
+    /**
+     * Returns the slot of a tick in a wheel
+     */
+    static inline std::uint32_t slotOf(const std::size_t level, const std::uint64_t tick) {
+        return static_cast<std::uint32_t>((tick >> (level * TimerWheel::bitsPerLevel)) & (TimerWheel::slotsPerLevel - 1));
+    }
+
+    /**
+     * Links a node into the slot of the lowest wheel covering its due tick
+     */
+    inline void link(const std::uint32_t index) {
+        Node &node = this->nodes[index];
+        const std::uint64_t delta = node.dueTick - this->currentTick;
+        std::size_t level = 0;
+        while (level < TimerWheel::levels - 1 && delta >= (std::uint64_t(1) << ((level + 1) * TimerWheel::bitsPerLevel))) {
+            ++level;
+        }
+        // timers beyond the highest wheel wait in its last slot before the current one and are moved again
+        const std::uint64_t maximumTick =
+                this->currentTick + (std::uint64_t(1) << (TimerWheel::levels * TimerWheel::bitsPerLevel)) -
+                (std::uint64_t(1) << ((TimerWheel::levels - 1) * TimerWheel::bitsPerLevel));
+        node.slot = static_cast<std::uint32_t>(level * TimerWheel::slotsPerLevel) +
+                    this->slotOf(level, std::min(node.dueTick, maximumTick));
+        node.previous = TimerWheel::none;
+        node.next = this->heads[node.slot];
+        if (node.next != TimerWheel::none) {
+            this->nodes[node.next].previous = index;
+        }
+        this->heads[node.slot] = index;
+    }
+
+    /**
+     * Removes a node from the list of its slot
+     */
+    inline void unlink(const std::uint32_t index) {
+        Node &node = this->nodes[index];
+        if (node.previous != TimerWheel::none) {
+            this->nodes[node.previous].next = node.next;
+        } else {
+            this->heads[node.slot] = node.next;
+        }
+        if (node.next != TimerWheel::none) {
+            this->nodes[node.next].previous = node.previous;
+        }
+    }
+
+    /**
+     * Frees a node for the next timer
+     */
+    inline void release(const std::uint32_t index) {
+        Node &node = this->nodes[index];
+        node.payload.reset();
+        ++node.generation;
+        this->freeNodes.push_back(index);
+        --this->numberOfTimers;
+    }
+
+    /**
+     * Detaches the list of a slot
+     */
+    inline std::uint32_t detach(const std::uint32_t slot) {
+        const std::uint32_t head = this->heads[slot];
+        this->heads[slot] = TimerWheel::none;
+        return head;
+    }
+
+    /**
+     * Links the timers of a slot of a higher wheel again, which moves them to lower wheels
+     */
+    inline void relink(const std::size_t level, const std::uint32_t slot) {
+        std::uint32_t index = this->detach(static_cast<std::uint32_t>(level * TimerWheel::slotsPerLevel) + slot);
+        while (index != TimerWheel::none) {
+            const std::uint32_t next = this->nodes[index].next;
+            this->link(index);
+            index = next;
+        }
+    }
+
+    /**
+     * Fires the due timers of a slot of the lowest wheel
+     *
+     * @param slot The slot of the lowest wheel reached by TimerWheel::currentTick
+     * @param targetTick The tick advance() has been called for, periodic timers fire once up to it
+     * @param fire See advance()
+     */
+    template<typename Fire>
+    inline void expire(const std::uint32_t slot, const std::uint64_t targetTick, Fire &fire) {
+        std::uint32_t index = this->detach(slot);
+        while (index != TimerWheel::none) {
+            Node &node = this->nodes[index];
+            const std::uint32_t next = node.next;
+            if (node.dueTick > this->currentTick) {
+                // moved down too early, since it had been waiting beyond the highest wheel
+                this->link(index);
+            } else if (node.periodTicks) {
+                fire(*node.payload);
+                // skip the periods missed while the wheel has not been advanced, TimerWheel::currentTick only
+                // reaches the slot of the timer, thus the periods are counted up to the tick advanced to
+                node.dueTick += node.periodTicks;
+                if (node.dueTick <= targetTick) {
+                    node.dueTick += (targetTick - node.dueTick) / node.periodTicks * node.periodTicks +
+                                    node.periodTicks;
+                }
+                this->link(index);
+            } else {
+                fire(*node.payload);
+                this->release(index);
+            }
+            index = next;
+        }
+    }
+
+    /**
+     * The resolution of the wheel
+     */
+    const std::chrono::nanoseconds tick;
+    /**
+     * The time of the tick 0
+     */
+    const std::chrono::steady_clock::time_point start;
+    /**
+     * The last tick advance() has been called for
+     */
+    std::uint64_t currentTick = 0;
+    /**
+     * The first node of every slot of every wheel, TimerWheel::none for empty slots
+     */
+    std::array<std::uint32_t, TimerWheel::levels * TimerWheel::slotsPerLevel> heads{};
+    /**
+     * The pool of nodes
+     */
+    std::vector<Node> nodes;
+    /**
+     * The indices of the free nodes in TimerWheel::nodes
+     */
+    std::vector<std::uint32_t> freeNodes;
+    /**
+     * See size()
+     */
+    std::size_t numberOfTimers = 0;
+};
+
+#endif
@@ -3,9 +3,22 @@
 
 #include <QObject>
 #include <QUuid>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <vector>
 #include "Magic.h"
+#include "Configuration.h"
+#include "Hedging.h"
+#include "Metrics.h"
+#include "PerfCounters.h"
+#include "ResultChannel.h"
+#include "ResultEmitter.h"
+#include "ResultReducer.h"
+#include "ThreadUsage.h"
 
 /*
  * Forward declaration of the abstract template class used to give tasks and receive the results. \n
@@ -28,6 +41,15 @@ class Processor;
 template<typename T, typename R>
 class WorkerController;
 
+/*
+ * Forward declaration of the template class running Worker for a WorkerController in another process. \n
+ * Needed, since we are going to make this class a friend.
+ *
+ * For a full description of this template class see RemoteWorkerHost
+ */
+template<typename T, typename R>
+class RemoteWorkerHost;
+
 /**
  * Abstract template class to provide the skeleton for the concrete Worker of this framework. \n
  * The user of the framework has to inherit from this class and implement two functions, namely fulfillTask()
@@ -57,8 +79,10 @@ protected:
     Worker()
             : QObject(nullptr), workerUUID(0), uniqueWorkerUUID(QUuid::createUuid()),
               workerControllerContext(nullptr), workerController(nullptr),
-              processorContext(nullptr), processor(nullptr),
-              workDone(nullptr), resultCalculated(nullptr) {}
+              processorContext(nullptr), processor(nullptr), processorShards(nullptr), processorShard(0),
+              workDone(nullptr), reducerReceived(nullptr), resultCalculated(nullptr), resultsCalculated(nullptr),
+              resultsAvailable(nullptr),
+              configuration(nullptr), metrics(nullptr) {}
 
     /**
      * Be explicit about not wanting a copy constructor
@@ -80,6 +104,17 @@ protected:
      */
     Worker<T, R> &operator=(Worker<T, R> &&) = delete;
 
+    /**
+     * May be called from within fulfillTask() to stop fulfilling a hedged task early, since its duplicate already
+     * finished, see ControllerConfiguration::hedging, or since the Controller is shutting down,
+     * see Controller::shutdown(). The returned result is discarded in both cases.
+     *
+     * @return \p true if the result of the current task is going to be discarded, \p false otherwise
+     */
+    [[nodiscard]] inline bool isTaskCancelled() const {
+        return (this->currentClaim && this->currentClaim->isClaimed()) || this->isShutdownRequested();
+    }
+
 private:
     /**
      * Method to be implemented when inheriting from this abstract template class. \n
@@ -93,6 +128,20 @@ private:
      */
     virtual R fulfillTask(T &task) = 0;
 
+    /**
+     * Fulfills a task, while being able to send results to the Processor before the task is done,
+     * see StreamingWorker. \n
+     * Calls fulfillTask() by default, which sends exactly one result per task.
+     *
+     * @param task The task to fulfill
+     * @param emitter Sends results to the Processor while the task is fulfilled
+     * @return The last result calculated during fulfilling the task
+     */
+    virtual R streamTask(T &task, ResultEmitter<R> &emitter) {
+        Q_UNUSED(emitter)
+        return this->fulfillTask(task);
+    }
+
     /**
      * This method is used to clone an existing Worker. \n
      * Has to be implemented when inheriting from this abstract template class by the user of the framework,
@@ -118,19 +167,305 @@ private:
      * via this method
      *
      * @param task The new task to fulfill
+     * @param claim Shared with the duplicate of the task, if the task is hedged, nullptr otherwise
      */
-    inline void receiveTask(T &task) {
-        // fulfill task and receive result
-        R result = fulfillTask(task);
-        // send result to the Processor
-        invokeInContext(
-                this->processorContext, Qt::QueuedConnection, this->resultCalculated,
-                this->processor, result
+    inline void receiveTask(T &task, const std::shared_ptr<TaskClaim> &claim) {
+        // fulfill task and receive result, measuring how long it takes
+        TaskMeasurement measurement;
+        if (this->configuration->perfCounters) {
+            // the counters measure the calling thread, thus they have to be opened in the thread of the worker
+            if (!this->perfCounters) {
+                this->perfCounters = std::make_unique<PerfCounterGroup>();
+            }
+            measurement.taskClass = this->configuration->classOfTask(task);
+            this->perfCounters->start();
+        }
+        const ThreadUsage usageStart = this->configuration->workerUsage ? ThreadUsage::current() : ThreadUsage();
+        const std::chrono::steady_clock::time_point fulfillStart = std::chrono::steady_clock::now();
+        this->currentClaim = claim;
+        // the results of a hedged task are held back, until it is clear whether its duplicate finished first
+        ResultEmitter<R> emitter(
+                [this](std::vector<R> &results) -> void { this->sendResults(results); },
+                this->configuration->resultBatchSize, this->configuration->resultBatchInterval,
+                static_cast<bool>(claim)
         );
+        R result = this->streamTask(task, emitter);
+        measurement.fulfillDuration = std::chrono::steady_clock::now() - fulfillStart;
+        this->currentClaim.reset();
+        // the first of a task and its duplicate to finish sends the result
+        measurement.discarded = (claim && !claim->claim(measurement.lostBy)) || this->isShutdownRequested();
+        if (this->configuration->workerUsage) {
+            measurement.usage = ThreadUsage::current() - usageStart;
+        }
+        if (this->perfCounters) {
+            measurement.counters = this->perfCounters->stop();
+        }
+        if (emitter.count()) {
+            // the last result is sent together with the last batch
+            if (!measurement.discarded) {
+                emitter.push(std::move(result));
+            }
+            emitter.finish(!measurement.discarded);
+        } else if (!measurement.discarded && this->configuration->resultReducer) {
+            this->reducer()->fold(result);
+        } else if (!measurement.discarded) {
+            this->sendResult(result);
+        }
         // notify the WorkerController about being ready for a new task
         invokeInContext(
                 this->workerControllerContext, Qt::QueuedConnection, this->workDone,
-                this->workerController, this->workerUUID, this->uniqueWorkerUUID
+                this->workerController, this->workerUUID, this->uniqueWorkerUUID, measurement
+        );
+    }
+
+    /**
+     * Is going to be connected to the WorkerController so that this Worker will receive a batch of tasks,
+     * see ControllerConfiguration::dispatchBatchSize. \n
+     * The tasks are fulfilled one after another, the WorkerController is notified about each of them. \n
+     * Once the Controller is shutting down, the rest of the batch is not started anymore, but reported as discarded.
+     *
+     * @param tasks The new tasks to fulfill, in order
+     */
+    inline void receiveTasks(std::vector<T> &tasks) {
+        const std::shared_ptr<TaskClaim> noClaim;
+        for (T &task : tasks) {
+            if (this->isShutdownRequested()) {
+                // the WorkerController still releases the task, as if it had been fulfilled
+                TaskMeasurement measurement;
+                measurement.discarded = true;
+                invokeInContext(
+                        this->workerControllerContext, Qt::QueuedConnection, this->workDone,
+                        this->workerController, this->workerUUID, this->uniqueWorkerUUID, measurement
+                );
+                continue;
+            }
+            this->receiveTask(task, noClaim);
+        }
+    }
+
+    /**
+     * Fulfills a task on behalf of a RemoteWorkerHost, which sends the results back to the WorkerController
+     *
+     * @param task The task to fulfill
+     * @param results Set to the results calculated during fulfilling the task, in the order they have been pushed
+     */
+    inline void fulfillRemoteTask(T &task, std::vector<R> &results) {
+        results.clear();
+        // the results are sent together once the task is done, thus the emitter only sends when finished
+        ResultEmitter<R> emitter(
+                [&results](std::vector<R> &batch) -> void {
+                    results.insert(results.end(), std::make_move_iterator(batch.begin()),
+                                   std::make_move_iterator(batch.end()));
+                },
+                std::numeric_limits<std::size_t>::max(), std::chrono::nanoseconds::max(), false
+        );
+        R result = this->streamTask(task, emitter);
+        emitter.push(std::move(result));
+        emitter.finish(true);
+    }
+
+    /**
+     * Sends a batch of results of a ResultEmitter to the Processor
+     *
+     * @param results The results to send, which are cleared
+     */
+    inline void sendResults(std::vector<R> &results) {
+        if (this->configuration->resultReducer) {
+            for (R &result : results) {
+                this->reducer()->fold(result);
+            }
+            results.clear();
+            return;
+        }
+
+        if (this->processorShards && this->configuration->resultShardKey) {
+            // split the batch by shard, keeping the order of the results per shard
+            std::vector<std::vector<R>> shardResults(this->processorShards->size());
+            for (R &result : results) {
+                shardResults[this->shardOf(result)].push_back(std::move(result));
+            }
+            results.clear();
+            for (std::size_t shard = 0; shard < shardResults.size(); ++shard) {
+                if (!shardResults[shard].empty()) {
+                    this->sendBatch(shard, shardResults[shard]);
+                }
+            }
+        } else {
+            this->sendBatch(this->processorShard, results);
+        }
+    }
+
+    /**
+     * Sends a single result to the Processor
+     *
+     * @param result The result to send
+     */
+    inline void sendResult(R &result) {
+        // account the result until the Processor received it
+        const std::size_t resultBytes = this->configuration->sizeOfResult(result);
+        this->metrics->pendingResults.fetch_add(1, std::memory_order_relaxed);
+        this->metrics->pendingResultBytes.fetch_add(resultBytes, std::memory_order_relaxed);
+        // send result to the Processor
+        const std::size_t shard = this->shardOf(result);
+        Processor<T, R> *const resultProcessor = this->processorOf(shard);
+        if (ResultChannel<R> *const channel = this->resultChannelOf(shard)) {
+            channel->push(result, resultBytes);
+            this->notifyProcessor(*channel, resultProcessor);
+        } else {
+            invokeInContext(
+                    this->contextOf(resultProcessor), this->resultConnectionType(), this->resultCalculated,
+                    resultProcessor, result, resultBytes
+            );
+        }
+    }
+
+    /**
+     * Sends a batch of results to a Processor
+     *
+     * @param shard The index of the Processor to send the results to, see Worker::processorShards
+     * @param results The results to send, which are cleared
+     */
+    inline void sendBatch(const std::size_t shard, std::vector<R> &results) {
+        Processor<T, R> *const batchProcessor = this->processorOf(shard);
+        if (ResultChannel<R> *const channel = this->resultChannelOf(shard)) {
+            for (R &result : results) {
+                // account the result until the Processor received it
+                const std::size_t resultBytes = this->configuration->sizeOfResult(result);
+                this->metrics->pendingResults.fetch_add(1, std::memory_order_relaxed);
+                this->metrics->pendingResultBytes.fetch_add(resultBytes, std::memory_order_relaxed);
+                channel->push(result, resultBytes);
+            }
+            this->notifyProcessor(*channel, batchProcessor);
+            results.clear();
+            return;
+        }
+
+        // account the results until the Processor received them
+        std::size_t resultBytes = 0;
+        for (const R &result : results) {
+            resultBytes += this->configuration->sizeOfResult(result);
+        }
+        this->metrics->pendingResults.fetch_add(results.size(), std::memory_order_relaxed);
+        this->metrics->pendingResultBytes.fetch_add(resultBytes, std::memory_order_relaxed);
+        invokeInContext(
+                this->contextOf(batchProcessor), this->resultConnectionType(), this->resultsCalculated,
+                batchProcessor, results, resultBytes
+        );
+        results.clear();
+    }
+
+    /**
+     * Notifies the Processor about new results in a ResultChannel, unless a notification is pending already
+     *
+     * @param channel The channel results have been pushed to
+     * @param channelProcessor The Processor draining \p channel
+     */
+    inline void notifyProcessor(ResultChannel<R> &channel, Processor<T, R> *const channelProcessor) {
+        ResultInbox<R> *inbox = &channel.inbox();
+        if (inbox->notify()) {
+            invokeInContext(
+                    this->contextOf(channelProcessor), Qt::QueuedConnection, this->resultsAvailable,
+                    channelProcessor, inbox
+            );
+        }
+    }
+
+    /**
+     * Returns the index of the shard receiving a result, see ControllerConfiguration::processorShards
+     *
+     * @param result The result to send
+     * @return The shard selected by ControllerConfiguration::resultShardKey, if set, Worker::processorShard otherwise
+     */
+    [[nodiscard]] inline std::size_t shardOf(const R &result) const {
+        if (this->processorShards && this->configuration->resultShardKey) {
+            return this->configuration->resultShardKey(result) % this->processorShards->size();
+        }
+        return this->processorShard;
+    }
+
+    /**
+     * Returns the Processor of a shard
+     *
+     * @param shard The index of the shard, see Worker::processorShards
+     * @return The Processor, Worker::processor once the connections have been invalidated
+     */
+    [[nodiscard]] inline Processor<T, R> *processorOf(const std::size_t shard) const {
+        return this->processorShards ? (*this->processorShards)[shard] : this->processor;
+    }
+
+    /**
+     * Returns the ResultChannel to a shard, see ControllerConfiguration::resultChannels
+     *
+     * @param shard The index of the shard, see Worker::processorShards
+     * @return The channel, nullptr if the results are sent via the event queue of the Processor
+     */
+    [[nodiscard]] inline ResultChannel<R> *resultChannelOf(const std::size_t shard) const {
+        return this->processorContext && shard < this->resultChannels.size() ? this->resultChannels[shard].get() : nullptr;
+    }
+
+    /**
+     * Returns the context to invoke a Processor in
+     *
+     * @param resultProcessor The Processor to invoke
+     * @return \p resultProcessor casted to a QObject*, nullptr once the connections have been invalidated
+     */
+    [[nodiscard]] inline QObject *contextOf(Processor<T, R> *const resultProcessor) const {
+        return this->processorContext ? static_cast<QObject *>(resultProcessor) : nullptr;
+    }
+
+    /**
+     * Returns how results are sent to the Processor, see ControllerConfiguration::concurrentResults
+     *
+     * @return Qt::DirectConnection to call the Processor in the thread of this Worker, Qt::QueuedConnection otherwise
+     */
+    [[nodiscard]] inline Qt::ConnectionType resultConnectionType() const {
+        return this->configuration->concurrentResults ? Qt::DirectConnection : Qt::QueuedConnection;
+    }
+
+    /**
+     * Returns, whether the Controller requested to cancel all tasks, since it is shutting down,
+     * see Controller::shutdown()
+     *
+     * @return \p true if the results are going to be discarded, \p false otherwise
+     */
+    [[nodiscard]] inline bool isShutdownRequested() const {
+        return this->metrics && this->metrics->shutdownRequested.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the ResultReducer of this Worker, cloned from ControllerConfiguration::resultReducer on first use
+     *
+     * @return The ResultReducer of this Worker
+     */
+    inline ResultReducer<R> *reducer() {
+        if (!this->resultReducer) {
+            this->resultReducer = this->configuration->resultReducer->clone();
+        }
+        return this->resultReducer.get();
+    }
+
+    /**
+     * Hands over the ResultReducer of this Worker, which starts with an empty one afterwards,
+     * called in the thread of this Worker on behalf of the WorkerController
+     *
+     * @param reducer Set to the ResultReducer of this Worker, nullptr if nothing has been folded yet
+     */
+    inline void takeReducer(std::shared_ptr<ResultReducer<R>> &reducer) {
+        reducer = std::move(this->resultReducer);
+    }
+
+    /**
+     * Hands over the ResultReducer of this Worker to a reduction, which starts with an empty one afterwards,
+     * called in the thread of this Worker on behalf of WorkerController::collectReduction(). \n
+     * The state is sent back with a queued call, so that the WorkerController does not wait for the current task.
+     *
+     * @param reductionId The id of the reduction to hand over the state to
+     */
+    inline void sendReducer(const std::uint64_t &reductionId) {
+        const std::shared_ptr<ResultReducer<R>> reducer = std::move(this->resultReducer);
+        invokeInContext(
+                this->workerControllerContext, Qt::QueuedConnection, this->reducerReceived,
+                this->workerController, reductionId, this->uniqueWorkerUUID, reducer
         );
     }
 
@@ -146,8 +481,14 @@ private:
      * @param newWorkerController See Worker::workerController
      * @param newProcessorContext See Worker::processorContext
      * @param newProcessor See Worker::processor
+     * @param newProcessorShards See Worker::processorShards
      * @param newWorkDone See Worker::workDone
+     * @param newReducerReceived See Worker::reducerReceived
      * @param newResultCalculated See Worker::resultCalculated
+     * @param newResultsCalculated See Worker::resultsCalculated
+     * @param newResultsAvailable See Worker::resultsAvailable
+     * @param newConfiguration See Worker::configuration
+     * @param newMetrics See Worker::metrics
      */
     inline void
     setupConnections(const std::size_t newWorkerUUID = 0,
@@ -155,10 +496,20 @@ private:
                      WorkerController<T, R> *const newWorkerController = nullptr,
                      QObject *const newProcessorContext = nullptr,
                      Processor<T, R> *const newProcessor = nullptr,
-                     void (WorkerController<T, R>::* const newWorkDone)(const std::size_t &, const QUuid &) = nullptr,
-                     void (Processor<T, R>::* const newResultCalculated)(R &) = nullptr) {
+                     const std::vector<Processor<T, R> *> *const newProcessorShards = nullptr,
+                     void (WorkerController<T, R>::* const newWorkDone)(const std::size_t &, const QUuid &,
+                                                                        const TaskMeasurement &) = nullptr,
+                     void (WorkerController<T, R>::* const newReducerReceived)(
+                             const std::uint64_t &, const QUuid &, const std::shared_ptr<ResultReducer<R>> &) = nullptr,
+                     void (Processor<T, R>::* const newResultCalculated)(R &, const std::size_t &) = nullptr,
+                     void (Processor<T, R>::* const newResultsCalculated)(std::vector<R> &,
+                                                                          const std::size_t &) = nullptr,
+                     void (Processor<T, R>::* const newResultsAvailable)(ResultInbox<R> *const &) = nullptr,
+                     const ControllerConfiguration<T, R> *const newConfiguration = nullptr,
+                     Metrics *const newMetrics = nullptr) {
         this->workerControllerContext = newWorkerControllerContext;
         this->processorContext = newProcessorContext;
+        this->processorShards = newProcessorShards;
 
         // only set new workerUUID if it is not 0
         this->workerUUID = newWorkerUUID ? newWorkerUUID : this->workerUUID;
@@ -171,7 +522,14 @@ private:
 
         // only set new function pointers if they are not nullptr
         this->workDone = newWorkDone ? newWorkDone : this->workDone;
+        this->reducerReceived = newReducerReceived ? newReducerReceived : this->reducerReceived;
         this->resultCalculated = newResultCalculated ? newResultCalculated : this->resultCalculated;
+        this->resultsCalculated = newResultsCalculated ? newResultsCalculated : this->resultsCalculated;
+        this->resultsAvailable = newResultsAvailable ? newResultsAvailable : this->resultsAvailable;
+
+        // only set new ptr to the configuration and the metrics if not nullptr
+        this->configuration = newConfiguration ? newConfiguration : this->configuration;
+        this->metrics = newMetrics ? newMetrics : this->metrics;
     }
 
     /**
@@ -210,23 +568,88 @@ private:
      */
     Processor<T, R> *processor;
 
+    /**
+     * Pointer to all shards of the Processor, indexed by Processor::shardIndex(),
+     * see ControllerConfiguration::processorShards
+     */
+    const std::vector<Processor<T, R> *> *processorShards;
+
+    /**
+     * The index of Worker::processor in Worker::processorShards
+     */
+    std::size_t processorShard;
+
+    /**
+     * The channels to the shards of the Processor, indexed like Worker::processorShards,
+     * see ControllerConfiguration::resultChannels
+     */
+    std::vector<std::shared_ptr<ResultChannel<R>>> resultChannels;
+
     /**
      * Going to be invoked in the thread of the WorkerController after having fulfilled a task to notify the
      * WorkerController about being ready to receive a new task.
      */
-    void (WorkerController<T, R>::* workDone)(const std::size_t &, const QUuid &);
+    void (WorkerController<T, R>::* workDone)(const std::size_t &, const QUuid &, const TaskMeasurement &);
+
+    /**
+     * Going to be invoked in the thread of the WorkerController to hand over the ResultReducer of this Worker
+     * to a reduction, see Worker::sendReducer()
+     */
+    void (WorkerController<T, R>::* reducerReceived)(const std::uint64_t &, const QUuid &,
+                                                      const std::shared_ptr<ResultReducer<R>> &);
 
     /**
      * Going to be invoked in the thread of the Processor after having fulfilled a task to send the result
      * to the Processor.
      */
-    void (Processor<T, R>::* resultCalculated)(R &);
+    void (Processor<T, R>::* resultCalculated)(R &, const std::size_t &);
+
+    /**
+     * Going to be invoked in the thread of the Processor to send a batch of results of a ResultEmitter
+     * to the Processor.
+     */
+    void (Processor<T, R>::* resultsCalculated)(std::vector<R> &, const std::size_t &);
+
+    /**
+     * Going to be invoked in the thread of the Processor to drain the ResultChannel of all Worker,
+     * see ControllerConfiguration::resultChannels
+     */
+    void (Processor<T, R>::* resultsAvailable)(ResultInbox<R> *const &);
+
+    /**
+     * Pointer to the configuration of the relevant WorkerController
+     */
+    const ControllerConfiguration<T, R> *configuration;
+
+    /**
+     * Pointer to the metrics of the relevant WorkerController
+     */
+    Metrics *metrics;
+    /**
+     * The performance counters of the thread of the Worker, opened on the first task when using
+     * ControllerConfiguration::perfCounters
+     */
+    std::unique_ptr<PerfCounterGroup> perfCounters;
+    /**
+     * The TaskClaim of the task being fulfilled, if it is hedged, see isTaskCancelled()
+     */
+    std::shared_ptr<TaskClaim> currentClaim;
+    /**
+     * The state the results are folded into, see ControllerConfiguration::resultReducer
+     */
+    std::unique_ptr<ResultReducer<R>> resultReducer;
 
     /**
      * In order to be able to set up the connections etc. which is only allowed via a private method, making the
      * template class WorkerController a friend is necessary.
      */
     friend class WorkerController<T, R>;
+
+    /**
+     * In order to fulfill tasks for a WorkerController in another process,
+     * making the template class RemoteWorkerHost a friend is necessary.
+     */
+    friend class RemoteWorkerHost<T, R>;
 };
 
 #endif
@@ -5,13 +5,36 @@
 #include <QUuid>
 #include <QCoreApplication>
 #include <QThread>
+#include <QTimer>
+#include <QString>
 #include <memory>
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <optional>
 #include <set>
 #include <tuple>
+#include <utility>
 #include <vector>
 #include "Magic.h"
+#include "Admission.h"
+#include "AutoTuner.h"
+#include "Configuration.h"
+#include "Hedging.h"
+#include "HugePageAllocator.h"
+#include "Introspection.h"
+#include "Metrics.h"
+#include "PerfCounters.h"
+#include "Recording.h"
+#include "RemoteWorkers.h"
+#include "ResultChannel.h"
+#include "SpillQueue.h"
+#include "TimerWheel.h"
 #include "Worker.h"
 #include "Processor.h"
 
@@ -24,6 +47,73 @@
 template<typename T, typename R>
 class Controller;
 
+/*
+ * Forward declaration of the template class giving tasks from any thread. \n
+ * Needed, since we are going to make this class a friend.
+ *
+ * For a full description of this template class see TaskSubmitter
+ */
+template<typename T, typename R>
+class TaskSubmitter;
+
+/**
+ * Bookkeeping of the WorkerController about the task a Worker is currently fulfilling
+ */
+struct InFlightTask {
+    /**
+     * The number of bytes accounted for the task, 0 if the Worker is ready for a new task
+     */
+    std::size_t bytes = 0;
+    /**
+     * The id of the task, see WorkerController::nextTaskId
+     */
+    std::uint64_t id = 0;
+    /**
+     * The time the task has been sent to the Worker
+     */
+    std::chrono::steady_clock::time_point dispatched;
+    /**
+     * Shared by the task and its duplicate, if the task is hedged, see ControllerConfiguration::hedging
+     */
+    std::shared_ptr<TaskClaim> claim;
+    /**
+     * Whether the task is the duplicate of a task fulfilled by another Worker
+     */
+    bool duplicate = false;
+    /**
+     * Whether a duplicate of the task has been sent to another Worker
+     */
+    bool hedged = false;
+    /**
+     * The ids and the numbers of bytes of the tasks sent together with the task, which the Worker fulfills after it,
+     * see ControllerConfiguration::dispatchBatchSize
+     */
+    std::deque<std::pair<std::uint64_t, std::size_t>> batched;
+};
+
+/**
+ * Bookkeeping of the WorkerController about a reduction requested with Processor::collectReduction(),
+ * whose Worker have not all handed over their ResultReducer yet
+ *
+ * @tparam T The data type of the task to fulfill
+ * @tparam R The data type of the result calculated during fulfilling the task
+ */
+template<typename T, typename R>
+struct PendingReduction {
+    /**
+     * The Processor which requested the reduction and receives the merged state
+     */
+    Processor<T, R> *requester = nullptr;
+    /**
+     * The states merged so far
+     */
+    std::shared_ptr<ResultReducer<R>> reducer;
+    /**
+     * The unique UUIDs of the Worker, whose state has not been merged yet
+     */
+    std::set<QUuid> awaitedWorkers;
+};
+
 /**
  * This class is used to coordinate everything between the Worker and the Processor instances. \n
  * The class is ready to use as is, nothing has to be implemented by the user of the framework.
@@ -41,11 +131,19 @@ public:
         // mark, that we entered the destructor
         this->isInDestructor = true;
 
+        // stop the remote Worker first, their tasks are not handed back anymore
+        if (this->remoteWorkers) {
+            this->remoteWorkers->setupConnections();
+            this->remoteWorkers.reset();
+        }
+
         // disconnect everything
-        invokeInContext(
-                static_cast<QObject *>(this->processor), Qt::QueuedConnection,
-                [processor = this->processor]() -> void { processor->setupConnections(); }
-        );
+        for (Processor<T, R> *const shard : this->processors) {
+            invokeInContext(
+                    static_cast<QObject *>(shard), Qt::QueuedConnection,
+                    [shard]() -> void { shard->setupConnections(); }
+            );
+        }
         for (auto &threadTuple : this->threads) {
             invokeInContext(
                     static_cast<QObject *>(std::get<1>(threadTuple)), Qt::BlockingQueuedConnection,
@@ -56,14 +154,22 @@ public:
         // stop workers and wait for them to finish
         this->setNumberOfThreads(0);
 
-        // stop processor
+        // stop processor and its shards
         this->processorThread.quit();
+        for (auto &shardThread : this->processorShardThreads) {
+            shardThread->quit();
+        }
 
         // the Processor is using BlockingQueuedConnection to connect to this WorkerController
         // thus process all pending events until the Processor actually finished
         while (!this->processorThread.wait(1)) {
             QCoreApplication::processEvents();
         }
+        for (auto &shardThread : this->processorShardThreads) {
+            while (!shardThread->wait(1)) {
+                QCoreApplication::processEvents();
+            }
+        }
     }
 
 private:
@@ -73,24 +179,63 @@ private:
      * @param prototypeWorker The prototype worker, which will be cloned as many times as specified with \p numberOfThreads
      * @param processor The Processor which will send tasks to the WorkerController and receive results from the Worker
      * @param numberOfThreads The number of threads to use, which is going to be equal to the number of Worker
+     * @param configuration The optional settings, see ControllerConfiguration
      */
     WorkerController(std::unique_ptr<Worker<T, R>> prototypeWorker, std::unique_ptr<Processor<T, R>> processor,
-                           const std::size_t numberOfThreads)
-            : QObject(nullptr), prototypeWorker(std::move(prototypeWorker)), processor(processor.get()) {
-        // setup the processor
-        this->processor->moveToThread(&this->processorThread);
-        this->processor->setupConnections(
+                           const std::size_t numberOfThreads, const ControllerConfiguration<T, R> &configuration)
+            : QObject(nullptr), prototypeWorker(std::move(prototypeWorker)), processor(processor.get()),
+              configuration(configuration), metrics(configuration.memoryBudget),
+              tasks(configuration.spillMemoryBudget, configuration.spillDirectory, configuration.spillChunkSize,
+                    configuration.taskSize),
+              scheduledTasks(configuration.schedulerTick),
+              autoTuner(configuration.autoTuningMaxBatchSize, configuration.autoTuningDrift),
+              dispatchBatchSize(std::max<std::size_t>(configuration.dispatchBatchSize, 1)) {
+        this->metrics.tunedBatchSize = this->dispatchBatchSize;
+
+        // clone the shards before the processor is running in its own thread
+        std::vector<std::unique_ptr<Processor<T, R>>> shards;
+        for (std::size_t shardIndex = 1; shardIndex < configuration.processorShards; ++shardIndex) {
+            std::unique_ptr<Processor<T, R>> shard = processor->clone();
+            if (!shard) {
+                qWarning("WorkerController: the Processor cannot be cloned, using less shards");
+                break;
+            }
+            shard->shard = shardIndex;
+            shards.push_back(std::move(shard));
+        }
+
+        // setup the processor and its shards
+        this->startProcessor(std::move(processor), this->processorThread);
+        for (std::unique_ptr<Processor<T, R>> &shard : shards) {
+            this->processorShardThreads.push_back(std::make_unique<QThread>());
+            this->startProcessor(std::move(shard), *this->processorShardThreads.back());
+        }
+
+        // setup threads/workers
+        this->setNumberOfThreads(numberOfThreads);
+    }
+
+    /**
+     * Moves a Processor or one of its shards to its thread, sets up its connections and starts the thread
+     *
+     * @param newProcessor The Processor to start, which is deleted once \p thread finished
+     * @param thread The thread to run \p newProcessor in
+     */
+    inline void startProcessor(std::unique_ptr<Processor<T, R>> newProcessor, QThread &thread) {
+        newProcessor->moveToThread(&thread);
+        newProcessor->setupConnections(
                 static_cast<QObject *>(this), this,
                 &WorkerController<T, R>::setNumberOfThreads,
                 &WorkerController<T, R>::clearQueue,
-                &WorkerController<T, R>::extendQueue
+                &WorkerController<T, R>::extendQueue,
+                &WorkerController<T, R>::collectReduction,
+                &this->configuration, &this->metrics
         );
+        this->processors.push_back(newProcessor.get());
+        this->resultInboxes.push_back(std::make_unique<ResultInbox<R>>());
         // start thread and connect deleteLater
-        this->processorThread.start();
-        QObject::connect(&this->processorThread, &QThread::finished, processor.release(), &QObject::deleteLater);
-
-        // setup threads/workers
-        this->setNumberOfThreads(numberOfThreads);
+        thread.start();
+        QObject::connect(&thread, &QThread::finished, newProcessor.release(), &QObject::deleteLater);
     }
 
     /**
@@ -100,57 +245,65 @@ private:
      */
     inline void setNumberOfThreads(const std::size_t &numberOfThreads) {
         const std::size_t currentNumberOfThreads = this->threads.size();
+        this->targetNumberOfThreads = this->isInDestructor ? 0 : numberOfThreads;
+
+        // the best setting depends on the number of threads, so tune again
+        if (this->configuration.autoTuning && this->targetNumberOfThreads) {
+            this->autoTuner.restart(this->targetNumberOfThreads);
+            this->applyTuning(this->autoTuner.setting());
+        }
 
         // special case setting number of threads to zero
         // blindly stop, remove and reset everything
         if (numberOfThreads == 0) {
+            for (std::size_t threadIndex = 0; threadIndex < this->threads.size(); ++threadIndex) {
+                this->retireReducer(threadIndex);
+            }
             for (auto &threadTuple : this->threads) {
                 std::get<0>(threadTuple)->quit();
             }
             for (auto &threadTuple : this->threads) {
                 std::get<0>(threadTuple)->wait();
             }
+            for (std::size_t threadIndex = 0; threadIndex < this->threads.size(); ++threadIndex) {
+                this->releaseInFlightTask(threadIndex);
+                this->closeResultChannels(threadIndex);
+            }
             this->threads.clear();
             this->threads.shrink_to_fit();
+            this->inFlightTasks.clear();
+            this->inFlightTasks.shrink_to_fit();
+            this->resultChannels.clear();
+            this->resultChannels.shrink_to_fit();
             this->workersReady.clear();
+            this->metrics.removeWorkerUsage(0);
         } else if (numberOfThreads < currentNumberOfThreads) {
             for (std::size_t currentThreadIndex = currentNumberOfThreads - 1;
                  currentThreadIndex >= numberOfThreads; --currentThreadIndex) {
-                // stop threads, which also kills the workers
+                // keep the folded results, then stop threads, which also kills the workers
+                this->retireReducer(currentThreadIndex);
                 std::get<0>(this->threads[currentThreadIndex])->quit();
                 std::get<0>(this->threads[currentThreadIndex])->wait();
 
+                // the task the worker may have been fulfilling is lost
+                this->releaseInFlightTask(currentThreadIndex);
+                this->closeResultChannels(currentThreadIndex);
+
                 // remove thread from vector and set
                 this->threads.pop_back();
+                this->inFlightTasks.pop_back();
+                this->resultChannels.pop_back();
                 this->workersReady.erase(currentThreadIndex);
             }
             // we are not wasting memory!!!
             this->threads.shrink_to_fit();
+            this->inFlightTasks.shrink_to_fit();
+            this->resultChannels.shrink_to_fit();
+            this->metrics.removeWorkerUsage(numberOfThreads);
         } else if (!this->isInDestructor && numberOfThreads > currentNumberOfThreads) {
-            for (std::size_t currentThreadIndex = currentNumberOfThreads;
-                 currentThreadIndex < numberOfThreads; ++currentThreadIndex) {
-                // clone prototype worker
-                std::unique_ptr<Worker<T, R>> newWorker = this->prototypeWorker->clone();
-
-                // create new thread for the worker
-                this->threads.emplace_back(
-                        std::make_unique<QThread>(), newWorker.get(), QUuid(newWorker->uniqueWorkerUUID)
-                );
-                this->workersReady.insert(currentThreadIndex);
-
-                // setup connections for new worker
-                QThread &newThread = *std::get<0>(this->threads.back());
-                newWorker->moveToThread(&newThread);
-                newWorker->setupConnections(
-                        currentThreadIndex + 1,
-                        static_cast<QObject *>(this), this, static_cast<QObject *>(this->processor), this->processor,
-                        &WorkerController<T, R>::workerFinished,
-                        &Processor<T, R>::receiveResult
-                );
-
-                // start thread and connect deleteLater
-                newThread.start();
-                QObject::connect(&newThread, &QThread::finished, newWorker.release(), &QObject::deleteLater);
+            // with lazy worker start, the workers are started by checkTasks() once there are tasks for them
+            if (!this->configuration.lazyWorkerStart) {
+                this->startWorkers(numberOfThreads - currentNumberOfThreads);
             }
 
             // check if new tasks may be given to workers
@@ -158,6 +311,109 @@ private:
         }
     }
 
+    /**
+     * Starts Worker, by cloning the prototype Worker, until the given number of Worker are running,
+     * but never more than WorkerController::targetNumberOfThreads. \n
+     * Called on behalf of Controller::preWarm().
+     *
+     * @param numberOfThreads The number of threads to run at least
+     */
+    inline void preWarm(const std::size_t &numberOfThreads) {
+        const std::size_t toRun = std::min(numberOfThreads, this->targetNumberOfThreads);
+
+        if (toRun > this->threads.size()) {
+            this->startWorkers(toRun - this->threads.size());
+            this->checkTasks();
+        }
+    }
+
+    /**
+     * Creates the backend for remote Worker, see ControllerConfiguration::remoteWorkers. \n
+     * Called by the Controller in the thread of the WorkerController, so that the backend lives in that thread, too.
+     */
+    inline void startRemoteWorkers() {
+        if (this->isInDestructor || this->remoteWorkers || !this->configuration.remoteWorkers) {
+            return;
+        }
+
+        this->remoteWorkers = this->configuration.remoteWorkers();
+        this->remoteWorkers->setupConnections(
+                this,
+                &WorkerController<T, R>::remoteTaskFinished,
+                &WorkerController<T, R>::remoteTasksLost
+        );
+        if (!this->remoteWorkers->start()) {
+            qWarning("WorkerController: the remote workers cannot be started");
+        }
+    }
+
+    /**
+     * Returns where remote Worker have to connect to, see Controller::remoteWorkersAddress()
+     *
+     * @param address Set to the address of the backend, empty without ControllerConfiguration::remoteWorkers
+     */
+    inline void remoteWorkersAddress(QString &address) {
+        address = this->remoteWorkers ? this->remoteWorkers->address() : QString();
+    }
+
+    /**
+     * Starts new Worker, by cloning the prototype Worker, each in its own thread
+     *
+     * @param numberOfWorkers The number of Worker to start
+     */
+    inline void startWorkers(const std::size_t numberOfWorkers) {
+        if (this->isInDestructor) {
+            return;
+        }
+
+        const std::size_t currentNumberOfThreads = this->threads.size();
+        for (std::size_t currentThreadIndex = currentNumberOfThreads;
+             currentThreadIndex < currentNumberOfThreads + numberOfWorkers; ++currentThreadIndex) {
+            // clone prototype worker
+            std::unique_ptr<Worker<T, R>> newWorker = this->prototypeWorker->clone();
+
+            // create new thread for the worker
+            this->threads.emplace_back(
+                    std::make_unique<QThread>(), newWorker.get(), QUuid(newWorker->uniqueWorkerUUID)
+            );
+            this->inFlightTasks.emplace_back();
+            this->workersReady.insert(currentThreadIndex);
+
+            // setup connections for new worker
+            QThread &newThread = *std::get<0>(this->threads.back());
+            newWorker->moveToThread(&newThread);
+            // without ControllerConfiguration::resultShardKey, every Worker sends its results to one shard
+            const std::size_t shard = currentThreadIndex % this->processors.size();
+            newWorker->processorShard = shard;
+            if (this->usesResultChannels()) {
+                // with ControllerConfiguration::resultShardKey, every Worker may send results to every shard
+                newWorker->resultChannels.resize(this->processors.size());
+                for (std::size_t channelShard = 0; channelShard < this->processors.size(); ++channelShard) {
+                    if (this->configuration.resultShardKey || channelShard == shard) {
+                        newWorker->resultChannels[channelShard] =
+                                this->resultInboxes[channelShard]->open(this->configuration.resultChannelSegmentSize);
+                    }
+                }
+            }
+            this->resultChannels.push_back(newWorker->resultChannels);
+            newWorker->setupConnections(
+                    currentThreadIndex + 1,
+                    static_cast<QObject *>(this), this,
+                    static_cast<QObject *>(this->processors[shard]), this->processors[shard], &this->processors,
+                    &WorkerController<T, R>::workerFinished,
+                    &WorkerController<T, R>::reducerReceived,
+                    &Processor<T, R>::resultReceived,
+                    &Processor<T, R>::resultsReceived,
+                    &Processor<T, R>::resultsAvailable,
+                    &this->configuration, &this->metrics
+            );
+
+            // start thread and connect deleteLater
+            newThread.start();
+            QObject::connect(&newThread, &QThread::finished, newWorker.release(), &QObject::deleteLater);
+        }
+    }
+
     /**
      * Clears the queue containing the tasks to be sent to Worker
      */
@@ -165,48 +421,903 @@ private:
         if (!this->isInDestructor) {
             this->tasks.clear();
             this->tasks.shrink_to_fit();
+            this->deprioritizedTasks.clear();
+            this->deprioritizedTasks.shrink_to_fit();
+            this->deprioritizedBytes = 0;
+            this->reassignedTasks.clear();
+            this->reassignedTasks.shrink_to_fit();
+            this->reassignedBytes = 0;
+            this->updateQueueMetrics();
         }
     }
 
     /**
-     * Extends the queue with tasks for Worker with new tasks
+     * Extends the queue with tasks for Worker with new tasks. \n
+     * With ControllerConfiguration::queueWaitTarget, tasks are only admitted as long as their estimated queue wait
+     * does not exceed the target, the remaining tasks are deprioritized or rejected. \n
+     * With ControllerConfiguration::memoryBudget, tasks not fitting into the budget any more are rejected,
+     * regardless of the admission policy, unless nothing has been accounted before this batch.
      *
      * @param newTasks The queue containing the new tasks
+     * @param admission Set to the number of admitted, deprioritized and rejected tasks
      */
-    inline void extendQueue(const std::deque<T> &newTasks) {
+    inline void extendQueue(const std::deque<T> &newTasks, AdmissionResult &admission) {
+        admission = AdmissionResult();
         if (!this->isInDestructor) {
-            this->tasks.insert(this->tasks.cend(), newTasks.begin(), newTasks.end());
+            // like Processor::extendQueue(), a batch larger than the budget on its own is accepted
+            const bool budgeted = this->configuration.memoryBudget && this->metrics.accountedBytes();
+            std::size_t addedBytes = 0;
+            for (const T &newTask : newTasks) {
+                // the size is only needed for the budget or the low priority queue
+                const bool measured = budgeted || this->configuration.admissionPolicy == AdmissionPolicy::Deprioritize;
+                const std::size_t taskBytes = measured ? this->configuration.sizeOfTask(newTask) : 0;
+                // the tasks are admitted in order, once a task is rejected, the following ones are as well
+                if (this->isShuttingDown || admission.rejected ||
+                    (budgeted && !this->metrics.fitsMemoryBudget(taskBytes, addedBytes))) {
+                    ++admission.rejected;
+                } else if (!admission.deprioritized && this->admits()) {
+                    this->recorder.recordSubmission(this->nextTaskId++, newTask);
+                    this->tasks.push_back(newTask);
+                    addedBytes += taskBytes;
+                    ++admission.admitted;
+                } else if (this->configuration.admissionPolicy == AdmissionPolicy::Deprioritize) {
+                    this->deprioritizedBytes += taskBytes;
+                    this->deprioritizedTasks.push_back(newTask);
+                    addedBytes += taskBytes;
+                    ++admission.deprioritized;
+                } else {
+                    ++admission.rejected;
+                }
+            }
+            this->metrics.rejectedTasks.fetch_add(admission.rejected, std::memory_order_relaxed);
+            this->updateQueueMetrics();
             checkTasks();
         }
     }
 
+    /**
+     * Extends the queue with tasks flushed by a TaskSubmitter, see extendQueue(). \n
+     * Releases the bytes the TaskSubmitter accounted for the tasks while they were on their way, see
+     * Metrics::submittedBytes, before they are counted as queued.
+     *
+     * @param newTasks The queue containing the new tasks
+     * @param submittedBytes The number of bytes accounted for \p newTasks by the TaskSubmitter
+     * @param tally The outcomes of the batches of the TaskSubmitter, to which the outcome of \p newTasks is added
+     */
+    inline void submitQueue(const std::deque<T> &newTasks, const std::size_t &submittedBytes,
+                            const std::shared_ptr<AdmissionTally> &tally) {
+        this->metrics.submittedBytes.fetch_sub(submittedBytes, std::memory_order_relaxed);
+        AdmissionResult admission;
+        this->extendQueue(newTasks, admission);
+        tally->add(admission);
+    }
+
+    /**
+     * Schedules a task to be given to the queue at a given time, called on behalf of Controller::scheduleAt() and
+     * Controller::scheduleEvery()
+     *
+     * @param task The task to schedule
+     * @param due The time the task is given to the queue at
+     * @param period If not zero, a copy of the task is given to the queue every \p period after \p due
+     * @param id Set to the id used to cancel the scheduled task, 0 when in the destructor
+     */
+    inline void scheduleTask(const T &task, const std::chrono::steady_clock::time_point &due,
+                             const std::chrono::nanoseconds &period, TimerId &id) {
+        id = 0;
+        if (this->isInDestructor) {
+            return;
+        }
+        id = this->scheduledTasks.schedule(due, task, period);
+        this->metrics.scheduledTasks.store(this->scheduledTasks.size(), std::memory_order_relaxed);
+        this->armSchedulerTimer();
+    }
+
+    /**
+     * Cancels a scheduled task, called on behalf of Controller::cancelScheduled()
+     *
+     * @param id The id returned when scheduling the task
+     * @param cancelled Set to \p true if the task has been waiting for its time, \p false otherwise
+     */
+    inline void cancelScheduledTask(const TimerId &id, bool &cancelled) {
+        cancelled = this->scheduledTasks.cancel(id);
+        this->metrics.scheduledTasks.store(this->scheduledTasks.size(), std::memory_order_relaxed);
+        // the timer is re-armed when it fires, at most once for a cancelled task
+    }
+
+    /**
+     * Gives the scheduled tasks whose time has come to the queue, called by WorkerController::schedulerTimer
+     */
+    inline void releaseScheduledTasks() {
+        std::deque<T> dueTasks;
+        this->scheduledTasks.advance(std::chrono::steady_clock::now(), [&dueTasks](T &task) -> void {
+            dueTasks.push_back(task);
+        });
+        this->metrics.scheduledTasks.store(this->scheduledTasks.size(), std::memory_order_relaxed);
+        if (!dueTasks.empty()) {
+            // scheduled tasks are subject to the admission control like any other task
+            AdmissionResult admission;
+            this->extendQueue(dueTasks, admission);
+        }
+        this->armSchedulerTimer();
+    }
+
+    /**
+     * Starts WorkerController::schedulerTimer for the next scheduled task, if any
+     */
+    inline void armSchedulerTimer() {
+        const std::optional<std::chrono::steady_clock::time_point> nextAdvance = this->scheduledTasks.nextAdvance();
+        if (!nextAdvance || this->isInDestructor) {
+            if (this->schedulerTimer) {
+                this->schedulerTimer->stop();
+            }
+            return;
+        }
+
+        if (!this->schedulerTimer) {
+            // created on first use, so that it lives in the thread of the WorkerController
+            this->schedulerTimer = new QTimer(this);
+            this->schedulerTimer->setSingleShot(true);
+            this->schedulerTimer->setTimerType(Qt::PreciseTimer);
+            this->schedulerTimer->callOnTimeout([this]() -> void { this->releaseScheduledTasks(); });
+        }
+        const auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+                *nextAdvance - std::chrono::steady_clock::now()
+        );
+        this->schedulerTimer->start(static_cast<int>(std::clamp<std::int64_t>(
+                wait.count(), 0, std::numeric_limits<int>::max()
+        )));
+    }
+
+    /**
+     * Returns, whether a new task is admitted to the queue, see ControllerConfiguration::queueWaitTarget
+     *
+     * @return \p true if the estimated queue wait of a new task does not exceed the target, \p false otherwise
+     */
+    [[nodiscard]] inline bool admits() const {
+        return !this->configuration.queueWaitTarget.count() ||
+               this->estimateQueueWait() <= this->configuration.queueWaitTarget;
+    }
+
+    /**
+     * Estimates the queue wait of a new task, see QueueWaitEstimator
+     *
+     * @return The estimated time until a new task is sent to a Worker
+     */
+    [[nodiscard]] inline std::chrono::nanoseconds estimateQueueWait() const {
+        // Worker not started yet due to lazy worker start are ready as soon as they are needed
+        return this->queueWait.estimate(
+                this->numberOfQueuedTasks(), this->workersReady.size() + this->targetNumberOfThreads -
+                                    std::min(this->threads.size(), this->targetNumberOfThreads),
+                this->targetNumberOfThreads
+        );
+    }
+
     /**
      * Checks if new tasks have to be given to the Worker, and does it, if needed.
      */
     inline void checkTasks() {
-        for (auto threadIndex = this->workersReady.begin();
-             !this->tasks.empty() && threadIndex != this->workersReady.end();) {
-            // send new task to worker
-            invokeInContext(
-                    static_cast<QObject *>(std::get<1>(this->threads[*threadIndex])), Qt::QueuedConnection,
-                    &Worker<T, R>::receiveTask,
-                    std::get<1>(this->threads[*threadIndex]), this->tasks.front()
+        // no new tasks are started once the Controller is shutting down
+        if (this->isShuttingDown) {
+            return;
+        }
+
+        // spilled tasks, whose file could not be read before, are read again
+        this->tasks.retryRefill();
+
+        // deprioritized tasks only get Worker, which would be idle otherwise
+        if (!this->hasQueuedTasks() && !this->deprioritizedTasks.empty()) {
+            const std::size_t idleWorkers = this->workersReady.size() + this->targetNumberOfThreads -
+                                            std::min(this->threads.size(), this->targetNumberOfThreads) +
+                                            (this->remoteWorkers ? this->remoteWorkers->capacity() : 0);
+            for (std::size_t promoted = 0; promoted < idleWorkers && !this->deprioritizedTasks.empty(); ++promoted) {
+                // recorded only now, so that the ids of the tasks in the queue stay consecutive
+                this->recorder.recordSubmission(this->nextTaskId++, this->deprioritizedTasks.front());
+                this->deprioritizedBytes -= this->configuration.sizeOfTask(this->deprioritizedTasks.front());
+                this->tasks.push_back(std::move(this->deprioritizedTasks.front()));
+                this->deprioritizedTasks.pop_front();
+            }
+        }
+
+        // start as many Worker as there are tasks waiting for a ready Worker, as long as allowed
+        const std::size_t usableThreads = std::min(this->targetNumberOfThreads, this->activeWorkers);
+        if (this->configuration.lazyWorkerStart && this->numberOfQueuedTasks() > this->workersReady.size() &&
+            this->threads.size() < usableThreads) {
+            this->startWorkers(std::min(this->numberOfQueuedTasks() - this->workersReady.size(),
+                                        usableThreads - this->threads.size()));
+        }
+
+        // the Worker parked by the AutoTuner are not given any tasks
+        const auto activeEnd = this->workersReady.lower_bound(this->activeWorkers);
+        std::size_t readyWorkers = static_cast<std::size_t>(std::distance(this->workersReady.begin(), activeEnd));
+        for (auto threadIndex = this->workersReady.begin(); this->hasQueuedTasks() && threadIndex != activeEnd;) {
+            // spread the queue evenly over the ready Worker, a duplicate needs its own claim per task
+            const std::size_t batchSize = this->configuration.hedging ? 1 : std::clamp<std::size_t>(
+                    (this->numberOfQueuedTasks() + readyWorkers - 1) / readyWorkers, 1, this->dispatchBatchSize
             );
-            // remove task from queue
-            this->tasks.pop_front();
+            --readyWorkers;
+
+            std::uint64_t taskId = 0;
+            T task = this->takeTask(taskId);
+            // account the task as in-flight until the worker is done with it
+            const std::size_t taskBytes = this->configuration.sizeOfTask(task);
+            this->inFlightTasks[*threadIndex].bytes = taskBytes;
+            this->inFlightTasks[*threadIndex].id = taskId;
+            this->inFlightTasks[*threadIndex].dispatched = std::chrono::steady_clock::now();
+            this->metrics.inFlightTasks.fetch_add(1, std::memory_order_relaxed);
+            this->metrics.inFlightTaskBytes.fetch_add(taskBytes, std::memory_order_relaxed);
+            // keep a copy of the task, in case a duplicate is needed
+            if (this->configuration.hedging) {
+                this->inFlightTasks[*threadIndex].claim = std::make_shared<TaskClaim>();
+                this->hedgeableTasks.insert_or_assign(*threadIndex, task);
+            }
+
+            if (batchSize > 1 && this->hasQueuedTasks()) {
+                // the tasks following the first one are accounted as in-flight, too
+                std::vector<T> batch;
+                batch.reserve(batchSize);
+                batch.push_back(std::move(task));
+                while (batch.size() < batchSize && this->hasQueuedTasks()) {
+                    batch.push_back(this->takeTask(taskId));
+                    const std::size_t batchedBytes = this->configuration.sizeOfTask(batch.back());
+                    this->inFlightTasks[*threadIndex].batched.emplace_back(taskId, batchedBytes);
+                    this->metrics.inFlightTasks.fetch_add(1, std::memory_order_relaxed);
+                    this->metrics.inFlightTaskBytes.fetch_add(batchedBytes, std::memory_order_relaxed);
+                }
+                // send the batch of new tasks to worker
+                invokeInContext(
+                        static_cast<QObject *>(std::get<1>(this->threads[*threadIndex])), Qt::QueuedConnection,
+                        &Worker<T, R>::receiveTasks,
+                        std::get<1>(this->threads[*threadIndex]), batch
+                );
+            } else {
+                // send new task to worker
+                invokeInContext(
+                        static_cast<QObject *>(std::get<1>(this->threads[*threadIndex])), Qt::QueuedConnection,
+                        &Worker<T, R>::receiveTask,
+                        std::get<1>(this->threads[*threadIndex]), task, this->inFlightTasks[*threadIndex].claim
+                );
+            }
             // mark worker as fulfilling a task
             threadIndex = this->workersReady.erase(threadIndex);
         }
+        // a round of the AutoTuner only measures the throughput, if the Worker never ran out of tasks
+        if (!this->hasQueuedTasks() && this->workersReady.begin() != activeEnd) {
+            this->roundStarved = true;
+        }
+        if (this->configuration.autoTuning && !this->autoTuningTimer && this->hasQueuedTasks() &&
+            !this->isInDestructor) {
+            this->startAutoTuning();
+        }
+        this->sendRemoteTasks();
+        this->hedgeTasks();
+        this->updateQueueMetrics();
+    }
+
+    /**
+     * Returns, whether there are tasks waiting for a Worker, not counting the deprioritized ones
+     *
+     * @return \p true if WorkerController::tasks or WorkerController::reassignedTasks are not empty
+     */
+    [[nodiscard]] inline bool hasQueuedTasks() const {
+        return !this->tasks.empty() || !this->reassignedTasks.empty();
+    }
+
+    /**
+     * Returns the number of tasks waiting for a Worker, not counting the deprioritized ones
+     *
+     * @return The number of tasks in WorkerController::tasks and WorkerController::reassignedTasks
+     */
+    [[nodiscard]] inline std::size_t numberOfQueuedTasks() const {
+        return this->tasks.size() + this->reassignedTasks.size();
+    }
+
+    /**
+     * Takes the next task to send to a Worker, the tasks of lost remote Worker come first
+     *
+     * @param id Set to the id of the task
+     * @return The task, only to be called if hasQueuedTasks()
+     */
+    inline T takeTask(std::uint64_t &id) {
+        if (!this->reassignedTasks.empty()) {
+            RemoteTask<T> reassigned = std::move(this->reassignedTasks.front());
+            this->reassignedTasks.pop_front();
+            this->reassignedBytes -= reassigned.bytes;
+            id = reassigned.id;
+            return std::move(reassigned.task);
+        }
+
+        // take task from queue, which accounts its size before moving it out
+        T task = this->tasks.pop_front();
+        // the queue is FIFO, so the id of the task follows from the number of tasks behind it
+        id = this->nextTaskId - this->tasks.size() - 1;
+        return task;
+    }
+
+    /**
+     * Sends the tasks no local Worker is ready for to remote Worker, as long as they have capacity,
+     * see ControllerConfiguration::remoteWorkers
+     */
+    inline void sendRemoteTasks() {
+        if (!this->remoteWorkers || this->isInDestructor) {
+            return;
+        }
+
+        bool sent = false;
+        while (this->hasQueuedTasks() && this->remoteWorkers->capacity()) {
+            std::uint64_t taskId = 0;
+            T task = this->takeTask(taskId);
+            const std::size_t taskBytes = this->configuration.sizeOfTask(task);
+            RemoteTask<T> remoteTask{taskId, std::move(task), taskBytes, std::chrono::steady_clock::now()};
+            // account the task as in-flight until the results arrived or the connection is lost
+            this->metrics.inFlightTasks.fetch_add(1, std::memory_order_relaxed);
+            this->metrics.inFlightTaskBytes.fetch_add(taskBytes, std::memory_order_relaxed);
+            this->remoteWorkers->send(remoteTask);
+            sent = true;
+        }
+        // the tasks of one call are sent together
+        if (sent) {
+            this->remoteWorkers->flush();
+        }
+    }
+
+    /**
+     * Received, when a remote Worker has fulfilled a task, see RemoteWorkers::taskFinished()
+     *
+     * @param task The task as sent by sendRemoteTasks()
+     * @param results The results of the task, which are handed to the Processor
+     * @param fulfillDuration The wall time the remote Worker spent fulfilling the task
+     */
+    inline void remoteTaskFinished(RemoteTask<T> &task, std::vector<R> &results,
+                                   const std::chrono::nanoseconds &fulfillDuration) {
+        this->metrics.inFlightTasks.fetch_sub(1, std::memory_order_relaxed);
+        this->metrics.inFlightTaskBytes.fetch_sub(task.bytes, std::memory_order_relaxed);
+        this->metrics.releasedBytes();
+        this->metrics.completedTasks.fetch_add(1, std::memory_order_relaxed);
+        this->recorder.recordCompletion(
+                task.id, task.dispatched, fulfillDuration, this->threads.size() + task.connection
+        );
+        this->deliverRemoteResults(task.id, results);
+        if (!this->isInDestructor) {
+            this->checkTasks();
+        }
+    }
+
+    /**
+     * Received, when the tasks sent to a remote Worker are not going to be fulfilled, see RemoteWorkers::tasksLost().
+     * \n
+     * The tasks keep their ids and are sent to the next ready Worker before the tasks of the queue.
+     *
+     * @param lostTasks The tasks to give to other Worker, which is cleared
+     */
+    inline void remoteTasksLost(std::vector<RemoteTask<T>> &lostTasks) {
+        for (RemoteTask<T> &lostTask : lostTasks) {
+            this->metrics.inFlightTasks.fetch_sub(1, std::memory_order_relaxed);
+            this->metrics.inFlightTaskBytes.fetch_sub(lostTask.bytes, std::memory_order_relaxed);
+            this->reassignedBytes += lostTask.bytes;
+            this->reassignedTasks.push_back(std::move(lostTask));
+        }
+        this->metrics.reassignedTasks.fetch_add(lostTasks.size(), std::memory_order_relaxed);
+        lostTasks.clear();
+        if (!this->isInDestructor) {
+            this->checkTasks();
+        }
+    }
+
+    /**
+     * Hands the results of a task fulfilled by a remote Worker to the Processor, or its shards
+     *
+     * @param taskId The id of the task, which selects the shard without ControllerConfiguration::resultShardKey
+     * @param results The results of the task, which are moved from
+     */
+    inline void deliverRemoteResults(const std::uint64_t taskId, std::vector<R> &results) {
+        if (this->isInDestructor || results.empty()) {
+            return;
+        }
+
+        // folded like the results of a stopped Worker, see collectReduction()
+        if (this->configuration.resultReducer) {
+            if (!this->retiredReducer) {
+                this->retiredReducer = this->configuration.resultReducer->clone();
+            }
+            for (R &result : results) {
+                this->retiredReducer->fold(result);
+            }
+            return;
+        }
+
+        std::vector<std::vector<R>> shardResults(this->processors.size());
+        for (R &result : results) {
+            const std::size_t shard = this->configuration.resultShardKey
+                                      ? this->configuration.resultShardKey(result) % this->processors.size()
+                                      : taskId % this->processors.size();
+            shardResults[shard].push_back(std::move(result));
+        }
+        for (std::size_t shard = 0; shard < shardResults.size(); ++shard) {
+            if (shardResults[shard].empty()) {
+                continue;
+            }
+            // account the results until the Processor received them
+            std::size_t resultBytes = 0;
+            for (const R &result : shardResults[shard]) {
+                resultBytes += this->configuration.sizeOfResult(result);
+            }
+            this->metrics.pendingResults.fetch_add(shardResults[shard].size(), std::memory_order_relaxed);
+            this->metrics.pendingResultBytes.fetch_add(resultBytes, std::memory_order_relaxed);
+            invokeInContext(
+                    static_cast<QObject *>(this->processors[shard]), Qt::QueuedConnection,
+                    &Processor<T, R>::resultsReceived,
+                    this->processors[shard], shardResults[shard], resultBytes
+            );
+        }
+    }
+
+    /**
+     * Sends duplicates of the tasks running longer than ControllerConfiguration::hedgingPercentile of the recent
+     * execution times to Worker, which would be idle otherwise, see ControllerConfiguration::hedging. \n
+     * Checks again, once the next task is going to exceed the percentile, as long as there are idle Worker.
+     */
+    inline void hedgeTasks() {
+        if (!this->configuration.hedging || this->isInDestructor || this->isShuttingDown ||
+            this->hasQueuedTasks() || !this->deprioritizedTasks.empty() || this->workersReady.empty()) {
+            return;
+        }
+        const std::chrono::nanoseconds threshold = this->executionTimes.percentile(
+                this->configuration.hedgingPercentile
+        );
+        if (threshold == std::chrono::nanoseconds::max()) {
+            return;
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::chrono::nanoseconds nextCheck = std::chrono::nanoseconds::max();
+        for (const auto &[threadIndex, task] : this->hedgeableTasks) {
+            InFlightTask &original = this->inFlightTasks[threadIndex];
+            if (original.hedged) {
+                continue;
+            }
+            const std::chrono::nanoseconds age = now - original.dispatched;
+            if (age < threshold) {
+                nextCheck = std::min(nextCheck, threshold - age);
+                continue;
+            }
+            if (this->workersReady.empty()) {
+                break;
+            }
+
+            // the duplicate shares the id and the claim of the original task
+            const std::size_t hedgeIndex = *this->workersReady.begin();
+            this->workersReady.erase(this->workersReady.begin());
+            original.hedged = true;
+            InFlightTask &duplicate = this->inFlightTasks[hedgeIndex];
+            duplicate.bytes = this->configuration.sizeOfTask(task);
+            duplicate.id = original.id;
+            duplicate.dispatched = now;
+            duplicate.claim = original.claim;
+            duplicate.duplicate = true;
+            this->metrics.inFlightTasks.fetch_add(1, std::memory_order_relaxed);
+            this->metrics.inFlightTaskBytes.fetch_add(duplicate.bytes, std::memory_order_relaxed);
+            this->metrics.hedgedTasks.fetch_add(1, std::memory_order_relaxed);
+            T duplicateTask = task;
+            invokeInContext(
+                    static_cast<QObject *>(std::get<1>(this->threads[hedgeIndex])), Qt::QueuedConnection,
+                    &Worker<T, R>::receiveTask,
+                    std::get<1>(this->threads[hedgeIndex]), duplicateTask, duplicate.claim
+            );
+        }
+
+        if (nextCheck != std::chrono::nanoseconds::max() && !this->workersReady.empty() && !this->hedgeCheckScheduled) {
+            this->hedgeCheckScheduled = true;
+            QTimer::singleShot(
+                    static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(nextCheck).count()), this,
+                    [this]() -> void {
+                        this->hedgeCheckScheduled = false;
+                        this->hedgeTasks();
+                    }
+            );
+        }
+    }
+
+    /**
+     * Releases the memory accounted for the task the Worker with the given index is fulfilling, if any
+     *
+     * @param threadIndex The index of the Worker in WorkerController::threads
+     */
+    inline void releaseInFlightTask(const std::size_t threadIndex) {
+        if (this->workersReady.count(threadIndex)) {
+            return;
+        }
+        this->metrics.inFlightTasks.fetch_sub(1, std::memory_order_relaxed);
+        this->metrics.inFlightTaskBytes.fetch_sub(this->inFlightTasks[threadIndex].bytes, std::memory_order_relaxed);
+        // the rest of the batch is lost as well
+        for (const auto &[taskId, taskBytes] : this->inFlightTasks[threadIndex].batched) {
+            this->metrics.inFlightTasks.fetch_sub(1, std::memory_order_relaxed);
+            this->metrics.inFlightTaskBytes.fetch_sub(taskBytes, std::memory_order_relaxed);
+        }
+        this->metrics.releasedBytes();
+        this->inFlightTasks[threadIndex] = InFlightTask();
+        this->hedgeableTasks.erase(threadIndex);
+    }
+
+    /**
+     * Starts the rounds of the AutoTuner, see ControllerConfiguration::autoTuning. \n
+     * Called once there are tasks, so that the timer is created in the thread of the WorkerController.
+     */
+    inline void startAutoTuning() {
+        this->autoTuningTimer = new QTimer(this);
+        this->autoTuningTimer->setTimerType(Qt::PreciseTimer);
+        this->autoTuningTimer->callOnTimeout([this]() -> void { this->tuneRound(); });
+        this->autoTuningTimer->start(static_cast<int>(std::max<std::int64_t>(
+                std::chrono::ceil<std::chrono::milliseconds>(this->configuration.autoTuningRound).count(), 1
+        )));
+        this->roundCompletedTasks = 0;
+        this->roundExecutionTime = std::chrono::nanoseconds(0);
+        this->roundStarved = false;
+        this->roundStart = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * Ends a round of the AutoTuner and uses the setting chosen for the next one
+     */
+    inline void tuneRound() {
+        if (this->isInDestructor || !this->targetNumberOfThreads) {
+            return;
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const TuningSetting setting = this->autoTuner.round(
+                this->roundCompletedTasks, now - this->roundStart, !this->roundStarved && this->hasQueuedTasks(),
+                this->roundExecutionTime / std::max<std::int64_t>(
+                        static_cast<std::int64_t>(this->roundCompletedTasks), 1
+                )
+        );
+        this->roundCompletedTasks = 0;
+        this->roundExecutionTime = std::chrono::nanoseconds(0);
+        this->roundStarved = false;
+        this->roundStart = now;
+
+        this->applyTuning(setting);
+        this->checkTasks();
+    }
+
+    /**
+     * Uses a setting of the AutoTuner for the next tasks, the tasks already sent are not affected
+     *
+     * @param setting The setting to use
+     */
+    inline void applyTuning(const TuningSetting &setting) {
+        this->activeWorkers = setting.workers;
+        this->dispatchBatchSize = setting.batchSize;
+        this->metrics.tunedWorkers = setting.workers;
+        this->metrics.tunedBatchSize = setting.batchSize;
+        this->metrics.tuningCalibrations = this->autoTuner.numberOfCalibrations();
+    }
+
+    /**
+     * Closes the ResultChannel of a stopped Worker, which are removed once the Processor drained them
+     *
+     * @param threadIndex The index of the Worker in WorkerController::threads
+     */
+    inline void closeResultChannels(const std::size_t threadIndex) {
+        for (std::size_t shard = 0; shard < this->resultChannels[threadIndex].size(); ++shard) {
+            if (!this->resultChannels[threadIndex][shard]) {
+                continue;
+            }
+            ResultInbox<R>::close(*this->resultChannels[threadIndex][shard]);
+            // let the Processor remove the channel, once it is drained
+            ResultInbox<R> *inbox = this->resultInboxes[shard].get();
+            if (!this->isInDestructor && inbox->notify()) {
+                invokeInContext(
+                        static_cast<QObject *>(this->processors[shard]), Qt::QueuedConnection,
+                        &Processor<T, R>::resultsAvailable,
+                        this->processors[shard], inbox
+                );
+            }
+        }
+    }
+
+    /**
+     * Returns, whether the Worker send their results via ResultChannel, see ControllerConfiguration::resultChannels
+     *
+     * @return \p true if the results are sent via ResultChannel, \p false otherwise
+     */
+    [[nodiscard]] inline bool usesResultChannels() const {
+        return this->configuration.resultChannels && !this->configuration.concurrentResults &&
+               !this->configuration.resultReducer;
+    }
+
+    /**
+     * Publishes the state of the queue to WorkerController::metrics
+     */
+    inline void updateQueueMetrics() {
+        this->metrics.queuedTasks.store(this->numberOfQueuedTasks(), std::memory_order_relaxed);
+        this->metrics.queuedBytes.store(this->tasks.memoryBytes() + this->deprioritizedBytes + this->reassignedBytes,
+                                        std::memory_order_relaxed);
+        this->metrics.releasedBytes();
+        this->metrics.spilledTasks.store(this->tasks.spilled(), std::memory_order_relaxed);
+        this->metrics.spillReadFailures.store(this->tasks.readFailures(), std::memory_order_relaxed);
+        this->metrics.deprioritizedTasks.store(this->deprioritizedTasks.size(), std::memory_order_relaxed);
+        const std::chrono::nanoseconds estimatedQueueWait = this->estimateQueueWait();
+        this->metrics.estimatedQueueWait.store(estimatedQueueWait.count(), std::memory_order_relaxed);
+        this->metrics.remoteConnections.store(
+                this->remoteWorkers ? this->remoteWorkers->connections() : 0, std::memory_order_relaxed
+        );
+    }
+
+    /**
+     * Returns, whether \p thread runs the event loop of this WorkerController, its Processor or one of its shards. \n
+     * Used by the TaskSubmitter, which must not block these threads.
+     *
+     * @param thread The thread to check
+     * @return \p true if \p thread is one of the threads of this WorkerController, \p false otherwise
+     */
+    [[nodiscard]] inline bool isOwnThread(const QThread *const thread) const {
+        if (thread == this->thread() || thread == &this->processorThread) {
+            return true;
+        }
+        return std::any_of(
+                this->processorShardThreads.begin(), this->processorShardThreads.end(),
+                [thread](const std::unique_ptr<QThread> &shardThread) -> bool {
+                    return shardThread.get() == thread;
+                }
+        );
+    }
+
+    /**
+     * Starts recording the stream of tasks, see Controller::startRecording()
+     *
+     * @param fileName The file to write the recording to
+     * @param started Set to \p true if the file could be opened, \p false otherwise
+     */
+    inline void startRecording(const QString &fileName, bool &started) {
+        started = !this->isInDestructor && this->recorder.start(fileName, this->nextTaskId);
+    }
+
+    /**
+     * Stops recording the stream of tasks, see Controller::stopRecording()
+     */
+    inline void stopRecording() {
+        this->recorder.stop();
+    }
+
+    /**
+     * Copies the summed up performance counters, see Controller::perfCounters()
+     *
+     * @param report Set to the summed up performance counters
+     */
+    inline void perfCounters(PerfCounterReport &report) {
+        report.perWorker = this->workerCounters;
+        report.perTaskClass = this->taskClassCounters;
+    }
+
+    /**
+     * Starts merging the ResultReducer of all Worker, called on behalf of Processor::collectReduction(). \n
+     * Every Worker hands over its state between two of its tasks with a queued call to reducerReceived(), so that
+     * dispatching goes on meanwhile. The merged state is given to \p requester once all Worker replied.
+     *
+     * @param requester The Processor to give the merged state to, nullptr without
+     *                  ControllerConfiguration::resultReducer
+     */
+    inline void collectReduction(Processor<T, R> *const &requester) {
+        const std::uint64_t reductionId = this->nextReductionId++;
+        PendingReduction<T, R> &pending = this->pendingReductions[reductionId];
+        pending.requester = requester;
+        if (!this->configuration.resultReducer) {
+            this->finishReduction(reductionId);
+            return;
+        }
+
+        pending.reducer = this->configuration.resultReducer->clone();
+        if (this->retiredReducer) {
+            pending.reducer->merge(*this->retiredReducer);
+            this->retiredReducer.reset();
+        }
+        for (auto &threadTuple : this->threads) {
+            Worker<T, R> *const worker = std::get<1>(threadTuple);
+            pending.awaitedWorkers.insert(std::get<2>(threadTuple));
+            invokeInContext(
+                    static_cast<QObject *>(worker), Qt::QueuedConnection,
+                    &Worker<T, R>::sendReducer,
+                    worker, reductionId
+            );
+        }
+        if (pending.awaitedWorkers.empty()) {
+            this->finishReduction(reductionId);
+        }
+    }
+
+    /**
+     * Received, when a Worker handed over its ResultReducer for a reduction, see collectReduction()
+     *
+     * @param reductionId The id of the reduction, see WorkerController::nextReductionId
+     * @param workerUUID The unique UUID of the Worker
+     * @param reducer The ResultReducer of the Worker, nullptr if it has not folded any result
+     */
+    inline void reducerReceived(const std::uint64_t &reductionId, const QUuid &workerUUID,
+                                const std::shared_ptr<ResultReducer<R>> &reducer) {
+        const auto pending = this->pendingReductions.find(reductionId);
+        if (pending == this->pendingReductions.end() || !pending->second.awaitedWorkers.erase(workerUUID)) {
+            // the reduction went on without the Worker, since it has been stopped, thus keep its state for the next one
+            this->keepRetiredReducer(reducer);
+            return;
+        }
+
+        if (reducer) {
+            pending->second.reducer->merge(*reducer);
+        }
+        if (pending->second.awaitedWorkers.empty()) {
+            this->finishReduction(reductionId);
+        }
+    }
+
+    /**
+     * Gives the merged state of a reduction to the Processor which requested it
+     *
+     * @param reductionId The id of the reduction, see WorkerController::nextReductionId
+     */
+    inline void finishReduction(const std::uint64_t reductionId) {
+        const auto pending = this->pendingReductions.find(reductionId);
+        Processor<T, R> *const requester = pending->second.requester;
+        invokeInContext(
+                static_cast<QObject *>(requester), Qt::QueuedConnection,
+                &Processor<T, R>::reductionCollected,
+                requester, pending->second.reducer
+        );
+        this->pendingReductions.erase(pending);
+    }
+
+    /**
+     * Takes the ResultReducer of a Worker, waiting until the Worker finished its current task
+     *
+     * @param threadIndex The index of the Worker in WorkerController::threads
+     * @return The ResultReducer of the Worker, nullptr if it has not folded any result
+     */
+    inline std::shared_ptr<ResultReducer<R>> takeReducer(const std::size_t threadIndex) {
+        std::shared_ptr<ResultReducer<R>> workerReducer;
+        Worker<T, R> *worker = std::get<1>(this->threads[threadIndex]);
+        invokeInContext(
+                static_cast<QObject *>(worker), Qt::BlockingQueuedConnection,
+                &Worker<T, R>::takeReducer,
+                worker, workerReducer
+        );
+        return workerReducer;
+    }
+
+    /**
+     * Keeps the ResultReducer of a Worker about to be stopped in WorkerController::retiredReducer,
+     * so that no folded result is lost when reducing the number of threads. \n
+     * The pending reductions do not wait for the Worker anymore.
+     *
+     * @param threadIndex The index of the Worker in WorkerController::threads
+     */
+    inline void retireReducer(const std::size_t threadIndex) {
+        if (!this->configuration.resultReducer || this->isInDestructor) {
+            return;
+        }
+
+        this->keepRetiredReducer(this->takeReducer(threadIndex));
+
+        const QUuid &workerUUID = std::get<2>(this->threads[threadIndex]);
+        std::vector<std::uint64_t> finishedReductions;
+        for (auto &[reductionId, pending] : this->pendingReductions) {
+            if (pending.awaitedWorkers.erase(workerUUID) && pending.awaitedWorkers.empty()) {
+                finishedReductions.push_back(reductionId);
+            }
+        }
+        for (const std::uint64_t reductionId : finishedReductions) {
+            this->finishReduction(reductionId);
+        }
+    }
+
+    /**
+     * Merges a ResultReducer into WorkerController::retiredReducer, so that it is part of the next reduction
+     *
+     * @param reducer The ResultReducer to keep, nothing happens if nullptr
+     */
+    inline void keepRetiredReducer(const std::shared_ptr<ResultReducer<R>> &reducer) {
+        if (!reducer) {
+            return;
+        }
+        if (this->retiredReducer) {
+            this->retiredReducer->merge(*reducer);
+        } else {
+            this->retiredReducer = reducer;
+        }
+    }
+
+    /**
+     * Fills the state of the queue and the Worker, see Controller::introspect()
+     *
+     * @param snapshot Filled with everything but IntrospectionSnapshot::signalConnections
+     */
+    inline void introspect(IntrospectionSnapshot &snapshot) {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        snapshot.time = std::chrono::system_clock::now();
+        snapshot.targetNumberOfThreads = this->targetNumberOfThreads;
+        snapshot.metrics = this->metrics.snapshot();
+        snapshot.workers.resize(this->threads.size());
+        for (std::size_t threadIndex = 0; threadIndex < this->threads.size(); ++threadIndex) {
+            WorkerIntrospection &worker = snapshot.workers[threadIndex];
+            worker.index = threadIndex;
+            worker.busy = !this->workersReady.count(threadIndex);
+            if (worker.busy) {
+                worker.taskId = this->inFlightTasks[threadIndex].id;
+                worker.taskAge = now - this->inFlightTasks[threadIndex].dispatched;
+                for (const auto &batchedTask : this->inFlightTasks[threadIndex].batched) {
+                    worker.batchedTaskIds.push_back(batchedTask.first);
+                }
+            }
+        }
+    }
+
+    /**
+     * Stops starting new tasks and requests the running ones to be cancelled, see Controller::shutdown(). \n
+     * The queued tasks are discarded, tasks given afterwards are rejected.
+     *
+     * @param snapshot Filled with the state right before the cancellation, see WorkerController::introspect()
+     * @param discardedTasks Set to the number of discarded queued tasks, including the deprioritized ones
+     */
+    inline void requestShutdown(IntrospectionSnapshot &snapshot, std::size_t &discardedTasks) {
+        this->introspect(snapshot);
+        discardedTasks = this->numberOfQueuedTasks() + this->deprioritizedTasks.size();
+        this->isShuttingDown = true;
+        this->metrics.shutdownRequested.store(true, std::memory_order_relaxed);
+        this->clearQueue();
+        if (this->autoTuningTimer) {
+            this->autoTuningTimer->stop();
+        }
     }
 
     /**
      * Received, when a Worker has finished working
      * @param workerID The ID of the Worker finished working, which is the same as the index in this->threads + 1
+     * @param workerUUID The unique UUID of the Worker, used to ignore Worker which have already been removed
+     * @param measurement What the Worker measured while fulfilling the task
      */
-    inline void workerFinished(const std::size_t &workerID, const QUuid &workerUUID) {
+    inline void workerFinished(const std::size_t &workerID, const QUuid &workerUUID,
+                               const TaskMeasurement &measurement) {
         const std::size_t threadIndex = workerID - 1;
 
         if (threadIndex < this->threads.size() && workerUUID == std::get<2>(this->threads[threadIndex])) {
+            const InFlightTask &inFlightTask = this->inFlightTasks[threadIndex];
+            if (!measurement.discarded) {
+                this->queueWait.addServiceTime(std::chrono::steady_clock::now() - inFlightTask.dispatched);
+                this->recorder.recordCompletion(
+                        inFlightTask.id, inFlightTask.dispatched, measurement.fulfillDuration, threadIndex
+                );
+                this->metrics.completedTasks.fetch_add(1, std::memory_order_relaxed);
+                // a duplicate only runs for the slow tasks, which would skew the window
+                if (!inFlightTask.duplicate) {
+                    this->executionTimes.add(measurement.fulfillDuration);
+                }
+                ++this->roundCompletedTasks;
+                this->roundExecutionTime += measurement.fulfillDuration;
+            } else if (!inFlightTask.duplicate && !this->isShuttingDown) {
+                // the original task lost, so the duplicate saved at least the time the original took longer
+                this->metrics.hedgeWins.fetch_add(1, std::memory_order_relaxed);
+                this->metrics.hedgeSavedTime.fetch_add(measurement.lostBy.count(), std::memory_order_relaxed);
+            }
+            if (this->configuration.workerUsage) {
+                this->metrics.addWorkerUsage(threadIndex, measurement);
+            }
+            if (measurement.counters.tasks) {
+                if (this->workerCounters.size() <= threadIndex) {
+                    this->workerCounters.resize(threadIndex + 1);
+                }
+                this->workerCounters[threadIndex] += measurement.counters;
+                this->taskClassCounters[measurement.taskClass] += measurement.counters;
+            }
+            if (!this->inFlightTasks[threadIndex].batched.empty()) {
+                // the Worker continues with the next task of its batch right away
+                InFlightTask &current = this->inFlightTasks[threadIndex];
+                this->metrics.inFlightTasks.fetch_sub(1, std::memory_order_relaxed);
+                this->metrics.inFlightTaskBytes.fetch_sub(current.bytes, std::memory_order_relaxed);
+                this->metrics.releasedBytes();
+                std::tie(current.id, current.bytes) = current.batched.front();
+                current.batched.pop_front();
+                current.dispatched = std::chrono::steady_clock::now();
+                return;
+            }
+            this->releaseInFlightTask(threadIndex);
             this->workersReady.insert(threadIndex);
             checkTasks();
         }
@@ -224,30 +1335,182 @@ private:
      * The thread containing the Processor instance
      */
     QThread processorThread;
+    /**
+     * The threads of the shards of the Processor, see ControllerConfiguration::processorShards
+     */
+    std::vector<std::unique_ptr<QThread>> processorShardThreads;
+    /**
+     * The Processor and its shards, indexed by Processor::shardIndex()
+     */
+    std::vector<Processor<T, R> *> processors;
+    /**
+     * The ResultChannels of the Processor and its shards, indexed like WorkerController::processors
+     */
+    std::vector<std::unique_ptr<ResultInbox<R>>> resultInboxes;
+    /**
+     * The ResultChannel opened for every Worker, indexed like WorkerController::threads and then by shard,
+     * see ControllerConfiguration::resultChannels
+     */
+    std::vector<std::vector<std::shared_ptr<ResultChannel<R>>>> resultChannels;
     /**
      * std::vector containing the threads, the corresponding pointers to the Worker
      * and a unique UUID to identify the Worker
      */
     std::vector<std::tuple<std::unique_ptr<QThread>, Worker<T, R> *, QUuid>> threads;
     /**
-     * std::deque containing the tasks going to be sent to Worker
+     * The optional settings given on construction
+     */
+    const ControllerConfiguration<T, R> configuration;
+    /**
+     * The memory accounting, shared with the Worker and the Processor
+     */
+    Metrics metrics;
+    /**
+     * SpillQueue containing the tasks going to be sent to Worker
      */
-    std::deque<T> tasks;
+    SpillQueue<T> tasks;
+    /**
+     * std::vector containing the bookkeeping about the task each Worker is fulfilling,
+     * in the same order as WorkerController::threads
+     */
+    std::vector<InFlightTask> inFlightTasks;
     /**
      * std::set containing the indices (referring to WorkerController::threads) of Worker
      * currently not fulfilling a task
      */
     std::set<std::size_t> workersReady;
+    /**
+     * The id the next task given with extendQueue() is going to get, counting all tasks ever given
+     */
+    std::uint64_t nextTaskId = 0;
+    /**
+     * The low priority queue, see AdmissionPolicy::Deprioritize
+     */
+    std::deque<T, TaskAllocator<T>> deprioritizedTasks;
+    /**
+     * The number of bytes of WorkerController::deprioritizedTasks
+     */
+    std::size_t deprioritizedBytes = 0;
+    /**
+     * Estimates the queue wait of new tasks, see ControllerConfiguration::queueWaitTarget
+     */
+    QueueWaitEstimator queueWait;
+    /**
+     * Copies of the tasks being fulfilled, by the index of the Worker fulfilling them,
+     * only kept with ControllerConfiguration::hedging
+     */
+    std::map<std::size_t, T> hedgeableTasks;
+    /**
+     * The recent execution times, used to decide which tasks to hedge
+     */
+    ExecutionTimeWindow executionTimes;
+    /**
+     * Whether hedgeTasks() is going to be called by a timer
+     */
+    bool hedgeCheckScheduled = false;
+    /**
+     * The tasks given with Controller::scheduleAt() and Controller::scheduleEvery() waiting for their time
+     */
+    TimerWheel<T> scheduledTasks;
+    /**
+     * Fires, when the next scheduled task is due, created on first use
+     */
+    QTimer *schedulerTimer = nullptr;
+    /**
+     * Chooses WorkerController::activeWorkers and WorkerController::dispatchBatchSize,
+     * see ControllerConfiguration::autoTuning
+     */
+    AutoTuner autoTuner;
+    /**
+     * Ends the rounds of the AutoTuner, created on first use
+     */
+    QTimer *autoTuningTimer = nullptr;
+    /**
+     * Only the Worker with a lower index are given tasks, see ControllerConfiguration::autoTuning
+     */
+    std::size_t activeWorkers = std::numeric_limits<std::size_t>::max();
+    /**
+     * The largest number of tasks sent to a Worker at once, see ControllerConfiguration::dispatchBatchSize
+     */
+    std::size_t dispatchBatchSize;
+    /**
+     * The number of tasks completed by local Worker in the current round of the AutoTuner
+     */
+    std::size_t roundCompletedTasks = 0;
+    /**
+     * The summed up execution time of the tasks completed in the current round of the AutoTuner
+     */
+    std::chrono::nanoseconds roundExecutionTime{0};
+    /**
+     * Whether a Worker has been ready without a task to give to it in the current round of the AutoTuner
+     */
+    bool roundStarved = false;
+    /**
+     * The time the current round of the AutoTuner started
+     */
+    std::chrono::steady_clock::time_point roundStart;
+    /**
+     * The backend sending tasks to remote Worker, see ControllerConfiguration::remoteWorkers
+     */
+    std::unique_ptr<RemoteWorkers<T, R>> remoteWorkers;
+    /**
+     * The tasks of lost remote Worker, which are sent to the next ready Worker before the tasks of the queue
+     */
+    std::deque<RemoteTask<T>> reassignedTasks;
+    /**
+     * The number of bytes of WorkerController::reassignedTasks
+     */
+    std::size_t reassignedBytes = 0;
+    /**
+     * The merged ResultReducer of the Worker stopped since the last collectReduction(),
+     * and of the results of remote Worker
+     */
+    std::shared_ptr<ResultReducer<R>> retiredReducer;
+    /**
+     * The reductions waiting for Worker to hand over their ResultReducer, see collectReduction()
+     */
+    std::map<std::uint64_t, PendingReduction<T, R>> pendingReductions;
+    /**
+     * The id the next reduction requested with Processor::collectReduction() is going to get
+     */
+    std::uint64_t nextReductionId = 0;
+    /**
+     * Writes the stream of tasks to a file while recording, see Controller::startRecording()
+     */
+    TaskRecorder<T> recorder;
+    /**
+     * The performance counters summed up per Worker, indexed like WorkerController::threads,
+     * see ControllerConfiguration::perfCounters
+     */
+    std::vector<PerfCounterValues> workerCounters;
+    /**
+     * The performance counters summed up per task class, see ControllerConfiguration::taskClass
+     */
+    std::map<std::size_t, PerfCounterValues> taskClassCounters;
+    /**
+     * The number of threads set with setNumberOfThreads(),
+     * which may be larger than the number of running threads when using lazy worker start
+     */
+    std::size_t targetNumberOfThreads = 0;
     /**
      * Used to not allow the creation of new Worker when already in the destructor
      */
     bool isInDestructor = false;
+    /**
+     * Used to not start new tasks once Controller::shutdown() requested the cancellation
+     */
+    bool isShuttingDown = false;
 
     /**
      * In order to be able to instantiate this class, whose constructor is private, making the
      * template class Controller a friend is necessary.
      */
     friend class Controller<T, R>;
+
+    /**
+     * In order to extend the queue from any thread, making the template class TaskSubmitter a friend is necessary.
+     */
+    friend class TaskSubmitter<T, R>;
 };
 
 #endif
@@ -0,0 +1,89 @@
+#ifndef QT_MULTITHREADING_BENCHMARKPROCESSOR_H
+#define QT_MULTITHREADING_BENCHMARKPROCESSOR_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+#include "../../Processor.h"
+
+/**
+ * The result of a benchmark task: the index of the task and the calculated value
+ */
+using benchmark_result = std::pair<std::size_t, std::uint64_t>;
+
+/**
+ * Processor recording the time at which each result has been received
+ */
+class BenchmarkProcessor : public Processor<std::size_t, benchmark_result> {
+public:
+    /**
+     * Constructor for the Processor
+     *
+     * @param completions See BenchmarkProcessor::completions
+     * @param start See BenchmarkProcessor::start
+     */
+    BenchmarkProcessor(std::vector<std::int64_t> &completions, const std::chrono::steady_clock::time_point &start)
+            : completions(completions), start(start) {}
+
+    /**
+     * Gives tasks to the WorkerController and blocks the calling thread until all results have been received
+     *
+     * @param newTasks The tasks to fulfill
+     */
+    inline void submitAndWait(const std::deque<std::size_t> &newTasks) {
+        QMutexLocker locker(&this->mutex);
+        this->toProcess = newTasks.size();
+        invokeInContext(
+                static_cast<QObject *>(this), Qt::QueuedConnection,
+                [this, newTasks]() -> void { this->extendQueue(newTasks); }
+        );
+        while (this->toProcess) {
+            this->allProcessed.wait(&this->mutex);
+        }
+    }
+
+private:
+    /**
+     * The times at which the results have been received in nanoseconds since BenchmarkProcessor::start,
+     * indexed by task
+     */
+    std::vector<std::int64_t> &completions;
+    /**
+     * The time at which the tasks have been submitted
+     */
+    const std::chrono::steady_clock::time_point &start;
+    /**
+     * Protects BenchmarkProcessor::toProcess
+     */
+    QMutex mutex;
+    /**
+     * Woken up when all results have been received
+     */
+    QWaitCondition allProcessed;
+    /**
+     * The number of results not yet received
+     */
+    std::size_t toProcess = 0;
+
+    /**
+     * Records the time of receiving the result
+     *
+     * @param result The index of the task and the calculated value
+     */
+    inline void receiveResult(benchmark_result &result) override {
+        this->completions[result.first] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - this->start
+        ).count();
+
+        QMutexLocker locker(&this->mutex);
+        if (!--this->toProcess) {
+            this->allProcessed.wakeAll();
+        }
+    }
+};
+
+#endif
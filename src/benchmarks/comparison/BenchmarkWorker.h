@@ -0,0 +1,62 @@
+#ifndef QT_MULTITHREADING_BENCHMARKWORKER_H
+#define QT_MULTITHREADING_BENCHMARKWORKER_H
+
+#include <ctime>
+#include <vector>
+#include "../../Worker.h"
+#include "BenchmarkProcessor.h"
+#include "Workloads.h"
+
+/**
+ * Worker fulfilling the tasks of a Workload and recording the CPU time spent on each of them
+ */
+class BenchmarkWorker : public Worker<std::size_t, benchmark_result> {
+public:
+    /**
+     * Constructor for the Worker
+     *
+     * @param data See BenchmarkWorker::data
+     * @param workload See BenchmarkWorker::workload
+     * @param taskCpuTimes See BenchmarkWorker::taskCpuTimes
+     */
+    BenchmarkWorker(const WorkloadData &data, const Workload workload, std::vector<std::int64_t> &taskCpuTimes)
+            : data(data), workload(workload), taskCpuTimes(taskCpuTimes) {}
+
+private:
+    /**
+     * The input data of the workloads
+     */
+    const WorkloadData &data;
+    /**
+     * The Workload to fulfill
+     */
+    const Workload workload;
+    /**
+     * The CPU time spent on each task in nanoseconds, indexed by task
+     */
+    std::vector<std::int64_t> &taskCpuTimes;
+
+    /**
+     * Fulfills the task with the given index
+     *
+     * @param task The index of the task
+     * @return The index of the task and the calculated value
+     */
+    inline benchmark_result fulfillTask(std::size_t &task) override {
+        const std::int64_t cpuStart = cpuTimeNanoseconds(CLOCK_THREAD_CPUTIME_ID);
+        const std::uint64_t value = this->data.run(this->workload, task);
+        this->taskCpuTimes[task] = cpuTimeNanoseconds(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+        return std::make_pair(task, value);
+    }
+
+    /**
+     * Clones the worker.
+     *
+     * @return The cloned worker
+     */
+    inline std::unique_ptr<Worker<std::size_t, benchmark_result>> clone() override {
+        return std::make_unique<BenchmarkWorker>(this->data, this->workload, this->taskCpuTimes);
+    }
+};
+
+#endif
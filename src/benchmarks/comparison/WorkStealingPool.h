@@ -0,0 +1,183 @@
+#ifndef QT_MULTITHREADING_WORKSTEALINGPOOL_H
+#define QT_MULTITHREADING_WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A plain work-stealing thread pool used as baseline in the comparison. \n
+ * Every thread owns a queue, takes tasks from the front of its own queue and steals from the back of the
+ * queues of the other threads when its own queue is empty.
+ */
+class WorkStealingPool {
+public:
+    /**
+     * Constructor used to start the threads of the pool
+     *
+     * @param numberOfThreads The number of threads to use
+     */
+    explicit WorkStealingPool(const std::size_t numberOfThreads) {
+        for (std::size_t threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex) {
+            this->queues.emplace_back(std::make_unique<Queue>());
+        }
+        for (std::size_t threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex) {
+            this->threads.emplace_back([this, threadIndex]() -> void { this->work(threadIndex); });
+        }
+    }
+
+    /**
+     * Stops and joins all threads
+     */
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stop = true;
+        }
+        this->condition.notify_all();
+        for (auto &thread : this->threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * Runs \p task for every index in [0, \p numberOfTasks) and blocks until all tasks are done. \n
+     * The indices are distributed round-robin over the queues of the threads.
+     *
+     * @param numberOfTasks The number of tasks
+     * @param task The task to run for every index
+     */
+    inline void run(const std::size_t numberOfTasks, std::function<void(std::size_t)> task) {
+        if (!numberOfTasks) {
+            return;
+        }
+
+        for (std::size_t taskIndex = 0; taskIndex < numberOfTasks; ++taskIndex) {
+            Queue &queue = *this->queues[taskIndex % this->queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(taskIndex);
+        }
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->currentTask = std::move(task);
+        this->remaining = numberOfTasks;
+        ++this->generation;
+        this->condition.notify_all();
+        this->condition.wait(lock, [this]() -> bool { return !this->remaining; });
+    }
+
+private:
+    /**
+     * The queue of a single thread
+     */
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    /**
+     * The queues of the threads, in the same order as WorkStealingPool::threads
+     */
+    std::vector<std::unique_ptr<Queue>> queues;
+    /**
+     * The threads of the pool
+     */
+    std::vector<std::thread> threads;
+    /**
+     * Protects WorkStealingPool::currentTask, WorkStealingPool::generation and WorkStealingPool::stop
+     */
+    std::mutex mutex;
+    /**
+     * Used to wake up the threads on a new run and the caller of run() when all tasks are done
+     */
+    std::condition_variable condition;
+    /**
+     * The task to run for every index of the current run
+     */
+    std::function<void(std::size_t)> currentTask;
+    /**
+     * The number of tasks of the current run, which are not done yet
+     */
+    std::atomic<std::size_t> remaining = 0;
+    /**
+     * Incremented on every run, so that the threads know about new tasks
+     */
+    std::uint64_t generation = 0;
+    /**
+     * Set to stop the threads
+     */
+    bool stop = false;
+
+    /**
+     * Takes the next task of the given queue
+     *
+     * @param queue The queue to take the task from
+     * @param fromFront Whether to take from the front (own queue) or the back (stealing)
+     * @param taskIndex Set to the index of the taken task
+     * @return \p true if a task has been taken, \p false if the queue was empty
+     */
+    static inline bool take(Queue &queue, const bool fromFront, std::size_t &taskIndex) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        if (fromFront) {
+            taskIndex = queue.tasks.front();
+            queue.tasks.pop_front();
+        } else {
+            taskIndex = queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+        return true;
+    }
+
+    /**
+     * The loop of every thread of the pool
+     *
+     * @param threadIndex The index of the thread
+     */
+    inline void work(const std::size_t threadIndex) {
+        std::uint64_t seenGeneration = 0;
+
+        while (true) {
+            std::function<void(std::size_t)> task;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->condition.wait(lock, [&]() -> bool { return this->stop || this->generation != seenGeneration; });
+                if (this->stop) {
+                    return;
+                }
+                seenGeneration = this->generation;
+                task = this->currentTask;
+            }
+
+            std::size_t taskIndex = 0;
+            while (true) {
+                bool found = WorkStealingPool::take(*this->queues[threadIndex], true, taskIndex);
+                for (std::size_t offset = 1; !found && offset < this->queues.size(); ++offset) {
+                    found = WorkStealingPool::take(
+                            *this->queues[(threadIndex + offset) % this->queues.size()], false, taskIndex
+                    );
+                }
+                if (!found) {
+                    break;
+                }
+
+                task(taskIndex);
+                if (this->remaining.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->condition.notify_all();
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef QT_MULTITHREADING_WORKLOADS_H
+#define QT_MULTITHREADING_WORKLOADS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * The workloads every framework of the comparison has to fulfill
+ */
+enum class Workload {
+    /**
+     * Adds one to a number, which only measures the overhead of the framework
+     */
+    Trivial,
+    /**
+     * Calculates the total stopping time of a number, see example three
+     */
+    Collatz,
+    /**
+     * Sums up randomly chosen elements of an array, which is much larger than the caches
+     */
+    MemoryBound,
+    /**
+     * Busy waits, most tasks for a short time and a few for a long time
+     */
+    Skewed
+};
+
+/**
+ * Returns the name of a Workload
+ *
+ * @param workload The Workload
+ * @return The name of \p workload
+ */
+inline std::string workloadName(const Workload workload) {
+    switch (workload) {
+        case Workload::Trivial:
+            return "trivial";
+        case Workload::Collatz:
+            return "collatz";
+        case Workload::MemoryBound:
+            return "memory-bound";
+        case Workload::Skewed:
+            return "skewed";
+    }
+    return "unknown";
+}
+
+/**
+ * Returns the CPU time consumed by a clock, e.g. CLOCK_THREAD_CPUTIME_ID or CLOCK_PROCESS_CPUTIME_ID
+ *
+ * @param clock The id of the clock
+ * @return The consumed CPU time in nanoseconds
+ */
+inline std::int64_t cpuTimeNanoseconds(const clockid_t clock) {
+    timespec time{};
+    clock_gettime(clock, &time);
+    return static_cast<std::int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+/**
+ * The input data of all workloads, created once and shared by all frameworks, so that they fulfill exactly
+ * the same tasks
+ */
+class WorkloadData {
+public:
+    /**
+     * Constructor used to create the input data
+     *
+     * @param numberOfTasks The number of tasks per workload
+     */
+    explicit WorkloadData(const std::size_t numberOfTasks) : numberOfTasks(numberOfTasks) {
+        std::mt19937_64 generator(42);
+
+        std::uniform_int_distribution<unsigned int> collatzDistribution(1, 1000000);
+        this->collatzNumbers.resize(numberOfTasks);
+        for (auto &number : this->collatzNumbers) {
+            number = collatzDistribution(generator);
+        }
+
+        // 64 MiB, larger than usual last level caches
+        this->memory.resize(8 * 1024 * 1024);
+        for (std::size_t i = 0; i < this->memory.size(); ++i) {
+            this->memory[i] = i;
+        }
+
+        // 95 % of the tasks take 20 microseconds, 5 % take 1 millisecond
+        std::bernoulli_distribution longTaskDistribution(0.05);
+        this->skewedDurations.resize(numberOfTasks);
+        for (auto &duration : this->skewedDurations) {
+            duration = std::chrono::microseconds(longTaskDistribution(generator) ? 1000 : 20);
+        }
+    }
+
+    /**
+     * Fulfills the task with the given index of a workload
+     *
+     * @param workload The Workload
+     * @param taskIndex The index of the task
+     * @return The result of the task
+     */
+    [[nodiscard]] inline std::uint64_t run(const Workload workload, const std::size_t taskIndex) const {
+        switch (workload) {
+            case Workload::Trivial:
+                return taskIndex + 1;
+            case Workload::Collatz: {
+                std::uint64_t n = this->collatzNumbers[taskIndex], sequenceLength = 1;
+                while (n > 1) {
+                    n = n % 2 ? 3 * n + 1 : n / 2;
+                    ++sequenceLength;
+                }
+                return sequenceLength;
+            }
+            case Workload::MemoryBound: {
+                std::uint64_t sum = 0, position = taskIndex * 2654435761u;
+                for (std::size_t access = 0; access < 2000; ++access) {
+                    position = (position * 6364136223846793005u + 1442695040888963407u);
+                    sum += this->memory[(position >> 20) % this->memory.size()];
+                }
+                return sum;
+            }
+            case Workload::Skewed: {
+                const auto end = std::chrono::steady_clock::now() + this->skewedDurations[taskIndex];
+                std::uint64_t spins = 0;
+                while (std::chrono::steady_clock::now() < end) {
+                    ++spins;
+                }
+                return spins;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * The number of tasks per workload
+     */
+    const std::size_t numberOfTasks;
+
+private:
+    /**
+     * The numbers of which the total stopping time is calculated
+     */
+    std::vector<unsigned int> collatzNumbers;
+    /**
+     * The memory read by the memory-bound workload
+     */
+    std::vector<std::uint64_t> memory;
+    /**
+     * The durations of the tasks of the skewed workload
+     */
+    std::vector<std::chrono::microseconds> skewedDurations;
+};
+
+/**
+ * What every framework measures while fulfilling all tasks of a workload
+ */
+struct Measurement {
+    /**
+     * For every task the time from submitting it until its result has been available, in nanoseconds
+     */
+    std::vector<std::int64_t> latencies;
+    /**
+     * The wall time needed to fulfill all tasks
+     */
+    std::chrono::nanoseconds wallTime{0};
+    /**
+     * The CPU time of the whole process while fulfilling all tasks, in nanoseconds
+     */
+    std::int64_t processCpuTime = 0;
+    /**
+     * The CPU time spent in the tasks themselves, in nanoseconds
+     */
+    std::int64_t taskCpuTime = 0;
+};
+
+#endif
@@ -0,0 +1,297 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+#include "../../Controller.h"
+#include "BenchmarkProcessor.h"
+#include "BenchmarkWorker.h"
+#include "WorkStealingPool.h"
+#include "Workloads.h"
+
+using benchmark_clock = std::chrono::steady_clock;
+
+/**
+ * Everything a framework needs to fulfill the tasks of a workload and to record its measurements
+ */
+struct Run {
+    /**
+     * The input data of the workloads
+     */
+    const WorkloadData &data;
+    /**
+     * The workload to fulfill
+     */
+    const Workload workload;
+    /**
+     * The number of threads to use
+     */
+    const std::size_t numberOfThreads;
+    /**
+     * The time at which all tasks are submitted, set right before calling the framework
+     */
+    benchmark_clock::time_point start;
+    /**
+     * For every task the time at which its result has been available, in nanoseconds since Run::start
+     */
+    std::vector<std::int64_t> completions;
+    /**
+     * For every task the CPU time spent fulfilling it, in nanoseconds
+     */
+    std::vector<std::int64_t> taskCpuTimes;
+    /**
+     * For every task its result, stored so that the compiler cannot optimize the tasks away
+     */
+    std::vector<std::uint64_t> results;
+
+    /**
+     * Fulfills a task and records its result, CPU time and completion time
+     *
+     * @param taskIndex The index of the task
+     * @return The result of the task
+     */
+    inline std::uint64_t fulfill(const std::size_t taskIndex) {
+        const std::int64_t cpuStart = cpuTimeNanoseconds(CLOCK_THREAD_CPUTIME_ID);
+        const std::uint64_t result = this->data.run(this->workload, taskIndex);
+        this->taskCpuTimes[taskIndex] = cpuTimeNanoseconds(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+        this->results[taskIndex] = result;
+        this->complete(taskIndex);
+        return result;
+    }
+
+    /**
+     * Records the completion time of a task
+     *
+     * @param taskIndex The index of the task
+     */
+    inline void complete(const std::size_t taskIndex) {
+        this->completions[taskIndex] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                benchmark_clock::now() - this->start
+        ).count();
+    }
+};
+
+/**
+ * Fulfills all tasks of a workload with this framework, the result is available once the Processor received it
+ *
+ * @param run See Run
+ */
+void runController(Run &run) {
+    std::unique_ptr<BenchmarkProcessor> processor = std::make_unique<BenchmarkProcessor>(run.completions, run.start);
+    BenchmarkProcessor *const processorPtr = processor.get();
+    Controller<std::size_t, benchmark_result> controller(
+            std::move(processor), std::make_unique<BenchmarkWorker>(run.data, run.workload, run.taskCpuTimes),
+            run.numberOfThreads
+    );
+
+    std::deque<std::size_t> tasks;
+    for (std::size_t taskIndex = 0; taskIndex < run.data.numberOfTasks; ++taskIndex) {
+        tasks.push_back(taskIndex);
+    }
+
+    run.start = benchmark_clock::now();
+    processorPtr->submitAndWait(tasks);
+}
+
+/**
+ * Fulfills all tasks of a workload with a QThreadPool, one QRunnable per task
+ *
+ * @param run See Run
+ */
+void runQThreadPool(Run &run) {
+    QThreadPool pool;
+    pool.setMaxThreadCount(static_cast<int>(run.numberOfThreads));
+
+    run.start = benchmark_clock::now();
+    for (std::size_t taskIndex = 0; taskIndex < run.data.numberOfTasks; ++taskIndex) {
+        // QThreadPool deletes the runnable after running it
+        pool.start(QRunnable::create([&run, taskIndex]() -> void { run.fulfill(taskIndex); }));
+    }
+    pool.waitForDone();
+}
+
+/**
+ * Function object for QtConcurrent::mapped(), which needs to know the type of the result
+ */
+struct MappedTask {
+    using result_type = std::uint64_t;
+
+    /**
+     * See Run
+     */
+    Run *run;
+
+    inline std::uint64_t operator()(const std::size_t &taskIndex) const {
+        return this->run->fulfill(taskIndex);
+    }
+};
+
+/**
+ * Fulfills all tasks of a workload with QtConcurrent::mapped()
+ *
+ * @param run See Run
+ */
+void runQtConcurrent(Run &run) {
+    QThreadPool pool;
+    pool.setMaxThreadCount(static_cast<int>(run.numberOfThreads));
+
+    QVector<std::size_t> tasks(static_cast<int>(run.data.numberOfTasks));
+    for (std::size_t taskIndex = 0; taskIndex < run.data.numberOfTasks; ++taskIndex) {
+        tasks[static_cast<int>(taskIndex)] = taskIndex;
+    }
+
+    run.start = benchmark_clock::now();
+    QFuture<std::uint64_t> future = QtConcurrent::mapped(&pool, tasks, MappedTask{&run});
+    future.waitForFinished();
+}
+
+/**
+ * Fulfills all tasks of a workload with std::async(). \n
+ * Since every call may start a new thread, only a window of 4 tasks per thread is running at once,
+ * the result is available once the consumer got it from the std::future.
+ *
+ * @param run See Run
+ */
+void runStdAsync(Run &run) {
+    const std::size_t window = 4 * run.numberOfThreads;
+    std::deque<std::pair<std::size_t, std::future<std::uint64_t>>> futures;
+
+    run.start = benchmark_clock::now();
+    for (std::size_t taskIndex = 0; taskIndex < run.data.numberOfTasks; ++taskIndex) {
+        if (futures.size() == window) {
+            futures.front().second.get();
+            run.complete(futures.front().first);
+            futures.pop_front();
+        }
+        futures.emplace_back(taskIndex, std::async(std::launch::async, [&run, taskIndex]() -> std::uint64_t {
+            const std::int64_t cpuStart = cpuTimeNanoseconds(CLOCK_THREAD_CPUTIME_ID);
+            const std::uint64_t result = run.data.run(run.workload, taskIndex);
+            run.taskCpuTimes[taskIndex] = cpuTimeNanoseconds(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+            return result;
+        }));
+    }
+    for (auto &[taskIndex, future] : futures) {
+        future.get();
+        run.complete(taskIndex);
+    }
+}
+
+/**
+ * Fulfills all tasks of a workload with a plain work-stealing pool
+ *
+ * @param run See Run
+ */
+void runWorkStealing(Run &run) {
+    WorkStealingPool pool(run.numberOfThreads);
+
+    run.start = benchmark_clock::now();
+    pool.run(run.data.numberOfTasks, [&run](const std::size_t taskIndex) -> void { run.fulfill(taskIndex); });
+}
+
+/**
+ * Fulfills all tasks of a workload with a framework and measures it
+ *
+ * @param data The input data of the workloads
+ * @param workload The workload to fulfill
+ * @param numberOfThreads The number of threads to use
+ * @param framework The function fulfilling all tasks with a framework
+ * @return The Measurement
+ */
+Measurement measure(const WorkloadData &data, const Workload workload, const std::size_t numberOfThreads,
+                    const std::function<void(Run &)> &framework) {
+    Run run{data, workload, numberOfThreads, benchmark_clock::now(),
+            std::vector<std::int64_t>(data.numberOfTasks), std::vector<std::int64_t>(data.numberOfTasks),
+            std::vector<std::uint64_t>(data.numberOfTasks)};
+
+    // the process CPU time includes starting and stopping the threads, which is part of the overhead
+    const std::int64_t processCpuStart = cpuTimeNanoseconds(CLOCK_PROCESS_CPUTIME_ID);
+    framework(run);
+
+    Measurement measurement;
+    measurement.processCpuTime = cpuTimeNanoseconds(CLOCK_PROCESS_CPUTIME_ID) - processCpuStart;
+    // the last result marks the end, so that stopping the threads does not count into the wall time
+    for (const std::int64_t completion : run.completions) {
+        measurement.wallTime = std::max(measurement.wallTime, std::chrono::nanoseconds(completion));
+    }
+    measurement.latencies = std::move(run.completions);
+    for (const std::int64_t taskCpuTime : run.taskCpuTimes) {
+        measurement.taskCpuTime += taskCpuTime;
+    }
+    return measurement;
+}
+
+/**
+ * Returns a percentile of latencies
+ *
+ * @param sortedLatencies The sorted latencies
+ * @param percentile The percentile in [0, 1]
+ * @return The percentile in microseconds
+ */
+double percentile(const std::vector<std::int64_t> &sortedLatencies, const double percentile) {
+    if (sortedLatencies.empty()) {
+        return 0;
+    }
+    const auto index = static_cast<std::size_t>(percentile * static_cast<double>(sortedLatencies.size() - 1));
+    return static_cast<double>(sortedLatencies[index]) / 1e3;
+}
+
+/**
+ * Prints a Measurement
+ *
+ * @param name The name of the framework
+ * @param measurement The Measurement to print
+ */
+void print(const std::string &name, Measurement measurement) {
+    const auto numberOfTasks = static_cast<double>(measurement.latencies.size());
+    std::sort(measurement.latencies.begin(), measurement.latencies.end());
+    const double seconds = std::chrono::duration<double>(measurement.wallTime).count();
+    const double overhead = static_cast<double>(measurement.processCpuTime - measurement.taskCpuTime) / numberOfTasks;
+
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(16) << numberOfTasks / seconds
+              << std::setw(14) << percentile(measurement.latencies, 0.5)
+              << std::setw(14) << percentile(measurement.latencies, 0.99)
+              << std::setw(18) << overhead << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    // setup Qt stuff
+    QCoreApplication a(argc, argv);
+
+    // usage: [number of threads] [number of tasks per workload]
+    const std::size_t numberOfThreads = argc > 1 ? std::stoul(argv[1]) : QThread::idealThreadCount();
+    const std::size_t numberOfTasks = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+    std::cout << "creating input data for " << numberOfTasks << " tasks per workload, using "
+              << numberOfThreads << " threads" << std::endl;
+    const WorkloadData data(numberOfTasks);
+
+    const std::vector<std::pair<std::string, std::function<void(Run &)>>> frameworks = {
+            {"Controller", runController},
+            {"QThreadPool", runQThreadPool},
+            {"QtConcurrent", runQtConcurrent},
+            {"std::async", runStdAsync},
+            {"work-stealing", runWorkStealing}
+    };
+
+    for (const Workload workload : {Workload::Trivial, Workload::Collatz, Workload::MemoryBound, Workload::Skewed}) {
+        std::cout << std::endl << "~~~ " << workloadName(workload) << " ~~~" << std::endl
+                  << std::left << std::setw(16) << "framework" << std::right
+                  << std::setw(16) << "tasks/s" << std::setw(14) << "p50 [us]" << std::setw(14) << "p99 [us]"
+                  << std::setw(18) << "overhead [ns]" << std::endl;
+        for (const auto &[name, framework] : frameworks) {
+            print(name, measure(data, workload, numberOfThreads, framework));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,277 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../../HugePageAllocator.h"
+#include "../../SoAStorage.h"
+
+#if defined(__linux__)
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#endif
+
+using benchmark_clock = std::chrono::steady_clock;
+
+/**
+ * A task of 64 bytes, the size of a cache line. \n
+ * The tag only distinguishes the type queued with and without huge pages.
+ *
+ * @tparam Tag 1 to queue the task backed by huge pages, 0 otherwise
+ */
+template<int Tag>
+struct QueuedTask {
+    std::uint64_t id = 0;
+    std::array<std::uint64_t, 7> payload{};
+};
+
+/**
+ * Opts the tagged task into huge pages, which is all a user of the framework has to do
+ */
+template<>
+struct HugePagesEnabled<QueuedTask<1>> : std::true_type {
+};
+
+/**
+ * Counts the misses of the data TLB of the calling thread with Linux perf_event_open(), together with the minor page
+ * faults, whose number drops to 1/512 when the memory is backed by huge pages. \n
+ * The TLB misses are not available in most virtual machines, they are printed as "n/a" then.
+ */
+class TlbCounter {
+public:
+    TlbCounter() {
+#if defined(__linux__)
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HW_CACHE;
+        attributes.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        this->fd = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+    }
+
+    ~TlbCounter() {
+#if defined(__linux__)
+        if (this->fd >= 0) {
+            close(this->fd);
+        }
+#endif
+    }
+
+    TlbCounter(const TlbCounter &) = delete;
+
+    TlbCounter &operator=(const TlbCounter &) = delete;
+
+    /**
+     * Starts counting from zero
+     */
+    void start() {
+#if defined(__linux__)
+        if (this->fd >= 0) {
+            ioctl(this->fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(this->fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        rusage usage{};
+        getrusage(RUSAGE_THREAD, &usage);
+        this->faultsAtStart = usage.ru_minflt;
+#endif
+    }
+
+    /**
+     * Stops counting
+     *
+     * @param tlbMisses Set to the TLB misses since start(), -1 if they are not available
+     * @param pageFaults Set to the minor page faults since start()
+     */
+    void stop(long long &tlbMisses, long long &pageFaults) {
+        tlbMisses = -1;
+        pageFaults = 0;
+#if defined(__linux__)
+        rusage usage{};
+        getrusage(RUSAGE_THREAD, &usage);
+        pageFaults = usage.ru_minflt - this->faultsAtStart;
+        std::uint64_t value = 0;
+        if (this->fd >= 0) {
+            ioctl(this->fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(this->fd, &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value))) {
+                tlbMisses = static_cast<long long>(value);
+            }
+        }
+#endif
+    }
+
+private:
+    int fd = -1;
+    long faultsAtStart = 0;
+};
+
+/**
+ * Returns the amount of anonymous memory of the process backed by transparent huge pages
+ *
+ * @return The number of megabytes, 0 if unknown
+ */
+long long anonHugePagesMegabytes() {
+    std::ifstream smaps("/proc/self/smaps_rollup");
+    std::string line;
+    while (std::getline(smaps, line)) {
+        if (line.rfind("AnonHugePages:", 0) == 0) {
+            return std::stoll(line.substr(std::strlen("AnonHugePages:"))) / 1024;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Runs a phase of a benchmark and prints its duration, TLB misses and page faults
+ *
+ * @param name The name of the phase
+ * @param operations The number of operations of the phase, to print the misses per operation
+ * @param phase The phase to measure, returns a checksum keeping the compiler from optimizing it away
+ * @return The checksum
+ */
+std::uint64_t measure(const std::string &name, const std::size_t operations,
+                      const std::function<std::uint64_t()> &phase) {
+    TlbCounter counter;
+    counter.start();
+    const auto start = benchmark_clock::now();
+    const std::uint64_t checksum = phase();
+    const std::chrono::duration<double> duration = benchmark_clock::now() - start;
+    long long tlbMisses = 0;
+    long long pageFaults = 0;
+    counter.stop(tlbMisses, pageFaults);
+
+    std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << duration.count();
+    if (tlbMisses >= 0) {
+        std::cout << std::setw(16) << tlbMisses << std::setw(12) << std::setprecision(4)
+                  << static_cast<double>(tlbMisses) / static_cast<double>(operations);
+    } else {
+        std::cout << std::setw(16) << "n/a" << std::setw(12) << "n/a";
+    }
+    std::cout << std::setw(14) << pageFaults << std::setw(12) << anonHugePagesMegabytes() << std::endl;
+    return checksum;
+}
+
+/**
+ * Fills the queue of the WorkerController with \p count tasks, looks up random tasks and drains it again
+ *
+ * @tparam Task The task type, decides about huge pages
+ * @param label Printed in front of the phases
+ * @param count The number of tasks
+ * @param lookups The number of random lookups
+ * @return The checksum of all phases
+ */
+template<typename Task>
+std::uint64_t benchmarkQueue(const std::string &label, const std::size_t count, const std::size_t lookups) {
+    TaskQueue<Task> queue;
+    std::uint64_t checksum = measure(label + " fill", count, [&]() -> std::uint64_t {
+        for (std::size_t index = 0; index < count; ++index) {
+            Task task;
+            task.id = index;
+            queue.push_back(task);
+        }
+        return queue.size();
+    });
+    checksum += measure(label + " random lookups", lookups, [&]() -> std::uint64_t {
+        std::mt19937_64 random(42);
+        std::uint64_t sum = 0;
+        for (std::size_t lookup = 0; lookup < lookups; ++lookup) {
+            sum += queue[random() % count].id;
+        }
+        return sum;
+    });
+    checksum += measure(label + " drain", count, [&]() -> std::uint64_t {
+        std::uint64_t sum = 0;
+        while (!queue.empty()) {
+            sum += queue.front().id;
+            queue.pop_front();
+        }
+        return sum;
+    });
+    return checksum;
+}
+
+/**
+ * Gathers random elements of a large table, like Worker reading state shared by all of them
+ *
+ * @tparam Vector std::vector or HugePageVector
+ * @param label Printed in front of the phase
+ * @param count The number of elements of the table
+ * @param lookups The number of random lookups
+ * @return The checksum
+ */
+template<typename Vector>
+std::uint64_t benchmarkSharedTable(const std::string &label, const std::size_t count, const std::size_t lookups) {
+    Vector table(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        table[index] = index;
+    }
+    return measure(label + " random lookups", lookups, [&]() -> std::uint64_t {
+        std::mt19937_64 random(42);
+        std::uint64_t sum = 0;
+        for (std::size_t lookup = 0; lookup < lookups; ++lookup) {
+            sum += table[random() % count];
+        }
+        return sum;
+    });
+}
+
+/**
+ * Compares the queue of the WorkerController and a table shared by Worker with and without huge pages,
+ * see HugePagesEnabled and HugePageAllocator
+ *
+ * Usage: benchmark_hugepages [megabytes] [--explicit] \n
+ * The size of the queue and of the table, 1024 MB by default. With --explicit, explicit huge pages are tried before
+ * transparent huge pages, which requires reserving them first, e.g. with "sysctl vm.nr_hugepages=1024".
+ */
+int main(int argc, char **argv) {
+    std::size_t megabytes = 1024;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (std::string(argv[argument]) == "--explicit") {
+            HugePageArena::instance().useExplicitPages(true);
+        } else {
+            megabytes = std::stoull(argv[argument]);
+        }
+    }
+    const std::size_t bytes = megabytes * 1024 * 1024;
+    const std::size_t lookups = 20000000;
+
+    std::ifstream transparentHugePages("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string mode;
+    std::getline(transparentHugePages, mode);
+    std::cout << megabytes << " MB per queue and table, transparent huge pages: "
+              << (mode.empty() ? "unknown" : mode) << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(36) << "phase" << std::right << std::setw(10) << "seconds"
+              << std::setw(16) << "dTLB misses" << std::setw(12) << "per op" << std::setw(14) << "page faults"
+              << std::setw(12) << "THP MB" << std::endl;
+
+    std::uint64_t checksum = 0;
+    const std::size_t tasks = bytes / sizeof(QueuedTask<0>);
+    checksum += benchmarkQueue<QueuedTask<0>>("queue, normal pages,", tasks, lookups);
+    checksum += benchmarkQueue<QueuedTask<1>>("queue, huge pages,", tasks, lookups);
+
+    const std::size_t elements = bytes / sizeof(std::uint64_t);
+    checksum += benchmarkSharedTable<std::vector<std::uint64_t>>("table, normal pages,", elements, lookups);
+    checksum += benchmarkSharedTable<HugePageVector<std::uint64_t>>("table, huge pages,", elements, lookups);
+
+    const HugePageStatistics memory = HugePageArena::instance().memory();
+    std::cout << std::endl << "huge page arena: " << memory.mappedBytes / (1024 * 1024) << " MB mapped, "
+              << memory.explicitBytes / (1024 * 1024) << " MB explicit huge pages, "
+              << memory.allocatedBytes / (1024 * 1024) << " MB allocated, checksum " << checksum << std::endl;
+    return 0;
+}
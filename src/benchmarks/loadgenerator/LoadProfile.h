@@ -0,0 +1,283 @@
+#ifndef QT_MULTITHREADING_LOADPROFILE_H
+#define QT_MULTITHREADING_LOADPROFILE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "../../Serialization.h"
+
+using load_clock = std::chrono::steady_clock;
+
+/**
+ * The distribution from which the durations of the synthetic tasks are drawn
+ */
+enum class DurationDistribution {
+    /**
+     * Every task takes LoadProfile::meanDuration
+     */
+    Fixed,
+    /**
+     * Exponentially distributed durations with mean LoadProfile::meanDuration
+     */
+    Exponential,
+    /**
+     * A fraction of LoadProfile::longFraction of the tasks takes LoadProfile::longDuration,
+     * all other tasks take LoadProfile::shortDuration
+     */
+    Bimodal,
+    /**
+     * Pareto distributed durations with shape LoadProfile::paretoShape and mean LoadProfile::meanDuration,
+     * i.e. a heavy tail of very long tasks
+     */
+    Pareto
+};
+
+/**
+ * The way new tasks are given to the WorkerController
+ */
+enum class ArrivalProcess {
+    /**
+     * Open loop: tasks arrive with exponentially distributed gaps at LoadProfile::arrivalRate,
+     * regardless of how many tasks are still being fulfilled
+     */
+    Poisson,
+    /**
+     * Closed loop: LoadProfile::concurrency tasks are outstanding at all times,
+     * a new task is given for every received result
+     */
+    ClosedLoop
+};
+
+/**
+ * Describes the load the SyntheticProcessor generates
+ */
+struct LoadProfile {
+    /**
+     * See DurationDistribution
+     */
+    DurationDistribution distribution = DurationDistribution::Exponential;
+    /**
+     * The mean duration of a task for DurationDistribution::Fixed, DurationDistribution::Exponential
+     * and DurationDistribution::Pareto
+     */
+    std::chrono::nanoseconds meanDuration = std::chrono::microseconds(100);
+    /**
+     * The duration of the short tasks for DurationDistribution::Bimodal
+     */
+    std::chrono::nanoseconds shortDuration = std::chrono::microseconds(50);
+    /**
+     * The duration of the long tasks for DurationDistribution::Bimodal
+     */
+    std::chrono::nanoseconds longDuration = std::chrono::milliseconds(1);
+    /**
+     * The fraction of long tasks for DurationDistribution::Bimodal
+     */
+    double longFraction = 0.05;
+    /**
+     * The shape of DurationDistribution::Pareto, has to be greater than 1 for the mean to exist
+     */
+    double paretoShape = 1.5;
+    /**
+     * The number of bytes carried by every task
+     */
+    std::size_t taskPayloadSize = 64;
+    /**
+     * The number of bytes carried by every result
+     */
+    std::size_t resultPayloadSize = 64;
+    /**
+     * See ArrivalProcess
+     */
+    ArrivalProcess arrival = ArrivalProcess::Poisson;
+    /**
+     * The mean number of tasks arriving per second for ArrivalProcess::Poisson
+     */
+    double arrivalRate = 1000;
+    /**
+     * The number of outstanding tasks for ArrivalProcess::ClosedLoop
+     */
+    std::size_t concurrency = 1;
+    /**
+     * The total number of tasks to generate
+     */
+    std::size_t numberOfTasks = 10000;
+    /**
+     * The seed of the random number generator, so that runs are reproducible
+     */
+    std::uint64_t seed = 42;
+
+    /**
+     * Returns the mean duration of a task according to the distribution
+     *
+     * @return The mean duration of a task
+     */
+    [[nodiscard]] inline std::chrono::nanoseconds expectedDuration() const {
+        if (this->distribution == DurationDistribution::Bimodal) {
+            return std::chrono::nanoseconds(static_cast<std::int64_t>(
+                    (1 - this->longFraction) * static_cast<double>(this->shortDuration.count()) +
+                    this->longFraction * static_cast<double>(this->longDuration.count())
+            ));
+        }
+        return this->meanDuration;
+    }
+};
+
+/**
+ * Returns the name of a DurationDistribution
+ *
+ * @param distribution The DurationDistribution
+ * @return The name of \p distribution
+ */
+inline std::string distributionName(const DurationDistribution distribution) {
+    switch (distribution) {
+        case DurationDistribution::Fixed:
+            return "fixed";
+        case DurationDistribution::Exponential:
+            return "exponential";
+        case DurationDistribution::Bimodal:
+            return "bimodal";
+        case DurationDistribution::Pareto:
+            return "pareto";
+    }
+    return "unknown";
+}
+
+/**
+ * Draws task durations and arrival gaps according to a LoadProfile
+ */
+class LoadSampler {
+public:
+    /**
+     * Constructor used to initialize the LoadSampler
+     *
+     * @param profile The LoadProfile to sample from
+     */
+    explicit LoadSampler(const LoadProfile &profile) : profile(profile), generator(profile.seed) {}
+
+    /**
+     * Draws the duration of the next task
+     *
+     * @return The duration of the next task
+     */
+    inline std::chrono::nanoseconds duration() {
+        const auto mean = static_cast<double>(this->profile.meanDuration.count());
+        switch (this->profile.distribution) {
+            case DurationDistribution::Fixed:
+                return this->profile.meanDuration;
+            case DurationDistribution::Exponential:
+                return LoadSampler::toNanoseconds(std::exponential_distribution<double>(1 / mean)(this->generator));
+            case DurationDistribution::Bimodal:
+                return std::bernoulli_distribution(this->profile.longFraction)(this->generator)
+                       ? this->profile.longDuration : this->profile.shortDuration;
+            case DurationDistribution::Pareto: {
+                // inverse transform sampling, the scale is chosen so that the mean is LoadProfile::meanDuration
+                const double shape = this->profile.paretoShape;
+                const double scale = mean * (shape - 1) / shape;
+                const double uniform = 1 - std::uniform_real_distribution<double>(0, 1)(this->generator);
+                return LoadSampler::toNanoseconds(scale / std::pow(uniform, 1 / shape));
+            }
+        }
+        return this->profile.meanDuration;
+    }
+
+    /**
+     * Draws the gap between the previous and the next arrival of ArrivalProcess::Poisson
+     *
+     * @return The gap until the next arrival
+     */
+    inline std::chrono::nanoseconds arrivalGap() {
+        return LoadSampler::toNanoseconds(
+                std::exponential_distribution<double>(this->profile.arrivalRate / 1e9)(this->generator)
+        );
+    }
+
+private:
+    /**
+     * The LoadProfile to sample from
+     */
+    const LoadProfile profile;
+    /**
+     * The random number generator
+     */
+    std::mt19937_64 generator;
+
+    /**
+     * Converts a number of nanoseconds to std::chrono::nanoseconds, saturating at about 292 years
+     *
+     * @param nanoseconds The number of nanoseconds
+     * @return The converted duration
+     */
+    static inline std::chrono::nanoseconds toNanoseconds(const double nanoseconds) {
+        return std::chrono::nanoseconds(static_cast<std::int64_t>(std::min(nanoseconds, 9.2e18)));
+    }
+};
+
+/**
+ * A task generated by the SyntheticProcessor
+ */
+struct SyntheticTask {
+    /**
+     * The index of the task
+     */
+    std::size_t id = 0;
+    /**
+     * The time the SyntheticWorker has to spend on the task
+     */
+    std::chrono::nanoseconds duration{0};
+    /**
+     * The time at which the task has been given to the WorkerController
+     */
+    load_clock::time_point submitted;
+    /**
+     * Bytes carried by the task, see LoadProfile::taskPayloadSize
+     */
+    std::vector<char> payload;
+};
+
+/**
+ * The result of a SyntheticTask
+ */
+struct SyntheticResult {
+    /**
+     * See SyntheticTask::id
+     */
+    std::size_t id = 0;
+    /**
+     * See SyntheticTask::submitted
+     */
+    load_clock::time_point submitted;
+    /**
+     * The time at which the SyntheticWorker started fulfilling the task
+     */
+    load_clock::time_point started;
+    /**
+     * Bytes carried by the result, see LoadProfile::resultPayloadSize
+     */
+    std::vector<char> payload;
+};
+
+/**
+ * Serializer for SyntheticTask, so that the generated load can be recorded and replayed, see TaskRecorder
+ */
+template<>
+struct Serializer<SyntheticTask> {
+    static inline void write(BinaryWriter &writer, const SyntheticTask &task) {
+        writer.write(static_cast<std::uint64_t>(task.id));
+        writer.write(task.duration);
+        writer.write(task.submitted);
+        writer.write(task.payload);
+    }
+
+    static inline void read(BinaryReader &reader, SyntheticTask &task) {
+        task.id = reader.read<std::uint64_t>();
+        reader.read(task.duration);
+        reader.read(task.submitted);
+        reader.read(task.payload);
+    }
+};
+
+#endif
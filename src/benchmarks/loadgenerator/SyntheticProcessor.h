@@ -0,0 +1,256 @@
+#ifndef QT_MULTITHREADING_SYNTHETICPROCESSOR_H
+#define QT_MULTITHREADING_SYNTHETICPROCESSOR_H
+
+#include <QMutex>
+#include <QTimer>
+#include <QWaitCondition>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include "../../Processor.h"
+#include "LoadProfile.h"
+
+/**
+ * One point of a latency-vs-throughput curve, as measured by SyntheticProcessor::generate()
+ */
+struct LoadReport {
+    /**
+     * The number of tasks per second given to the WorkerController
+     */
+    double offeredRate = 0;
+    /**
+     * The number of results per second received
+     */
+    double throughput = 0;
+    /**
+     * The median time from giving a task until receiving its result, in microseconds
+     */
+    double p50 = 0;
+    /**
+     * The 99th percentile of the latency, in microseconds
+     */
+    double p99 = 0;
+    /**
+     * The 99.9th percentile of the latency, in microseconds
+     */
+    double p999 = 0;
+    /**
+     * The mean time a task has been waiting before a Worker started fulfilling it, in microseconds
+     */
+    double meanQueueing = 0;
+    /**
+     * The fraction of the tasks rejected by the admission control, see ControllerConfiguration::queueWaitTarget
+     */
+    double rejected = 0;
+};
+
+/**
+ * Processor generating synthetic tasks according to a LoadProfile and measuring the latency of their results. \n
+ * Together with the SyntheticWorker it replaces a real Worker/Processor pair, so that changes to the scheduling of the
+ * WorkerController can be evaluated with reproducible task mixes.
+ */
+class SyntheticProcessor : public Processor<SyntheticTask, SyntheticResult> {
+public:
+    /**
+     * Constructor for the Processor
+     *
+     * @param profile See SyntheticProcessor::profile
+     */
+    explicit SyntheticProcessor(const LoadProfile &profile) : profile(profile), sampler(profile) {}
+
+    /**
+     * Generates the load and blocks the calling thread until all results have been received. \n
+     * Must not be called from the thread of the Processor.
+     *
+     * @return The measured LoadReport
+     */
+    inline LoadReport generate() {
+        QMutexLocker locker(&this->mutex);
+        invokeInContext(
+                static_cast<QObject *>(this), Qt::QueuedConnection,
+                [this]() -> void { this->begin(); }
+        );
+        while (!this->done) {
+            this->finished.wait(&this->mutex);
+        }
+        return this->report;
+    }
+
+private:
+    /**
+     * The load to generate
+     */
+    const LoadProfile profile;
+    /**
+     * Draws the durations and arrival gaps
+     */
+    LoadSampler sampler;
+    /**
+     * The number of tasks given to the WorkerController so far
+     */
+    std::size_t generated = 0;
+    /**
+     * The time at which the first task has been given
+     */
+    load_clock::time_point start;
+    /**
+     * The scheduled time of the next arrival of ArrivalProcess::Poisson
+     */
+    load_clock::time_point nextArrival;
+    /**
+     * The time from giving each task until receiving its result, in nanoseconds
+     */
+    std::vector<std::int64_t> latencies;
+    /**
+     * The number of tasks rejected by the admission control
+     */
+    std::size_t rejected = 0;
+    /**
+     * The sum of the times the tasks have been waiting before being fulfilled, in nanoseconds
+     */
+    std::int64_t totalQueueing = 0;
+    /**
+     * Releases the arrivals of ArrivalProcess::Poisson
+     */
+    QTimer *arrivalTimer = nullptr;
+    /**
+     * Protects SyntheticProcessor::done and SyntheticProcessor::report
+     */
+    QMutex mutex;
+    /**
+     * Woken up when all results have been received
+     */
+    QWaitCondition finished;
+    /**
+     * Whether all results have been received
+     */
+    bool done = false;
+    /**
+     * The measured LoadReport
+     */
+    LoadReport report;
+
+    /**
+     * Creates the next task
+     *
+     * @param submitted See SyntheticTask::submitted
+     * @return The created task
+     */
+    inline SyntheticTask nextTask(const load_clock::time_point &submitted) {
+        SyntheticTask task;
+        task.id = this->generated++;
+        task.duration = this->sampler.duration();
+        task.submitted = submitted;
+        task.payload.assign(this->profile.taskPayloadSize, static_cast<char>(task.id));
+        return task;
+    }
+
+    /**
+     * Starts generating the load, called in the thread of the Processor
+     */
+    inline void begin() {
+        this->latencies.reserve(this->profile.numberOfTasks);
+        this->start = load_clock::now();
+
+        if (!this->profile.numberOfTasks) {
+            this->finish();
+            return;
+        }
+
+        if (this->profile.arrival == ArrivalProcess::ClosedLoop) {
+            std::deque<SyntheticTask> newTasks;
+            for (std::size_t i = 0; i < std::max<std::size_t>(this->profile.concurrency, 1) &&
+                                    this->generated < this->profile.numberOfTasks; ++i) {
+                newTasks.push_back(this->nextTask(this->start));
+            }
+            this->extendQueue(newTasks);
+        } else {
+            this->arrivalTimer = new QTimer(this);
+            this->arrivalTimer->setSingleShot(true);
+            this->arrivalTimer->setTimerType(Qt::PreciseTimer);
+            this->arrivalTimer->callOnTimeout([this]() -> void { this->releaseArrivals(); });
+            this->nextArrival = this->start + this->sampler.arrivalGap();
+            this->releaseArrivals();
+        }
+    }
+
+    /**
+     * Gives all tasks of ArrivalProcess::Poisson, whose scheduled arrival has passed, to the WorkerController
+     * and waits for the next arrival. \n
+     * The timer has a resolution of one millisecond, so arrivals are released in batches,
+     * the latency is measured from the actual release.
+     */
+    inline void releaseArrivals() {
+        const load_clock::time_point now = load_clock::now();
+        std::deque<SyntheticTask> newTasks;
+        while (this->nextArrival <= now && this->generated < this->profile.numberOfTasks) {
+            newTasks.push_back(this->nextTask(now));
+            this->nextArrival += this->sampler.arrivalGap();
+        }
+        if (!newTasks.empty()) {
+            // rejected tasks are dropped, like a server answering with an error instead of queueing the request
+            this->rejected += this->extendQueue(newTasks).rejected;
+            if (this->latencies.size() + this->rejected == this->profile.numberOfTasks) {
+                this->finish();
+                return;
+            }
+        }
+
+        if (this->generated < this->profile.numberOfTasks) {
+            const auto wait = std::chrono::ceil<std::chrono::milliseconds>(this->nextArrival - load_clock::now());
+            this->arrivalTimer->start(static_cast<int>(std::max<std::int64_t>(wait.count(), 0)));
+        }
+    }
+
+    /**
+     * Records the latency of the result and gives a new task for ArrivalProcess::ClosedLoop
+     *
+     * @param result The received result
+     */
+    inline void receiveResult(SyntheticResult &result) override {
+        const load_clock::time_point now = load_clock::now();
+        this->latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - result.submitted).count());
+        this->totalQueueing += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                result.started - result.submitted
+        ).count();
+
+        if (this->profile.arrival == ArrivalProcess::ClosedLoop && this->generated < this->profile.numberOfTasks) {
+            this->extendQueue({this->nextTask(now)});
+        }
+
+        if (this->latencies.size() + this->rejected == this->profile.numberOfTasks) {
+            this->finish();
+        }
+    }
+
+    /**
+     * Calculates the LoadReport and wakes up the thread waiting in SyntheticProcessor::generate()
+     */
+    inline void finish() {
+        const double seconds = std::chrono::duration<double>(load_clock::now() - this->start).count();
+        const auto received = static_cast<double>(this->latencies.size());
+        std::sort(this->latencies.begin(), this->latencies.end());
+
+        const auto percentile = [this](const double fraction) -> double {
+            if (this->latencies.empty()) {
+                return 0;
+            }
+            const auto index = static_cast<std::size_t>(fraction * static_cast<double>(this->latencies.size() - 1));
+            return static_cast<double>(this->latencies[index]) / 1e3;
+        };
+
+        QMutexLocker locker(&this->mutex);
+        this->report.offeredRate = this->profile.arrival == ArrivalProcess::Poisson
+                                   ? this->profile.arrivalRate : received / seconds;
+        this->report.throughput = received / seconds;
+        this->report.p50 = percentile(0.5);
+        this->report.p99 = percentile(0.99);
+        this->report.p999 = percentile(0.999);
+        this->report.meanQueueing = received ? static_cast<double>(this->totalQueueing) / received / 1e3 : 0;
+        this->report.rejected = static_cast<double>(this->rejected) / static_cast<double>(this->profile.numberOfTasks);
+        this->done = true;
+        this->finished.wakeAll();
+    }
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef QT_MULTITHREADING_SYNTHETICWORKER_H
+#define QT_MULTITHREADING_SYNTHETICWORKER_H
+
+#include "../../Worker.h"
+#include "LoadProfile.h"
+
+/**
+ * Worker busy waiting for the duration of each SyntheticTask, so that it occupies its thread like a real task would
+ */
+class SyntheticWorker : public Worker<SyntheticTask, SyntheticResult> {
+public:
+    /**
+     * Constructor for the Worker
+     *
+     * @param resultPayloadSize See SyntheticWorker::resultPayloadSize
+     */
+    explicit SyntheticWorker(const std::size_t resultPayloadSize) : resultPayloadSize(resultPayloadSize) {}
+
+private:
+    /**
+     * The number of bytes carried by every result, see LoadProfile::resultPayloadSize
+     */
+    const std::size_t resultPayloadSize;
+
+    /**
+     * Reads the payload of the task, busy waits for the duration of the task and creates the result
+     *
+     * @param task The task to fulfill
+     * @return The result of the task
+     */
+    inline SyntheticResult fulfillTask(SyntheticTask &task) override {
+        SyntheticResult result;
+        result.id = task.id;
+        result.submitted = task.submitted;
+        result.started = load_clock::now();
+
+        // touch every byte of the payload, as a real task would
+        char checksum = 0;
+        for (const char byte : task.payload) {
+            checksum = static_cast<char>(checksum ^ byte);
+        }
+
+        const load_clock::time_point end = result.started + task.duration;
+        while (load_clock::now() < end) {}
+
+        result.payload.assign(this->resultPayloadSize, checksum);
+        return result;
+    }
+
+    /**
+     * Clones the worker.
+     *
+     * @return The cloned worker
+     */
+    inline std::unique_ptr<Worker<SyntheticTask, SyntheticResult>> clone() override {
+        return std::make_unique<SyntheticWorker>(this->resultPayloadSize);
+    }
+};
+
+#endif
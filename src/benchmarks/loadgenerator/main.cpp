@@ -0,0 +1,101 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <QCoreApplication>
+#include <QThread>
+#include "../../Controller.h"
+#include "LoadProfile.h"
+#include "SyntheticProcessor.h"
+#include "SyntheticWorker.h"
+
+/**
+ * Generates one point of the latency-vs-throughput curve with a new Controller
+ *
+ * @param profile The load to generate
+ * @param numberOfThreads The number of threads to use
+ * @param configuration The configuration of the Controller, e.g. with a queue wait target
+ * @return The measured LoadReport
+ */
+LoadReport measure(const LoadProfile &profile, const std::size_t numberOfThreads,
+                   const ControllerConfiguration<SyntheticTask, SyntheticResult> &configuration) {
+    std::unique_ptr<SyntheticProcessor> processor = std::make_unique<SyntheticProcessor>(profile);
+    SyntheticProcessor *const processorPtr = processor.get();
+    Controller<SyntheticTask, SyntheticResult> controller(
+            std::move(processor), std::make_unique<SyntheticWorker>(profile.resultPayloadSize), numberOfThreads,
+            configuration
+    );
+    return processorPtr->generate();
+}
+
+/**
+ * Prints a LoadReport
+ *
+ * @param report The LoadReport to print
+ */
+void print(const LoadReport &report) {
+    std::cout << std::fixed << std::setprecision(1)
+              << std::setw(14) << report.offeredRate << std::setw(14) << report.throughput
+              << std::setw(12) << report.p50 << std::setw(12) << report.p99 << std::setw(12) << report.p999
+              << std::setw(16) << report.meanQueueing << std::setw(14) << 100 * report.rejected << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    // setup Qt stuff
+    QCoreApplication a(argc, argv);
+
+    // usage: [fixed|exponential|bimodal|pareto] [open|closed] [number of threads] [tasks per point] [payload bytes]
+    //        [queue wait target in microseconds, only for the open loop, which rejects tasks exceeding it]
+    const std::string distribution = argc > 1 ? argv[1] : "exponential";
+    const std::string arrival = argc > 2 ? argv[2] : "open";
+    const std::size_t numberOfThreads = argc > 3 ? std::stoul(argv[3]) : QThread::idealThreadCount();
+    const std::size_t tasksPerPoint = argc > 4 ? std::stoul(argv[4]) : 10000;
+    const std::size_t payloadSize = argc > 5 ? std::stoul(argv[5]) : 64;
+    ControllerConfiguration<SyntheticTask, SyntheticResult> configuration;
+    configuration.queueWaitTarget = std::chrono::microseconds(argc > 6 ? std::stoul(argv[6]) : 0);
+
+    LoadProfile profile;
+    profile.numberOfTasks = tasksPerPoint;
+    profile.taskPayloadSize = payloadSize;
+    profile.resultPayloadSize = payloadSize;
+    profile.arrival = arrival == "closed" ? ArrivalProcess::ClosedLoop : ArrivalProcess::Poisson;
+    for (const DurationDistribution candidate : {DurationDistribution::Fixed, DurationDistribution::Exponential,
+                                                 DurationDistribution::Bimodal, DurationDistribution::Pareto}) {
+        if (distributionName(candidate) == distribution) {
+            profile.distribution = candidate;
+        }
+    }
+
+    // the number of tasks per second all threads can fulfill at most
+    const double capacity = static_cast<double>(numberOfThreads) /
+                            std::chrono::duration<double>(profile.expectedDuration()).count();
+
+    std::cout << distributionName(profile.distribution) << " durations with a mean of "
+              << std::chrono::duration_cast<std::chrono::microseconds>(profile.expectedDuration()).count()
+              << " microseconds, " << (profile.arrival == ArrivalProcess::Poisson ? "open" : "closed")
+              << " loop, " << numberOfThreads << " threads, capacity of about " << static_cast<std::size_t>(capacity)
+              << " tasks/s" << std::endl << std::endl
+              << std::setw(14) << "offered [1/s]" << std::setw(14) << "tput [1/s]" << std::setw(12) << "p50 [us]"
+              << std::setw(12) << "p99 [us]" << std::setw(12) << "p99.9 [us]" << std::setw(16) << "queueing [us]"
+              << std::setw(14) << "rejected [%]" << std::endl;
+
+    if (profile.arrival == ArrivalProcess::Poisson) {
+        // open loop: increase the offered load up to and beyond the capacity, which only admission control survives
+        for (const double utilization : {0.1, 0.3, 0.5, 0.7, 0.8, 0.9, 0.95, 1.2}) {
+            profile.arrivalRate = utilization * capacity;
+            print(measure(profile, numberOfThreads, configuration));
+        }
+    } else {
+        // closed loop: increase the number of outstanding tasks
+        for (const std::size_t concurrency : {std::size_t(1), numberOfThreads / 2, numberOfThreads,
+                                              2 * numberOfThreads, 4 * numberOfThreads, 8 * numberOfThreads}) {
+            if (!concurrency) {
+                continue;
+            }
+            profile.concurrency = concurrency;
+            print(measure(profile, numberOfThreads, ControllerConfiguration<SyntheticTask, SyntheticResult>()));
+        }
+    }
+
+    return 0;
+}
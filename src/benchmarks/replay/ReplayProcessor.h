@@ -0,0 +1,72 @@
+#ifndef QT_MULTITHREADING_REPLAYPROCESSOR_H
+#define QT_MULTITHREADING_REPLAYPROCESSOR_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <deque>
+#include "../../Processor.h"
+#include "../loadgenerator/LoadProfile.h"
+
+/**
+ * Processor giving replayed tasks to the WorkerController and counting the received results
+ */
+class ReplayProcessor : public Processor<SyntheticTask, SyntheticResult> {
+public:
+    /**
+     * Gives tasks to the WorkerController, may be called from any thread
+     *
+     * @param newTasks The tasks to give
+     */
+    inline void submit(const std::deque<SyntheticTask> &newTasks) {
+        invokeInContext(
+                static_cast<QObject *>(this), Qt::QueuedConnection,
+                [this, newTasks]() -> void {
+                    // the recorded submission time refers to the recording, not to the replay
+                    std::deque<SyntheticTask> replayedTasks = newTasks;
+                    for (SyntheticTask &task : replayedTasks) {
+                        task.submitted = load_clock::now();
+                    }
+                    this->extendQueue(replayedTasks);
+                }
+        );
+    }
+
+    /**
+     * Blocks the calling thread until the given number of results has been received
+     *
+     * @param numberOfResults The number of results to wait for
+     */
+    inline void waitForResults(const std::size_t numberOfResults) {
+        QMutexLocker locker(&this->mutex);
+        while (this->received < numberOfResults) {
+            this->resultReceived.wait(&this->mutex);
+        }
+    }
+
+private:
+    /**
+     * Protects ReplayProcessor::received
+     */
+    QMutex mutex;
+    /**
+     * Woken up for every received result
+     */
+    QWaitCondition resultReceived;
+    /**
+     * The number of results received so far
+     */
+    std::size_t received = 0;
+
+    /**
+     * Counts the result
+     *
+     * @param result The received result
+     */
+    inline void receiveResult(SyntheticResult &) override {
+        QMutexLocker locker(&this->mutex);
+        ++this->received;
+        this->resultReceived.wakeAll();
+    }
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <QCoreApplication>
+#include <QThread>
+#include "../../Controller.h"
+#include "../loadgenerator/LoadProfile.h"
+#include "../loadgenerator/SyntheticProcessor.h"
+#include "../loadgenerator/SyntheticWorker.h"
+#include "ReplayProcessor.h"
+
+/**
+ * Returns a percentile of durations
+ *
+ * @param durations The durations, which are going to be sorted
+ * @param fraction The percentile in [0, 1]
+ * @return The percentile in microseconds
+ */
+double percentile(std::vector<std::chrono::nanoseconds> &durations, const double fraction) {
+    if (durations.empty()) {
+        return 0;
+    }
+    std::sort(durations.begin(), durations.end());
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(durations.size() - 1));
+    return std::chrono::duration<double, std::micro>(durations[index]).count();
+}
+
+/**
+ * Prints the queue waits and fulfill durations of a recording
+ *
+ * @param name The name to print
+ * @param fileName The recording
+ * @return \p true if the recording could be read, \p false otherwise
+ */
+bool summarize(const std::string &name, const QString &fileName) {
+    TaskReplayer<SyntheticTask> replayer;
+    if (!replayer.open(fileName) || replayer.submissions().empty()) {
+        std::cout << "could not read " << name << " recording" << std::endl;
+        return false;
+    }
+
+    // the ids of the submissions are consecutive
+    const std::uint64_t firstId = replayer.submissions().front().id;
+    std::vector<std::chrono::nanoseconds> waits, fulfillDurations;
+    for (const RecordedCompletion &completion : replayer.completions()) {
+        if (completion.id - firstId < replayer.submissions().size()) {
+            waits.push_back(completion.dispatched - replayer.submissions()[completion.id - firstId].offset);
+            fulfillDurations.push_back(completion.fulfillDuration);
+        }
+    }
+
+    const auto span = replayer.completions().empty() ? std::chrono::nanoseconds(0)
+                                                      : replayer.completions().back().finished;
+    std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << replayer.submissions().size()
+              << std::setw(12) << std::chrono::duration<double, std::milli>(span).count()
+              << std::setw(12) << percentile(waits, 0.5) << std::setw(12) << percentile(waits, 0.99)
+              << std::setw(14) << percentile(fulfillDurations, 0.5)
+              << std::setw(14) << percentile(fulfillDurations, 0.99) << std::endl;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    // setup Qt stuff
+    QCoreApplication a(argc, argv);
+
+    // usage: record <file> [number of tasks] [number of threads]
+    //        replay <file> [speed] [number of threads]
+    if (argc < 3) {
+        std::cout << "usage: " << argv[0] << " record <file> [number of tasks] [number of threads]" << std::endl
+                  << "       " << argv[0] << " replay <file> [speed] [number of threads]" << std::endl;
+        return 1;
+    }
+    const std::string mode = argv[1];
+    const QString fileName(argv[2]);
+    const std::size_t numberOfThreads = argc > 4 ? std::stoul(argv[4]) : QThread::idealThreadCount();
+
+    if (mode == "record") {
+        // record an exponential open loop load at about 80 % of the capacity
+        LoadProfile profile;
+        profile.numberOfTasks = argc > 3 ? std::stoul(argv[3]) : 10000;
+        profile.arrivalRate = 0.8 * static_cast<double>(numberOfThreads) /
+                              std::chrono::duration<double>(profile.expectedDuration()).count();
+
+        std::unique_ptr<SyntheticProcessor> processor = std::make_unique<SyntheticProcessor>(profile);
+        SyntheticProcessor *const processorPtr = processor.get();
+        Controller<SyntheticTask, SyntheticResult> controller(
+                std::move(processor), std::make_unique<SyntheticWorker>(profile.resultPayloadSize), numberOfThreads
+        );
+        if (!controller.startRecording(fileName)) {
+            std::cout << "could not open " << argv[2] << std::endl;
+            return 1;
+        }
+        processorPtr->generate();
+        controller.stopRecording();
+    } else {
+        const double speed = argc > 3 ? std::stod(argv[3]) : 1;
+        const QString replayFileName = fileName + ".replay";
+
+        TaskReplayer<SyntheticTask> replayer;
+        if (!replayer.open(fileName)) {
+            std::cout << "could not read " << argv[2] << std::endl;
+            return 1;
+        }
+
+        // replay into a new Controller, which records the replay, so that both can be compared
+        std::unique_ptr<ReplayProcessor> processor = std::make_unique<ReplayProcessor>();
+        ReplayProcessor *const processorPtr = processor.get();
+        Controller<SyntheticTask, SyntheticResult> controller(
+                std::move(processor), std::make_unique<SyntheticWorker>(64), numberOfThreads
+        );
+        controller.startRecording(replayFileName);
+        replayer.replay(
+                [processorPtr](const std::deque<SyntheticTask> &tasks) -> void { processorPtr->submit(tasks); }, speed
+        );
+        processorPtr->waitForResults(replayer.submissions().size());
+        controller.stopRecording();
+
+        std::cout << std::left << std::setw(10) << "recording" << std::right << std::setw(10) << "tasks"
+                  << std::setw(12) << "span [ms]" << std::setw(12) << "wait p50" << std::setw(12) << "wait p99"
+                  << std::setw(14) << "fulfill p50" << std::setw(14) << "fulfill p99" << std::endl;
+        summarize("original", fileName);
+        summarize("replay", replayFileName);
+    }
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../../Serialization.h"
+
+using benchmark_clock = std::chrono::steady_clock;
+using time_point = std::chrono::time_point<std::chrono::high_resolution_clock>;
+// the task and result types of example three
+using return_tuple = std::tuple<unsigned int, unsigned int, time_point>;
+using result_tuple = std::tuple<unsigned int, unsigned int, time_point, time_point>;
+
+/**
+ * Serializes and deserializes \p values \p repetitions times and prints the throughput of both directions
+ *
+ * @tparam T The data type to benchmark
+ * @param name The name to print
+ * @param values The values to serialize
+ * @param repetitions How often to serialize and deserialize all values
+ */
+template<typename T>
+void benchmark(const std::string &name, const std::vector<T> &values, const std::size_t repetitions) {
+    // the buffer is reused for every repetition, just like the framework does it
+    std::vector<char> buffer;
+
+    const auto serializeStart = benchmark_clock::now();
+    for (std::size_t repetition = 0; repetition < repetitions; ++repetition) {
+        buffer.clear();
+        BinaryWriter writer(buffer);
+        for (const T &value : values) {
+            writer.write(value);
+        }
+    }
+    const std::chrono::duration<double> serializeDuration = benchmark_clock::now() - serializeStart;
+
+    std::vector<T> readValues(values.size());
+    bool allRead = true;
+    const auto deserializeStart = benchmark_clock::now();
+    for (std::size_t repetition = 0; repetition < repetitions; ++repetition) {
+        BinaryReader reader(buffer);
+        for (T &value : readValues) {
+            reader.read(value);
+        }
+        allRead = allRead && reader.ok() && !reader.remaining();
+    }
+    const std::chrono::duration<double> deserializeDuration = benchmark_clock::now() - deserializeStart;
+
+    // comparing also prevents the compiler from optimizing everything away
+    const bool correct = allRead && readValues == values;
+
+    const double megabytes = static_cast<double>(buffer.size() * repetitions) / (1024.0 * 1024.0);
+    const double millionItems = static_cast<double>(values.size() * repetitions) / 1e6;
+
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << megabytes / serializeDuration.count() << " MB/s"
+              << std::setw(12) << millionItems / serializeDuration.count() << " M/s"
+              << std::setw(12) << megabytes / deserializeDuration.count() << " MB/s"
+              << std::setw(12) << millionItems / deserializeDuration.count() << " M/s"
+              << (correct ? "" : "   MISMATCH") << std::endl;
+}
+
+int main() {
+    constexpr std::size_t numberOfValues = 1000000;
+    constexpr std::size_t repetitions = 10;
+    const time_point now = std::chrono::high_resolution_clock::now();
+
+    std::cout << std::left << std::setw(28) << "type" << std::right
+              << std::setw(17) << "serialize" << std::setw(16) << ""
+              << std::setw(17) << "deserialize" << std::endl;
+
+    std::vector<unsigned int> integers(numberOfValues);
+    for (std::size_t i = 0; i < numberOfValues; ++i) {
+        integers[i] = static_cast<unsigned int>(i);
+    }
+    benchmark("unsigned int", integers, repetitions);
+
+    std::vector<return_tuple> returnTuples(numberOfValues);
+    for (std::size_t i = 0; i < numberOfValues; ++i) {
+        returnTuples[i] = std::make_tuple(i, i % 350, now);
+    }
+    benchmark("return_tuple", returnTuples, repetitions);
+
+    std::vector<result_tuple> resultTuples(numberOfValues);
+    for (std::size_t i = 0; i < numberOfValues; ++i) {
+        resultTuples[i] = std::make_tuple(i, i % 350, now, now + std::chrono::microseconds(i));
+    }
+    benchmark("result_tuple", resultTuples, repetitions);
+
+    std::vector<std::chrono::nanoseconds> durations(numberOfValues);
+    for (std::size_t i = 0; i < numberOfValues; ++i) {
+        durations[i] = std::chrono::nanoseconds(i);
+    }
+    benchmark("std::chrono::nanoseconds", durations, repetitions);
+
+    std::vector<std::string> strings(numberOfValues, std::string(32, 'x'));
+    benchmark("std::string (32 chars)", strings, repetitions);
+
+    std::vector<std::vector<double>> vectors(numberOfValues / 1000, std::vector<double>(1000, 0.5));
+    benchmark("std::vector<double> (1000)", vectors, repetitions);
+
+    std::vector<std::pair<int, std::string>> pairs(numberOfValues, std::make_pair(42, std::string(16, 'y')));
+    benchmark("std::pair<int, std::string>", pairs, repetitions);
+
+    return 0;
+}
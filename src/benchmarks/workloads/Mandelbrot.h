@@ -0,0 +1,161 @@
+#ifndef QT_MULTITHREADING_MANDELBROT_H
+#define QT_MULTITHREADING_MANDELBROT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "../../Worker.h"
+
+/**
+ * The rendered section of the Mandelbrot set
+ */
+struct MandelbrotImage {
+    /**
+     * The width of the image in pixels
+     */
+    std::size_t width = 1920;
+    /**
+     * The height of the image in pixels
+     */
+    std::size_t height = 1080;
+    /**
+     * The edge length of the square tiles rendered as one task
+     */
+    std::size_t tileSize = 64;
+    /**
+     * The number of iterations after which a point is considered to be part of the set
+     */
+    std::uint16_t maxIterations = 1000;
+    /**
+     * The real part of the point in the center of the image
+     */
+    double centerReal = -0.743;
+    /**
+     * The imaginary part of the point in the center of the image
+     */
+    double centerImaginary = 0.131;
+    /**
+     * The distance between two neighbouring pixels in the complex plane
+     */
+    double pixelSize = 0.05 / 1920;
+};
+
+/**
+ * A rectangle of the MandelbrotImage rendered as one task
+ */
+struct MandelbrotTile {
+    /**
+     * The column of the top left pixel
+     */
+    std::size_t x = 0;
+    /**
+     * The row of the top left pixel
+     */
+    std::size_t y = 0;
+    /**
+     * The width of the tile in pixels, less than MandelbrotImage::tileSize at the right edge
+     */
+    std::size_t width = 0;
+    /**
+     * The height of the tile in pixels, less than MandelbrotImage::tileSize at the bottom edge
+     */
+    std::size_t height = 0;
+};
+
+/**
+ * The rendered MandelbrotTile
+ */
+struct MandelbrotTileResult {
+    /**
+     * The rendered tile
+     */
+    MandelbrotTile tile;
+    /**
+     * The number of iterations of every pixel of the tile, row by row
+     */
+    std::vector<std::uint16_t> iterations;
+};
+
+/**
+ * Cuts the MandelbrotImage into tiles
+ *
+ * @param image The image to render
+ * @return The tiles covering the whole image
+ */
+inline std::deque<MandelbrotTile> mandelbrotTiles(const MandelbrotImage &image) {
+    std::deque<MandelbrotTile> tiles;
+    for (std::size_t y = 0; y < image.height; y += image.tileSize) {
+        for (std::size_t x = 0; x < image.width; x += image.tileSize) {
+            tiles.push_back(MandelbrotTile{
+                    x, y, std::min(image.tileSize, image.width - x), std::min(image.tileSize, image.height - y)
+            });
+        }
+    }
+    return tiles;
+}
+
+/**
+ * Worker rendering a MandelbrotTile with the escape time algorithm. \n
+ * The tiles close to the set take far longer than the others, which makes the load unbalanced, like in many real
+ * applications.
+ */
+class MandelbrotWorker : public Worker<MandelbrotTile, MandelbrotTileResult> {
+public:
+    /**
+     * Constructor for the Worker
+     *
+     * @param image See MandelbrotWorker::image
+     */
+    explicit MandelbrotWorker(const MandelbrotImage &image) : image(image) {}
+
+private:
+    /**
+     * The image the tiles are part of
+     */
+    const MandelbrotImage image;
+
+    /**
+     * Renders the tile
+     *
+     * @param task The tile to render
+     * @return The number of iterations of every pixel of the tile
+     */
+    inline MandelbrotTileResult fulfillTask(MandelbrotTile &task) override {
+        MandelbrotTileResult result;
+        result.tile = task;
+        result.iterations.reserve(task.width * task.height);
+
+        const double left = this->image.centerReal - this->image.pixelSize * static_cast<double>(this->image.width) / 2;
+        const double top =
+                this->image.centerImaginary - this->image.pixelSize * static_cast<double>(this->image.height) / 2;
+        for (std::size_t y = task.y; y < task.y + task.height; ++y) {
+            const double imaginary = top + this->image.pixelSize * static_cast<double>(y);
+            for (std::size_t x = task.x; x < task.x + task.width; ++x) {
+                const double real = left + this->image.pixelSize * static_cast<double>(x);
+                double zReal = 0, zImaginary = 0;
+                std::uint16_t iteration = 0;
+                while (iteration < this->image.maxIterations && zReal * zReal + zImaginary * zImaginary <= 4) {
+                    const double nextReal = zReal * zReal - zImaginary * zImaginary + real;
+                    zImaginary = 2 * zReal * zImaginary + imaginary;
+                    zReal = nextReal;
+                    ++iteration;
+                }
+                result.iterations.push_back(iteration);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Clones the worker.
+     *
+     * @return The cloned worker
+     */
+    inline std::unique_ptr<Worker<MandelbrotTile, MandelbrotTileResult>> clone() override {
+        return std::make_unique<MandelbrotWorker>(this->image);
+    }
+};
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef QT_MULTITHREADING_MATRIXMULTIPLICATION_H
+#define QT_MULTITHREADING_MATRIXMULTIPLICATION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../../Worker.h"
+
+/**
+ * A square matrix of doubles, stored row by row
+ */
+struct Matrix {
+    /**
+     * Creates a matrix filled with zeros
+     *
+     * @param size See Matrix::size
+     */
+    explicit Matrix(const std::size_t size) : size(size), values(size * size) {}
+
+    /**
+     * Creates a matrix filled with pseudo random numbers between -1 and 1
+     *
+     * @param size See Matrix::size
+     * @param seed The seed of the pseudo random numbers, so that every run multiplies the same matrices
+     * @return The created matrix
+     */
+    static inline Matrix random(const std::size_t size, const unsigned int seed) {
+        Matrix matrix(size);
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> distribution(-1, 1);
+        for (double &value : matrix.values) {
+            value = distribution(generator);
+        }
+        return matrix;
+    }
+
+    /**
+     * The number of rows, which is the same as the number of columns
+     */
+    std::size_t size;
+    /**
+     * The entries of the matrix, row by row
+     */
+    std::vector<double> values;
+};
+
+/**
+ * A block of the product of two Matrix, calculated as one task
+ */
+struct MatrixBlock {
+    /**
+     * The first row of the block
+     */
+    std::size_t row = 0;
+    /**
+     * The first column of the block
+     */
+    std::size_t column = 0;
+    /**
+     * The number of rows of the block
+     */
+    std::size_t rows = 0;
+    /**
+     * The number of columns of the block
+     */
+    std::size_t columns = 0;
+};
+
+/**
+ * The calculated MatrixBlock
+ */
+struct MatrixBlockResult {
+    /**
+     * The calculated block
+     */
+    MatrixBlock block;
+    /**
+     * The entries of the block, row by row
+     */
+    std::vector<double> values;
+};
+
+/**
+ * Cuts the product of two matrices into blocks
+ *
+ * @param size The number of rows and columns of the product
+ * @param blockSize The edge length of the blocks
+ * @return The blocks covering the whole product
+ */
+inline std::deque<MatrixBlock> matrixBlocks(const std::size_t size, const std::size_t blockSize) {
+    std::deque<MatrixBlock> blocks;
+    for (std::size_t row = 0; row < size; row += blockSize) {
+        for (std::size_t column = 0; column < size; column += blockSize) {
+            blocks.push_back(MatrixBlock{
+                    row, column, std::min(blockSize, size - row), std::min(blockSize, size - column)
+            });
+        }
+    }
+    return blocks;
+}
+
+/**
+ * Worker calculating a MatrixBlock of the product of two matrices, which are shared by all Worker. \n
+ * The inner dimension is blocked as well, so that the parts of both matrices used together stay in the cache,
+ * and the innermost loop runs along the rows, so that the compiler is able to vectorize it.
+ */
+class MatrixMultiplicationWorker : public Worker<MatrixBlock, MatrixBlockResult> {
+public:
+    /**
+     * Constructor for the Worker
+     *
+     * @param left See MatrixMultiplicationWorker::left
+     * @param right See MatrixMultiplicationWorker::right
+     * @param blockSize See MatrixMultiplicationWorker::blockSize
+     */
+    MatrixMultiplicationWorker(std::shared_ptr<const Matrix> left, std::shared_ptr<const Matrix> right,
+                               const std::size_t blockSize)
+            : left(std::move(left)), right(std::move(right)), blockSize(blockSize) {}
+
+private:
+    /**
+     * The left factor, only read
+     */
+    const std::shared_ptr<const Matrix> left;
+    /**
+     * The right factor, only read
+     */
+    const std::shared_ptr<const Matrix> right;
+    /**
+     * The length of the blocks of the inner dimension
+     */
+    const std::size_t blockSize;
+
+    /**
+     * Calculates the block
+     *
+     * @param task The block to calculate
+     * @return The entries of the block
+     */
+    inline MatrixBlockResult fulfillTask(MatrixBlock &task) override {
+        MatrixBlockResult result;
+        result.block = task;
+        result.values.assign(task.rows * task.columns, 0);
+
+        const std::size_t size = this->left->size;
+        for (std::size_t inner = 0; inner < size; inner += this->blockSize) {
+            const std::size_t innerEnd = std::min(inner + this->blockSize, size);
+            for (std::size_t row = 0; row < task.rows; ++row) {
+                const double *const leftRow = this->left->values.data() + (task.row + row) * size;
+                double *const resultRow = result.values.data() + row * task.columns;
+                for (std::size_t k = inner; k < innerEnd; ++k) {
+                    const double factor = leftRow[k];
+                    const double *const rightRow = this->right->values.data() + k * size + task.column;
+                    for (std::size_t column = 0; column < task.columns; ++column) {
+                        resultRow[column] += factor * rightRow[column];
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Clones the worker, the clones share the matrices.
+     *
+     * @return The cloned worker
+     */
+    inline std::unique_ptr<Worker<MatrixBlock, MatrixBlockResult>> clone() override {
+        return std::make_unique<MatrixMultiplicationWorker>(this->left, this->right, this->blockSize);
+    }
+};
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef QT_MULTITHREADING_SHA256_H
+#define QT_MULTITHREADING_SHA256_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "../../Worker.h"
+
+/**
+ * Calculates the SHA-256 digest of a stream of bytes, see FIPS 180-4
+ */
+class Sha256 {
+public:
+    /**
+     * Appends bytes to the hashed stream
+     *
+     * @param data Pointer to the bytes
+     * @param size The number of bytes
+     */
+    inline void update(const char *data, std::size_t size) {
+        this->length += size;
+        if (this->buffered) {
+            const std::size_t taken = std::min(size, this->block.size() - this->buffered);
+            std::memcpy(this->block.data() + this->buffered, data, taken);
+            this->buffered += taken;
+            data += taken;
+            size -= taken;
+            if (this->buffered < this->block.size()) {
+                return;
+            }
+            this->compress(this->block.data());
+            this->buffered = 0;
+        }
+        for (; size >= this->block.size(); data += this->block.size(), size -= this->block.size()) {
+            this->compress(reinterpret_cast<const unsigned char *>(data));
+        }
+        std::memcpy(this->block.data(), data, size);
+        this->buffered = size;
+    }
+
+    /**
+     * Completes the digest, the Sha256 must not be used afterwards
+     *
+     * @return The digest as 64 lower case hexadecimal digits
+     */
+    inline std::string finish() {
+        const std::uint64_t bits = this->length * 8;
+        const char padding = static_cast<char>(0x80);
+        this->update(&padding, 1);
+        const char zero = 0;
+        while (this->buffered != this->block.size() - sizeof(bits)) {
+            this->update(&zero, 1);
+        }
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            const char byte = static_cast<char>(bits >> static_cast<unsigned int>(shift));
+            this->update(&byte, 1);
+        }
+
+        static const char *const digits = "0123456789abcdef";
+        std::string digest;
+        for (const std::uint32_t word : this->state) {
+            for (int shift = 28; shift >= 0; shift -= 4) {
+                digest.push_back(digits[(word >> static_cast<unsigned int>(shift)) & 0xfu]);
+            }
+        }
+        return digest;
+    }
+
+private:
+    /**
+     * The intermediate hash value
+     */
+    std::array<std::uint32_t, 8> state = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    /**
+     * The bytes of the current block not yet compressed
+     */
+    std::array<unsigned char, 64> block{};
+    /**
+     * The number of bytes in Sha256::block
+     */
+    std::size_t buffered = 0;
+    /**
+     * The number of bytes of the hashed stream
+     */
+    std::uint64_t length = 0;
+
+    /**
+     * Rotates a word to the right
+     *
+     * @param word The word to rotate
+     * @param bits The number of bits to rotate by
+     * @return The rotated word
+     */
+    static inline std::uint32_t rotate(const std::uint32_t word, const unsigned int bits) {
+        return (word >> bits) | (word << (32u - bits));
+    }
+
+    /**
+     * Mixes a block of 64 bytes into Sha256::state
+     *
+     * @param data Pointer to the block
+     */
+    inline void compress(const unsigned char *const data) {
+        static constexpr std::array<std::uint32_t, 64> constants = {
+                0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+                0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+                0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+                0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+                0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+                0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+                0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+                0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+
+        std::array<std::uint32_t, 64> schedule{};
+        for (std::size_t i = 0; i < 16; ++i) {
+            schedule[i] = static_cast<std::uint32_t>(data[4 * i]) << 24u |
+                          static_cast<std::uint32_t>(data[4 * i + 1]) << 16u |
+                          static_cast<std::uint32_t>(data[4 * i + 2]) << 8u |
+                          static_cast<std::uint32_t>(data[4 * i + 3]);
+        }
+        for (std::size_t i = 16; i < 64; ++i) {
+            const std::uint32_t s0 = rotate(schedule[i - 15], 7) ^ rotate(schedule[i - 15], 18) ^
+                                     (schedule[i - 15] >> 3u);
+            const std::uint32_t s1 = rotate(schedule[i - 2], 17) ^ rotate(schedule[i - 2], 19) ^
+                                     (schedule[i - 2] >> 10u);
+            schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+        }
+
+        std::uint32_t a = this->state[0], b = this->state[1], c = this->state[2], d = this->state[3];
+        std::uint32_t e = this->state[4], f = this->state[5], g = this->state[6], h = this->state[7];
+        for (std::size_t i = 0; i < 64; ++i) {
+            const std::uint32_t s1 = rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25);
+            const std::uint32_t choice = (e & f) ^ (~e & g);
+            const std::uint32_t temporary1 = h + s1 + choice + constants[i] + schedule[i];
+            const std::uint32_t s0 = rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22);
+            const std::uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+            const std::uint32_t temporary2 = s0 + majority;
+            h = g;
+            g = f;
+            f = e;
+            e = d + temporary1;
+            d = c;
+            c = b;
+            b = a;
+            a = temporary1 + temporary2;
+        }
+        this->state[0] += a;
+        this->state[1] += b;
+        this->state[2] += c;
+        this->state[3] += d;
+        this->state[4] += e;
+        this->state[5] += f;
+        this->state[6] += g;
+        this->state[7] += h;
+    }
+};
+
+/**
+ * The SHA-256 digest of a file
+ */
+struct FileDigest {
+    /**
+     * The name of the file
+     */
+    std::string fileName;
+    /**
+     * The number of bytes hashed
+     */
+    std::uint64_t bytes = 0;
+    /**
+     * The digest as 64 lower case hexadecimal digits, empty if the file could not be read
+     */
+    std::string digest;
+};
+
+/**
+ * Lists all regular files of a directory tree
+ *
+ * @param directory The root of the directory tree
+ * @return The names of the files, sorted so that every run hashes the files in the same order
+ */
+inline std::deque<std::string> filesBelow(const std::string &directory) {
+    std::vector<std::string> fileNames;
+    std::error_code error;
+    for (auto it = std::filesystem::recursive_directory_iterator(
+            directory, std::filesystem::directory_options::skip_permission_denied, error
+    ); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+        if (it->is_regular_file(error)) {
+            fileNames.push_back(it->path().string());
+        }
+    }
+    std::sort(fileNames.begin(), fileNames.end());
+    return std::deque<std::string>(fileNames.begin(), fileNames.end());
+}
+
+/**
+ * Worker calculating the SHA-256 digest of a file, which it reads in blocks
+ */
+class Sha256Worker : public Worker<std::string, FileDigest> {
+private:
+    /**
+     * The block read from the file, kept to reuse the allocation
+     */
+    std::vector<char> buffer = std::vector<char>(1u << 16u);
+
+    /**
+     * Reads and hashes the file
+     *
+     * @param task The name of the file
+     * @return The digest of the file
+     */
+    inline FileDigest fulfillTask(std::string &task) override {
+        FileDigest result;
+        result.fileName = task;
+        std::ifstream file(task, std::ios::binary);
+        if (!file) {
+            return result;
+        }
+
+        Sha256 sha256;
+        while (file) {
+            file.read(this->buffer.data(), static_cast<std::streamsize>(this->buffer.size()));
+            const auto read = static_cast<std::size_t>(file.gcount());
+            sha256.update(this->buffer.data(), read);
+            result.bytes += read;
+        }
+        result.digest = sha256.finish();
+        return result;
+    }
+
+    /**
+     * Clones the worker.
+     *
+     * @return The cloned worker
+     */
+    inline std::unique_ptr<Worker<std::string, FileDigest>> clone() override {
+        return std::make_unique<Sha256Worker>();
+    }
+};
+
+#endif
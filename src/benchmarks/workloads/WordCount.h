@@ -0,0 +1,126 @@
+#ifndef QT_MULTITHREADING_WORDCOUNT_H
+#define QT_MULTITHREADING_WORDCOUNT_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include "../../Worker.h"
+
+/**
+ * A part of a text file counted as one task
+ */
+struct TextChunk {
+    /**
+     * The name of the file
+     */
+    std::string fileName;
+    /**
+     * The position of the first byte of the chunk
+     */
+    std::uint64_t offset = 0;
+    /**
+     * The number of bytes of the chunk
+     */
+    std::uint64_t length = 0;
+};
+
+/**
+ * The number of occurrences of every word
+ */
+using WordCounts = std::unordered_map<std::string, std::uint64_t>;
+
+/**
+ * Returns, whether a byte is part of a word, which are sequences of letters and digits
+ *
+ * @param byte The byte to check
+ * @return \p true if the byte is part of a word, \p false if it separates words
+ */
+inline bool isWordByte(const char byte) {
+    return std::isalnum(static_cast<unsigned char>(byte));
+}
+
+/**
+ * Cuts a text file into chunks. \n
+ * Every chunk ends behind a byte separating words, so that no word is split between two chunks.
+ *
+ * @param fileName The name of the file
+ * @param chunkSize The number of bytes of a chunk, chunks are slightly longer to end between two words
+ * @return The chunks covering the whole file, empty if the file could not be read
+ */
+inline std::deque<TextChunk> textChunks(const std::string &fileName, const std::uint64_t chunkSize) {
+    std::deque<TextChunk> chunks;
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return chunks;
+    }
+    const auto fileSize = static_cast<std::uint64_t>(file.tellg());
+
+    std::uint64_t offset = 0;
+    while (offset < fileSize) {
+        std::uint64_t end = std::min(offset + chunkSize, fileSize);
+        file.seekg(static_cast<std::streamoff>(end));
+        char byte = 0;
+        while (end < fileSize && file.get(byte) && isWordByte(byte)) {
+            ++end;
+        }
+        chunks.push_back(TextChunk{fileName, offset, end - offset});
+        offset = end;
+    }
+    return chunks;
+}
+
+/**
+ * Worker counting the words of a TextChunk, ignoring case. \n
+ * Every Worker reads its chunk itself, so that reading the file is parallelized as well.
+ */
+class WordCountWorker : public Worker<TextChunk, WordCounts> {
+private:
+    /**
+     * The bytes of the current chunk, kept to reuse the allocation
+     */
+    std::string text;
+
+    /**
+     * Reads and counts the chunk
+     *
+     * @param task The chunk to count
+     * @return The number of occurrences of every word in the chunk
+     */
+    inline WordCounts fulfillTask(TextChunk &task) override {
+        WordCounts counts;
+        std::ifstream file(task.fileName, std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(task.offset));
+        this->text.resize(task.length);
+        file.read(this->text.data(), static_cast<std::streamsize>(task.length));
+        this->text.resize(static_cast<std::size_t>(file.gcount()));
+
+        std::string word;
+        for (const char byte : this->text) {
+            if (isWordByte(byte)) {
+                word.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(byte))));
+            } else if (!word.empty()) {
+                ++counts[word];
+                word.clear();
+            }
+        }
+        if (!word.empty()) {
+            ++counts[word];
+        }
+        return counts;
+    }
+
+    /**
+     * Clones the worker.
+     *
+     * @return The cloned worker
+     */
+    inline std::unique_ptr<Worker<TextChunk, WordCounts>> clone() override {
+        return std::make_unique<WordCountWorker>();
+    }
+};
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef QT_MULTITHREADING_WORKLOADPROCESSOR_H
+#define QT_MULTITHREADING_WORKLOADPROCESSOR_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <utility>
+#include "../../Processor.h"
+
+/**
+ * Processor giving a fixed set of tasks to the WorkerController at once and measuring the time until the last result
+ * has been received. \n
+ * The results are handed to a function in the thread of the Processor, e.g. to assemble the image of a Mandelbrot
+ * rendering, so that the cost of processing the results is part of the measurement, like it would be in a real
+ * application.
+ *
+ * @tparam T The data type of the task to fulfill
+ * @tparam R The data type of the result calculated during fulfilling the task
+ */
+template<typename T, typename R>
+class WorkloadProcessor : public Processor<T, R> {
+public:
+    /**
+     * Constructor for the Processor
+     *
+     * @param consume See WorkloadProcessor::consume
+     */
+    explicit WorkloadProcessor(std::function<void(R &)> consume) : consume(std::move(consume)) {}
+
+    /**
+     * Gives all tasks to the WorkerController and blocks the calling thread until all results have been received. \n
+     * Must not be called from the thread of the Processor.
+     *
+     * @param newTasks The tasks to fulfill, every task has to produce exactly one result
+     * @return The time from giving the tasks until receiving the last result
+     */
+    inline std::chrono::nanoseconds run(const std::deque<T> &newTasks) {
+        QMutexLocker locker(&this->mutex);
+        this->tasks = newTasks;
+        this->received = 0;
+        this->done = false;
+        invokeInContext(
+                static_cast<QObject *>(this), Qt::QueuedConnection,
+                [this]() -> void { this->begin(); }
+        );
+        while (!this->done) {
+            this->finished.wait(&this->mutex);
+        }
+        return this->duration;
+    }
+
+private:
+    /**
+     * Called with every result in the thread of the Processor
+     */
+    const std::function<void(R &)> consume;
+    /**
+     * The tasks given to the WorkerController by WorkloadProcessor::run
+     */
+    std::deque<T> tasks;
+    /**
+     * The number of results received during the current run
+     */
+    std::size_t received = 0;
+    /**
+     * The time at which the tasks have been given to the WorkerController
+     */
+    std::chrono::steady_clock::time_point start;
+    /**
+     * Protects WorkloadProcessor::done and WorkloadProcessor::duration
+     */
+    QMutex mutex;
+    /**
+     * Woken up when all results have been received
+     */
+    QWaitCondition finished;
+    /**
+     * Whether all results of the current run have been received
+     */
+    bool done = false;
+    /**
+     * The measured time of the current run
+     */
+    std::chrono::nanoseconds duration{0};
+
+    /**
+     * Gives the tasks to the WorkerController, called in the thread of the Processor
+     */
+    inline void begin() {
+        this->start = std::chrono::steady_clock::now();
+        if (this->tasks.empty()) {
+            this->finish();
+            return;
+        }
+        this->extendQueue(this->tasks);
+    }
+
+    /**
+     * Hands the result to WorkloadProcessor::consume and finishes the run with the last result
+     *
+     * @param result The result calculated by a Worker
+     */
+    inline void receiveResult(R &result) override {
+        this->consume(result);
+        if (++this->received == this->tasks.size()) {
+            this->finish();
+        }
+    }
+
+    /**
+     * Wakes up the thread waiting in WorkloadProcessor::run
+     */
+    inline void finish() {
+        const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - this->start;
+        QMutexLocker locker(&this->mutex);
+        this->duration = elapsed;
+        this->done = true;
+        this->finished.wakeAll();
+    }
+};
+
+#endif
@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <QCoreApplication>
+#include <QThread>
+#include "../../Controller.h"
+#include "Mandelbrot.h"
+#include "MatrixMultiplication.h"
+#include "Sha256.h"
+#include "WordCount.h"
+#include "WorkloadProcessor.h"
+
+/**
+ * Fulfills the same tasks with a new Controller for every number of threads and prints the throughput. \n
+ * An untimed run with the largest number of threads comes first, so that e.g. the files are in the page cache for all
+ * measured runs. The last run lets the AutoTuner choose the number of Worker and the dispatch batch size, up to the
+ * largest number of threads, see ControllerConfiguration::autoTuning.
+ *
+ * @tparam T The data type of the task to fulfill
+ * @tparam R The data type of the result calculated during fulfilling the task
+ * @param name The name of the workload
+ * @param unit The unit of the throughput, e.g. "MB/s"
+ * @param units The amount of work of all tasks in the unit of the throughput, e.g. the number of megabytes
+ * @param tasks The tasks to fulfill
+ * @param createWorker Creates the Worker for every run
+ * @param consume Called with every result in the thread of the Processor
+ * @param summary Called after every run, returns something to compare the runs by and resets what consume collected
+ * @param threadCounts The numbers of threads to measure
+ */
+template<typename T, typename R>
+void measureScaling(const std::string &name, const std::string &unit, const double units, const std::deque<T> &tasks,
+                    const std::function<std::unique_ptr<Worker<T, R>>()> &createWorker,
+                    const std::function<void(R &)> &consume,
+                    const std::function<std::string()> &summary, const std::vector<std::size_t> &threadCounts) {
+    std::cout << std::endl << "--- " << name << ": " << tasks.size() << " tasks ---" << std::endl
+              << std::setw(8) << "threads" << std::setw(12) << "seconds" << std::setw(16) << unit
+              << std::setw(10) << "speedup" << "  result" << std::endl;
+
+    double baseline = 0;
+    for (std::size_t run = 0; run <= threadCounts.size() + 1; ++run) {
+        const bool autoTuned = run > threadCounts.size();
+        const std::size_t numberOfThreads = run && !autoTuned ? threadCounts[run - 1] : threadCounts.back();
+        ControllerConfiguration<T, R> configuration;
+        configuration.autoTuning = autoTuned;
+        // the workloads take a few seconds, so the rounds have to be short
+        configuration.autoTuningRound = std::chrono::milliseconds(50);
+        std::unique_ptr<WorkloadProcessor<T, R>> processor = std::make_unique<WorkloadProcessor<T, R>>(consume);
+        WorkloadProcessor<T, R> *const processorPtr = processor.get();
+        Controller<T, R> controller(std::move(processor), createWorker(), numberOfThreads, configuration);
+        controller.preWarm();
+
+        const double seconds = std::chrono::duration<double>(processorPtr->run(tasks)).count();
+        const std::string result = summary();
+        if (!run) {
+            continue;
+        }
+        baseline = run == 1 ? seconds : baseline;
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::setw(8) << (autoTuned ? "auto" : std::to_string(numberOfThreads)) << std::setw(12) << seconds
+                  << std::setw(16) << units / seconds << std::setw(10) << baseline / seconds
+                  << "  " << result << std::endl;
+    }
+}
+
+/**
+ * Renders a section of the Mandelbrot set in tiles
+ *
+ * @param threadCounts The numbers of threads to measure
+ */
+void mandelbrot(const std::vector<std::size_t> &threadCounts) {
+    const MandelbrotImage image;
+    std::vector<std::uint16_t> pixels(image.width * image.height);
+
+    measureScaling<MandelbrotTile, MandelbrotTileResult>(
+            "mandelbrot", "Mpixel/s", static_cast<double>(pixels.size()) / 1e6, mandelbrotTiles(image),
+            [&]() -> std::unique_ptr<Worker<MandelbrotTile, MandelbrotTileResult>> {
+                return std::make_unique<MandelbrotWorker>(image);
+            },
+            [&](MandelbrotTileResult &result) -> void {
+                for (std::size_t row = 0; row < result.tile.height; ++row) {
+                    std::copy_n(result.iterations.begin() + static_cast<std::ptrdiff_t>(row * result.tile.width),
+                                result.tile.width,
+                                pixels.begin() + static_cast<std::ptrdiff_t>(
+                                        (result.tile.y + row) * image.width + result.tile.x));
+                }
+            },
+            [&]() -> std::string {
+                std::uint64_t iterations = 0;
+                for (std::uint16_t &pixel : pixels) {
+                    iterations += pixel;
+                    pixel = 0;
+                }
+                return std::to_string(iterations) + " iterations";
+            },
+            threadCounts
+    );
+}
+
+/**
+ * Multiplies two square matrices in blocks
+ *
+ * @param threadCounts The numbers of threads to measure
+ */
+void matrixMultiplication(const std::vector<std::size_t> &threadCounts) {
+    constexpr std::size_t size = 1024, blockSize = 128;
+    Matrix product(size);
+    const std::shared_ptr<const Matrix> left = std::make_shared<const Matrix>(Matrix::random(size, 1));
+    const std::shared_ptr<const Matrix> right = std::make_shared<const Matrix>(Matrix::random(size, 2));
+
+    measureScaling<MatrixBlock, MatrixBlockResult>(
+            "matrix multiplication", "GFLOP/s", 2.0 * size * size * size / 1e9, matrixBlocks(size, blockSize),
+            [&]() -> std::unique_ptr<Worker<MatrixBlock, MatrixBlockResult>> {
+                return std::make_unique<MatrixMultiplicationWorker>(left, right, blockSize);
+            },
+            [&](MatrixBlockResult &result) -> void {
+                for (std::size_t row = 0; row < result.block.rows; ++row) {
+                    std::copy_n(result.values.begin() + static_cast<std::ptrdiff_t>(row * result.block.columns),
+                                result.block.columns,
+                                product.values.begin() + static_cast<std::ptrdiff_t>(
+                                        (result.block.row + row) * size + result.block.column));
+                }
+            },
+            [&]() -> std::string {
+                double sum = 0;
+                for (double &value : product.values) {
+                    sum += value;
+                    value = 0;
+                }
+                std::ostringstream result;
+                result << std::setprecision(10) << sum << " sum of entries";
+                return result.str();
+            },
+            threadCounts
+    );
+}
+
+/**
+ * Counts the words of a text file in chunks
+ *
+ * @param threadCounts The numbers of threads to measure
+ * @param fileName The text file to count
+ */
+void wordCount(const std::vector<std::size_t> &threadCounts, const std::string &fileName) {
+    const std::deque<TextChunk> chunks = textChunks(fileName, 1u << 20u);
+    double megabytes = 0;
+    for (const TextChunk &chunk : chunks) {
+        megabytes += static_cast<double>(chunk.length) / 1e6;
+    }
+    WordCounts counts;
+
+    measureScaling<TextChunk, WordCounts>(
+            "word count of " + fileName, "MB/s", megabytes, chunks,
+            []() -> std::unique_ptr<Worker<TextChunk, WordCounts>> {
+                return std::make_unique<WordCountWorker>();
+            },
+            [&](WordCounts &result) -> void {
+                for (const auto &[word, count] : result) {
+                    counts[word] += count;
+                }
+            },
+            [&]() -> std::string {
+                std::uint64_t words = 0;
+                for (const auto &entry : counts) {
+                    words += entry.second;
+                }
+                const std::string result =
+                        std::to_string(words) + " words, " + std::to_string(counts.size()) + " distinct";
+                counts.clear();
+                return result;
+            },
+            threadCounts
+    );
+}
+
+/**
+ * Calculates the SHA-256 digest of every file of a directory tree
+ *
+ * @param threadCounts The numbers of threads to measure
+ * @param directory The root of the directory tree
+ */
+void sha256(const std::vector<std::size_t> &threadCounts, const std::string &directory) {
+    const std::deque<std::string> fileNames = filesBelow(directory);
+    double megabytes = 0;
+    for (const std::string &fileName : fileNames) {
+        std::error_code error;
+        megabytes += static_cast<double>(std::filesystem::file_size(fileName, error)) / 1e6;
+    }
+    std::map<std::string, std::string> digests;
+
+    measureScaling<std::string, FileDigest>(
+            "sha256 of " + directory, "MB/s", megabytes, fileNames,
+            []() -> std::unique_ptr<Worker<std::string, FileDigest>> {
+                return std::make_unique<Sha256Worker>();
+            },
+            [&](FileDigest &result) -> void {
+                digests[result.fileName] = result.digest;
+            },
+            [&]() -> std::string {
+                // the digest of all digests, which only matches between runs if every file has been hashed the same
+                Sha256 combined;
+                for (const auto &[fileName, digest] : digests) {
+                    combined.update(fileName.data(), fileName.size());
+                    combined.update(digest.data(), digest.size());
+                }
+                digests.clear();
+                return combined.finish().substr(0, 16) + " combined digest";
+            },
+            threadCounts
+    );
+}
+
+/**
+ * Writes a text file of pseudo random words, with some words far more frequent than others, like in natural language
+ *
+ * @param fileName The file to write
+ * @param size The number of bytes to write
+ */
+void writeText(const std::string &fileName, const std::size_t size) {
+    std::mt19937 generator(1);
+    std::vector<std::string> vocabulary(50000);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<std::size_t> length(2, 12);
+    for (std::string &word : vocabulary) {
+        word.resize(length(generator));
+        std::generate(word.begin(), word.end(), [&]() -> char { return static_cast<char>(letter(generator)); });
+    }
+
+    std::ofstream file(fileName, std::ios::binary);
+    std::uniform_real_distribution<double> rank(0, std::log(static_cast<double>(vocabulary.size())));
+    std::size_t written = 0;
+    for (std::size_t words = 1; written < size; ++words) {
+        const std::string &word = vocabulary[static_cast<std::size_t>(std::exp(rank(generator))) - 1];
+        file << word << (words % 16 ? ' ' : '\n');
+        written += word.size() + 1;
+    }
+}
+
+/**
+ * Writes files of pseudo random bytes into a directory tree
+ *
+ * @param directory The root of the directory tree
+ * @param numberOfFiles The number of files to write
+ * @param fileSize The number of bytes of every file
+ */
+void writeFiles(const std::string &directory, const std::size_t numberOfFiles, const std::size_t fileSize) {
+    std::mt19937 generator(2);
+    std::vector<char> bytes(fileSize);
+    for (std::size_t i = 0; i < numberOfFiles; ++i) {
+        const std::filesystem::path subdirectory = std::filesystem::path(directory) / std::to_string(i % 8);
+        std::filesystem::create_directories(subdirectory);
+        std::generate(bytes.begin(), bytes.end(), [&]() -> char { return static_cast<char>(generator()); });
+        std::ofstream(subdirectory / (std::to_string(i) + ".bin"), std::ios::binary)
+                .write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // setup Qt stuff
+    QCoreApplication a(argc, argv);
+
+    // usage: [all|mandelbrot|matrix|wordcount|sha256] [largest number of threads]
+    //        [text file to count for wordcount, directory tree to hash for sha256, generated if not given]
+    const std::string workload = argc > 1 ? argv[1] : "all";
+    const std::size_t maxThreads = argc > 2 ? std::stoul(argv[2]) : QThread::idealThreadCount();
+    const std::string path = argc > 3 ? argv[3] : "";
+
+    // 1, 2, 4, ... and the largest number of threads
+    std::vector<std::size_t> threadCounts;
+    for (std::size_t numberOfThreads = 1; numberOfThreads < maxThreads; numberOfThreads *= 2) {
+        threadCounts.push_back(numberOfThreads);
+    }
+    threadCounts.push_back(std::max<std::size_t>(maxThreads, 1));
+
+    const std::filesystem::path generated = std::filesystem::temp_directory_path() / "qt_multithreading_workloads";
+    if (workload == "all" || workload == "mandelbrot") {
+        mandelbrot(threadCounts);
+    }
+    if (workload == "all" || workload == "matrix") {
+        matrixMultiplication(threadCounts);
+    }
+    if (workload == "all" || workload == "wordcount") {
+        std::string fileName = path;
+        if (fileName.empty()) {
+            std::filesystem::create_directories(generated);
+            fileName = (generated / "words.txt").string();
+            writeText(fileName, 256u << 20u);
+        }
+        wordCount(threadCounts, fileName);
+    }
+    if (workload == "all" || workload == "sha256") {
+        std::string directory = path;
+        if (directory.empty()) {
+            directory = (generated / "files").string();
+            writeFiles(directory, 256, 1u << 20u);
+        }
+        sha256(threadCounts, directory);
+    }
+
+    std::error_code error;
+    std::filesystem::remove_all(generated, error);
+    return 0;
+}
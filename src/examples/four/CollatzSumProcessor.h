@@ -0,0 +1,55 @@
+#ifndef QT_MULTITHREADING_COLLATZSUMPROCESSOR_H
+#define QT_MULTITHREADING_COLLATZSUMPROCESSOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "../../Processor.h"
+#include "../three/CollatzProcessor.h"
+
+/**
+ * Processor which only sums up the total stopping times, no matter which Worker calculated them,
+ * so that the results of local and remote Worker can be compared with the expected sum
+ */
+class CollatzSumProcessor : public Processor<unsigned int, return_tuple> {
+public:
+    /**
+     * Returns the number of results received so far, may be called from any thread
+     *
+     * @return The number of received results
+     */
+    [[nodiscard]] inline std::size_t received() const {
+        return this->numberOfResults.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns the sum of the total stopping times received so far, may be called from any thread
+     *
+     * @return The sum of the received total stopping times
+     */
+    [[nodiscard]] inline std::uint64_t sum() const {
+        return this->stoppingTimes.load(std::memory_order_acquire);
+    }
+
+private:
+    /**
+     * See CollatzSumProcessor::received
+     */
+    std::atomic<std::size_t> numberOfResults = 0;
+    /**
+     * See CollatzSumProcessor::sum
+     */
+    std::atomic<std::uint64_t> stoppingTimes = 0;
+
+    /**
+     * Called when a worker, local or remote, has calculated a result
+     *
+     * @param result A std::tuple containing the number, its total stopping time and the time it has been calculated
+     */
+    inline void receiveResult(return_tuple &result) override {
+        this->stoppingTimes.fetch_add(std::get<1>(result), std::memory_order_relaxed);
+        this->numberOfResults.fetch_add(1, std::memory_order_release);
+    }
+};
+
+#endif
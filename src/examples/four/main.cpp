@@ -0,0 +1,100 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <QCoreApplication>
+#include <QProcess>
+#include <QStringList>
+#include <QThread>
+#include "../../Controller.h"
+#include "../../RemoteWorkerHost.h"
+#include "../../TcpRemoteWorkers.h"
+#include "../three/CollatzWorker.h"
+#include "CollatzSumProcessor.h"
+
+/**
+ * Calculates the total stopping time of a number, without any Worker, in order to check the received results
+ *
+ * @param n The number to calculate the total stopping time of
+ * @return The total stopping time of \p n
+ */
+unsigned int stoppingTime(unsigned int n) {
+    unsigned int sequenceLength = 1;
+    while (n > 1) {
+        n = n % 2 ? 3 * n + 1 : n / 2;
+        ++sequenceLength;
+    }
+    return sequenceLength;
+}
+
+int main(int argc, char *argv[]) {
+    // setup Qt stuff
+    QCoreApplication a(argc, argv);
+
+    // this is how the example starts its remote Worker below: run CollatzWorker for the Controller at the given address,
+    // on another machine this would be e.g. "qt_multithreading_example_four host 192.168.0.2:4711"
+    if (argc == 3 && std::strcmp(argv[1], "host") == 0) {
+        RemoteWorkerHost<unsigned int, return_tuple> host(std::make_unique<CollatzWorker>(), QString(argv[2]));
+        return QCoreApplication::exec();
+    }
+
+    // usage: [number of tasks] [number of local threads]
+    const unsigned int numberOfTasks = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const std::size_t numberOfThreads = argc > 2 ? std::stoul(argv[2]) : 1;
+
+    // accept remote Worker on 127.0.0.1 with a port chosen by the operating system
+    ControllerConfiguration<unsigned int, return_tuple> configuration;
+    configuration.remoteWorkers = []() -> std::unique_ptr<RemoteWorkers<unsigned int, return_tuple>> {
+        return std::make_unique<TcpRemoteWorkers<unsigned int, return_tuple>>();
+    };
+
+    std::unique_ptr<CollatzSumProcessor> processor = std::make_unique<CollatzSumProcessor>();
+    CollatzSumProcessor *const processorPtr = processor.get();
+    Controller<unsigned int, return_tuple> controller(
+            std::move(processor), std::make_unique<CollatzWorker>(), numberOfThreads, configuration
+    );
+
+    // start two hosts, which are going to connect to the Controller
+    const QString address = controller.remoteWorkersAddress();
+    std::cout << "--- Remote Worker connect to " << address.toStdString() << " ---" << std::endl;
+    std::array<QProcess, 2> hosts;
+    for (QProcess &host : hosts) {
+        host.setProcessChannelMode(QProcess::ForwardedChannels);
+        host.start(QCoreApplication::applicationFilePath(), QStringList() << "host" << address);
+    }
+    while (controller.metrics().remoteConnections < hosts.size()) {
+        QThread::msleep(10);
+    }
+    std::cout << "--- " << hosts.size() << " hosts connected ---" << std::endl;
+
+    // submit the tasks, the WorkerController gives them to the local and the remote Worker
+    TaskSubmitter<unsigned int, return_tuple> submitter = controller.submitter();
+    std::uint64_t expectedSum = 0;
+    for (unsigned int i = 1; i <= numberOfTasks; ++i) {
+        submitter.submit(i);
+        expectedSum += stoppingTime(i);
+    }
+    submitter.flush();
+
+    // let one host crash after a third of the results, its tasks in flight are given to the other Worker
+    while (processorPtr->received() < numberOfTasks / 3) {
+        QThread::msleep(1);
+    }
+    hosts[0].kill();
+    hosts[0].waitForFinished();
+    std::cout << "--- Killed a host after " << processorPtr->received() << " results ---" << std::endl;
+
+    // wait until everything is done
+    while (processorPtr->received() < numberOfTasks) {
+        QThread::msleep(10);
+    }
+    const MetricsSnapshot metrics = controller.metrics();
+    std::cout << "--- Received " << processorPtr->received() << " results, sum of total stopping times: "
+              << processorPtr->sum() << " (expected " << expectedSum << "), reassigned tasks: "
+              << metrics.reassignedTasks << " ---" << std::endl;
+
+    hosts[1].kill();
+    hosts[1].waitForFinished();
+    return processorPtr->sum() == expectedSum ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+#ifndef QT_MULTITHREADING_TESTS_CHECK_H
+#define QT_MULTITHREADING_TESTS_CHECK_H
+
+#include <cstdio>
+
+/**
+ * Minimal checks for the tests, which are plain executables run by CTest. \n
+ * A failed check is printed and the test goes on, so that one run shows all failures,
+ * the exit code of the test is taken from check::result().
+ */
+namespace check {
+    /**
+     * The number of failed checks
+     */
+    inline int failures = 0;
+
+    /**
+     * Checks a condition
+     *
+     * @param condition The condition, which has to be \p true
+     * @param description What has been checked, printed if \p condition is \p false
+     */
+    inline void that(const bool condition, const char *const description) {
+        if (!condition) {
+            ++check::failures;
+            std::fprintf(stderr, "FAILED: %s\n", description);
+        }
+    }
+
+    /**
+     * Returns the exit code of the test
+     *
+     * @return 0 if all checks passed, 1 otherwise
+     */
+    inline int result() {
+        if (check::failures) {
+            std::fprintf(stderr, "%d checks failed\n", check::failures);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+#endif
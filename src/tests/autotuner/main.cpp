@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstddef>
+#include "../Check.h"
+#include "../../AutoTuner.h"
+
+using namespace std::chrono_literals;
+
+/**
+ * A workload whose throughput peaks with 4 of 8 Worker and a batch size of 16
+ *
+ * @param setting The setting of the round
+ * @return The number of tasks completed in a round of 1 ms
+ */
+std::size_t completedTasks(const TuningSetting &setting) {
+    const std::size_t workerFactor = setting.workers <= 4 ? setting.workers : 3;
+    std::size_t batchFactor = 2;
+    if (setting.batchSize == 1) {
+        batchFactor = 1;
+    } else if (setting.batchSize == 16) {
+        batchFactor = 3;
+    }
+    return 100 * workerFactor * batchFactor;
+}
+
+/**
+ * Runs saturated rounds until the AutoTuner settled
+ *
+ * @param tuner The AutoTuner to run
+ * @return The number of rounds needed
+ */
+std::size_t settle(AutoTuner &tuner) {
+    std::size_t rounds = 0;
+    while (tuner.isTuning() && rounds < 100) {
+        tuner.round(completedTasks(tuner.setting()), 1ms, true, 1ms);
+        ++rounds;
+    }
+    return rounds;
+}
+
+/**
+ * The tuning tries all batch sizes, then the numbers of Worker, and settles with the highest throughput
+ */
+void testConvergence() {
+    AutoTuner tuner(64, 0.5);
+    tuner.restart(8);
+    check::that(tuner.isTuning(), "convergence: the tuning starts with restart()");
+    check::that(tuner.setting().workers == 8 && tuner.setting().batchSize == 1,
+                "convergence: the first round uses all Worker and single tasks");
+
+    const std::size_t rounds = settle(tuner);
+    // batch sizes 1, 4, 16, 64 with 8 Worker, then 1, 2, 4 Worker with the best batch size
+    check::that(rounds == 7, "convergence: every candidate is used for one round");
+    check::that(!tuner.isTuning(), "convergence: the tuning settles");
+    check::that(tuner.setting().workers == 4 && tuner.setting().batchSize == 16,
+                "convergence: the setting with the highest throughput is chosen");
+    check::that(tuner.numberOfCalibrations() == 1, "convergence: the tuning has been started once");
+}
+
+/**
+ * Rounds without waiting tasks or without completed tasks do not count as measurement
+ */
+void testRepeatedRounds() {
+    AutoTuner tuner(64, 0.5);
+    tuner.restart(8);
+
+    TuningSetting setting = tuner.round(1000, 1ms, false, 1ms);
+    check::that(setting.batchSize == 1, "repeat: a round without waiting tasks is repeated");
+    setting = tuner.round(0, 1ms, true, 1ms);
+    check::that(setting.batchSize == 1, "repeat: a round without completed tasks is repeated");
+    setting = tuner.round(1000, 0ms, true, 1ms);
+    check::that(setting.batchSize == 1, "repeat: a round without duration is repeated");
+    setting = tuner.round(1000, 1ms, true, 1ms);
+    check::that(setting.batchSize == 4, "repeat: a measured round continues with the next candidate");
+}
+
+/**
+ * Once settled, the tuning starts over only if the mean execution time drifted
+ */
+void testDrift() {
+    AutoTuner tuner(64, 0.5);
+    tuner.restart(8);
+    settle(tuner);
+
+    tuner.round(1000, 1ms, true, 1000us);
+    tuner.round(1000, 1ms, true, 1400us);
+    tuner.round(1000, 1ms, true, 700us);
+    check::that(!tuner.isTuning(), "drift: changes within the drift keep the setting");
+
+    tuner.round(1000, 1ms, true, 1600us);
+    check::that(tuner.isTuning(), "drift: slower tasks start the tuning over");
+    check::that(tuner.numberOfCalibrations() == 2, "drift: the new tuning is counted");
+
+    settle(tuner);
+    tuner.round(1000, 1ms, true, 1000us);
+    tuner.round(1000, 1ms, true, 600us);
+    check::that(tuner.isTuning(), "drift: faster tasks start the tuning over as well");
+}
+
+/**
+ * With a single Worker, only the batch sizes are tried
+ */
+void testSingleWorker() {
+    AutoTuner tuner(16, 0.5);
+    tuner.restart(1);
+    const std::size_t rounds = settle(tuner);
+    check::that(rounds == 3, "single worker: only the batch sizes 1, 4, 16 are tried");
+    check::that(tuner.setting().workers == 1 && tuner.setting().batchSize == 16,
+                "single worker: the best batch size is chosen");
+}
+
+/**
+ * Tests the AutoTuner used with ControllerConfiguration::autoTuning
+ */
+int main() {
+    testConvergence();
+    testRepeatedRounds();
+    testDrift();
+    testSingleWorker();
+    return check::result();
+}
@@ -0,0 +1,92 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include "../Check.h"
+#include "../../Hedging.h"
+
+using namespace std::chrono_literals;
+
+/**
+ * Of a task and its duplicate finishing at the same time, exactly one claims the task
+ */
+void testClaimRace() {
+    constexpr std::size_t rounds = 1000;
+    std::size_t singleWinner = 0;
+    bool lateClaimsMeasured = true;
+
+    for (std::size_t round = 0; round < rounds; ++round) {
+        TaskClaim claim;
+        std::atomic<int> ready = 0;
+        bool won[2] = {false, false};
+        std::chrono::nanoseconds sinceClaimed[2] = {-1ns, -1ns};
+
+        const auto worker = [&claim, &ready, &won, &sinceClaimed](const int index) -> void {
+            // both threads start claiming at the same time, as far as possible
+            ready.fetch_add(1);
+            while (ready.load() < 2) {
+                std::this_thread::yield();
+            }
+            won[index] = claim.claim(sinceClaimed[index]);
+        };
+        std::thread duplicate(worker, 1);
+        worker(0);
+        duplicate.join();
+
+        singleWinner += won[0] != won[1];
+        const int loser = won[0] ? 1 : 0;
+        lateClaimsMeasured = lateClaimsMeasured && sinceClaimed[loser] >= 0ns && claim.isClaimed();
+    }
+
+    check::that(singleWinner == rounds, "claim: exactly one of two concurrent claims wins");
+    check::that(lateClaimsMeasured, "claim: the losing claim gets the time since the winning one");
+}
+
+/**
+ * A task is only claimed once, claims after the first one lose
+ */
+void testClaimOnce() {
+    TaskClaim claim;
+    std::chrono::nanoseconds sinceClaimed = -1ns;
+    check::that(!claim.isClaimed(), "once: a new task is not claimed");
+    check::that(claim.claim(sinceClaimed), "once: the first claim wins");
+    check::that(sinceClaimed == -1ns, "once: the winning claim does not measure a time");
+    std::this_thread::sleep_for(1ms);
+    check::that(!claim.claim(sinceClaimed), "once: the second claim loses");
+    check::that(sinceClaimed >= 1ms, "once: the losing claim measures the time since the first one");
+}
+
+/**
+ * The percentile needs enough samples and follows the most recent execution times
+ */
+void testPercentile() {
+    ExecutionTimeWindow window;
+    for (std::size_t sample = 1; sample < ExecutionTimeWindow::minimumSamples; ++sample) {
+        window.add(1ms);
+    }
+    check::that(window.percentile(0.95) == std::chrono::nanoseconds::max(),
+                "percentile: no percentile without enough samples");
+
+    ExecutionTimeWindow uniform;
+    for (int millisecond = 1; millisecond <= 100; ++millisecond) {
+        uniform.add(std::chrono::milliseconds(millisecond));
+    }
+    check::that(uniform.percentile(0.95) == 95ms, "percentile: the p95 of 1 ms to 100 ms is 95 ms");
+    check::that(uniform.percentile(0.5) == 50ms, "percentile: the median of 1 ms to 100 ms is 50 ms");
+
+    // filling the window once more replaces all old samples
+    for (std::size_t sample = 0; sample < ExecutionTimeWindow::size; ++sample) {
+        uniform.add(2s);
+    }
+    check::that(uniform.percentile(0.5) == 2s, "percentile: old samples are replaced once the window is full");
+}
+
+/**
+ * Tests the TaskClaim and the ExecutionTimeWindow used with ControllerConfiguration::hedging
+ */
+int main() {
+    testClaimRace();
+    testClaimOnce();
+    testPercentile();
+    return check::result();
+}
@@ -0,0 +1,102 @@
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../Check.h"
+#include "../../ResultChannel.h"
+
+/**
+ * The results of a channel arrive in the order they have been pushed, also while the Worker pushes concurrently
+ * and segments are linked and released meanwhile
+ */
+void testOrder() {
+    constexpr int numberOfResults = 100000;
+    ResultInbox<int> inbox;
+    // a small segment size lets the producer link many segments
+    std::shared_ptr<ResultChannel<int>> channel = inbox.open(7);
+
+    std::thread worker([&channel]() -> void {
+        for (int value = 0; value < numberOfResults; ++value) {
+            int result = value;
+            channel->push(result, sizeof(int));
+        }
+        ResultInbox<int>::close(*channel);
+    });
+
+    bool ordered = true;
+    int expected = 0;
+    std::size_t bytes = 0;
+    while (expected < numberOfResults) {
+        inbox.drain([&ordered, &expected, &bytes](int &result, const std::size_t resultBytes) -> void {
+            ordered = ordered && result == expected++;
+            bytes += resultBytes;
+        }, 16);
+    }
+    worker.join();
+
+    check::that(ordered, "order: results arrive in the order they have been pushed");
+    check::that(bytes == numberOfResults * sizeof(int), "order: the accounted bytes arrive with the results");
+    check::that(channel->empty(), "order: the channel is empty after all results have been popped");
+}
+
+/**
+ * A drain pops at most one batch per channel, round-robin, and reports whether results remain
+ */
+void testDrainBatches() {
+    ResultInbox<int> inbox;
+    std::shared_ptr<ResultChannel<int>> first = inbox.open(4);
+    std::shared_ptr<ResultChannel<int>> second = inbox.open(4);
+    for (int value = 0; value < 25; ++value) {
+        int firstResult = value;
+        int secondResult = 100 + value;
+        first->push(firstResult, sizeof(int));
+        second->push(secondResult, sizeof(int));
+    }
+
+    std::vector<int> received;
+    const auto receive = [&received](int &result, const std::size_t) -> void { received.push_back(result); };
+
+    check::that(inbox.drain(receive, 10), "batches: a drain reports remaining results");
+    check::that(received.size() == 20, "batches: a drain pops one batch per channel");
+    check::that(received[0] == 0 && received[9] == 9 && received[10] == 100 && received[19] == 109,
+                "batches: the channels are drained one batch after another");
+
+    check::that(inbox.drain(receive, 10), "batches: the second drain reports remaining results");
+    check::that(!inbox.drain(receive, 10), "batches: the last drain reports that all channels are empty");
+    check::that(received.size() == 50, "batches: all results are popped");
+    check::that(received[49] == 124, "batches: the last result of the second channel is popped last");
+}
+
+/**
+ * Only the first notification after a drain has to be posted, further ones are coalesced
+ */
+void testNotify() {
+    ResultInbox<int> inbox;
+    std::shared_ptr<ResultChannel<int>> channel = inbox.open(4);
+    int result = 1;
+    channel->push(result, sizeof(int));
+
+    check::that(inbox.notify(), "notify: the first notification has to be posted");
+    check::that(!inbox.notify(), "notify: further notifications are coalesced");
+
+    std::size_t popped = 0;
+    const auto receive = [&popped](int &, const std::size_t) -> void { ++popped; };
+    check::that(!inbox.drain(receive, 10) && popped == 1, "notify: the drain pops the pushed result");
+    check::that(inbox.notify(), "notify: a notification after a drain has to be posted again");
+
+    // a closed channel is removed once drained, so that it is not drained again
+    ResultInbox<int>::close(*channel);
+    inbox.drain(receive, 10);
+    check::that(channel.use_count() == 1, "notify: a closed and drained channel is removed from the inbox");
+}
+
+/**
+ * Tests the ResultChannel and ResultInbox used with ControllerConfiguration::resultChannels
+ */
+int main() {
+    testOrder();
+    testDrainBatches();
+    testNotify();
+    return check::result();
+}
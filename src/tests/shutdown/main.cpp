@@ -0,0 +1,134 @@
+#include <QCoreApplication>
+#include <QThread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include "../Check.h"
+#include "../../Controller.h"
+
+using namespace std::chrono_literals;
+
+/**
+ * Lets the stuck tasks return at the end of the test
+ */
+std::atomic<bool> releaseStuckTasks = false;
+
+/**
+ * Counts the received results
+ */
+class CountingProcessor : public Processor<int, int> {
+public:
+    /**
+     * The number of received results
+     */
+    static inline std::atomic<int> results = 0;
+
+private:
+    void receiveResult(int &) override {
+        CountingProcessor::results.fetch_add(1);
+    }
+};
+
+/**
+ * Fulfills task 0 without ever looking at the cancellation, any other task in 50 ms steps up to 1 s, but
+ * stops as soon as it is cancelled
+ */
+class SleepingWorker : public Worker<int, int> {
+private:
+    std::unique_ptr<Worker<int, int>> clone() override {
+        return std::make_unique<SleepingWorker>();
+    }
+
+    int fulfillTask(int &task) override {
+        if (!task) {
+            while (!releaseStuckTasks.load()) {
+                QThread::msleep(5);
+            }
+            return 0;
+        }
+        for (int step = 0; step < task && !this->isTaskCancelled(); ++step) {
+            QThread::msleep(50);
+        }
+        return task;
+    }
+};
+
+/**
+ * Creates a Controller with 2 Worker and gives it \p tasks
+ *
+ * @param tasks The tasks to give
+ * @return The Controller
+ */
+std::unique_ptr<Controller<int, int>> startController(const std::deque<int> &tasks) {
+    auto controller = std::make_unique<Controller<int, int>>(
+            std::make_unique<CountingProcessor>(), std::make_unique<SleepingWorker>(), 2
+    );
+    {
+        TaskSubmitter<int, int> submitter = controller->submitter();
+        for (const int task : tasks) {
+            submitter.submit(int(task));
+        }
+    }
+    // let the Worker start their tasks
+    QThread::msleep(50);
+    return controller;
+}
+
+/**
+ * Tasks finishing within the drain timeout are finished and joined, even without a cancel timeout
+ */
+void testDrain() {
+    CountingProcessor::results = 0;
+    std::unique_ptr<Controller<int, int>> controller = startController({2, 2, 2});
+
+    const ShutdownReport report = controller->shutdown(5000ms, 0ms);
+    check::that(report.drained, "drain: the tasks finish within the drain timeout");
+    check::that(!report.detached && report.isClean(), "drain: the threads are joined after draining");
+    check::that(CountingProcessor::results == 3, "drain: all results reach the Processor");
+    check::that(report.duration < 4000ms, "drain: the shutdown returns once the tasks finished");
+}
+
+/**
+ * Tasks running longer than the drain timeout are cancelled, the queued ones are discarded
+ */
+void testCancel() {
+    CountingProcessor::results = 0;
+    std::unique_ptr<Controller<int, int>> controller = startController({20, 20, 20, 20});
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const ShutdownReport report = controller->shutdown(100ms, 2000ms);
+    const std::chrono::steady_clock::duration took = std::chrono::steady_clock::now() - start;
+    check::that(!report.drained, "cancel: the tasks do not finish within the drain timeout");
+    check::that(!report.detached, "cancel: the cancelled tasks stop, thus the threads are joined");
+    check::that(report.stuckWorkers.empty(), "cancel: no Worker is stuck");
+    check::that(report.discardedTasks == 2, "cancel: the queued tasks are discarded");
+    check::that(took < 1500ms, "cancel: the shutdown does not wait for the tasks to finish");
+    check::that(controller->metrics().queuedTasks == 0, "cancel: the Controller returns empty values afterwards");
+}
+
+/**
+ * A Worker ignoring the cancellation is reported as stuck and its thread is detached after the cancel timeout
+ */
+void testDetach() {
+    std::unique_ptr<Controller<int, int>> controller = startController({0, 20});
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const ShutdownReport report = controller->shutdown(100ms, 300ms);
+    const std::chrono::steady_clock::duration took = std::chrono::steady_clock::now() - start;
+    check::that(report.detached && !report.isClean(), "detach: the threads are detached");
+    check::that(report.stuckWorkers.size() == 1, "detach: only the Worker ignoring the cancellation is stuck");
+    check::that(took >= 400ms && took < 2000ms, "detach: the shutdown returns after the drain and cancel timeouts");
+}
+
+/**
+ * Tests the deadlines of Controller::shutdown()
+ */
+int main(int argc, char **argv) {
+    QCoreApplication application(argc, argv);
+    testDrain();
+    testCancel();
+    testDetach();
+    // the detached Worker may finish now, its thread is never joined
+    releaseStuckTasks = true;
+    return check::result();
+}
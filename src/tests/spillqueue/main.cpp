@@ -0,0 +1,116 @@
+#include <QString>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "../Check.h"
+#include "../../SpillQueue.h"
+
+/**
+ * Creates an empty directory for the spill files of a test
+ *
+ * @return The path of the directory
+ */
+std::filesystem::path spillDirectory() {
+    std::string pattern = (std::filesystem::temp_directory_path() / "qt_multithreading_test_XXXXXX").string();
+    return std::filesystem::path(mkdtemp(pattern.data()));
+}
+
+/**
+ * Returns the spill files in \p directory
+ *
+ * @param directory The directory given to the SpillQueue
+ * @return The paths of the spill files
+ */
+std::vector<std::filesystem::path> spillFiles(const std::filesystem::path &directory) {
+    std::vector<std::filesystem::path> files;
+    for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(directory)) {
+        files.push_back(entry.path());
+    }
+    return files;
+}
+
+/**
+ * Tasks beyond the budget are spilled and come back in the order they have been queued
+ */
+void testOrder() {
+    const std::filesystem::path directory = spillDirectory();
+    {
+        // 8 tasks fit into memory, the others are spilled in files of 4 tasks
+        SpillQueue<std::uint64_t> queue(8 * sizeof(std::uint64_t), QString::fromStdString(directory.string()), 4);
+        for (std::uint64_t task = 0; task < 1000; ++task) {
+            queue.push_back(task);
+        }
+        check::that(queue.size() == 1000, "order: spilled tasks are counted as queued");
+        check::that(queue.spilled() > 0, "order: tasks beyond the budget are spilled");
+        check::that(queue.memoryBytes() <= 8 * sizeof(std::uint64_t) + 4 * sizeof(std::uint64_t),
+                    "order: at most the budget and a partial chunk are kept in memory");
+
+        bool ordered = true;
+        std::uint64_t expected = 0;
+        while (!queue.empty()) {
+            ordered = ordered && queue.pop_front() == expected++;
+        }
+        check::that(ordered && expected == 1000, "order: all tasks are popped in the order they have been queued");
+        check::that(!queue.size() && !queue.spilled() && !queue.readFailures(), "order: nothing is left behind");
+    }
+    check::that(spillFiles(directory).empty(), "order: the spill files are removed");
+    std::filesystem::remove_all(directory);
+}
+
+/**
+ * A spill file, which cannot be read, keeps its tasks queued until it can be read again
+ */
+void testRetryRefill() {
+    const std::filesystem::path directory = spillDirectory();
+    {
+        SpillQueue<std::uint64_t> queue(8 * sizeof(std::uint64_t), QString::fromStdString(directory.string()), 4);
+        for (std::uint64_t task = 0; task < 20; ++task) {
+            queue.push_back(task);
+        }
+
+        // truncate the spill files, but keep their content to restore it later
+        std::vector<std::pair<std::filesystem::path, std::string>> contents;
+        for (const std::filesystem::path &file : spillFiles(directory)) {
+            std::ifstream input(file, std::ios::binary);
+            contents.emplace_back(file, std::string(std::istreambuf_iterator<char>(input), {}));
+            std::ofstream(file, std::ios::binary | std::ios::trunc);
+        }
+        check::that(contents.size() == 3, "retry: the 12 tasks beyond the budget are spilled into 3 files");
+
+        bool ordered = true;
+        std::uint64_t expected = 0;
+        while (!queue.empty()) {
+            ordered = ordered && queue.pop_front() == expected++;
+        }
+        check::that(ordered && expected == 8, "retry: the tasks in memory are popped in order");
+        check::that(queue.readFailures() > 0, "retry: the failed read is counted");
+        check::that(queue.size() == 12 && queue.spilled() == 12, "retry: the tasks of unreadable files stay queued");
+
+        queue.retryRefill();
+        check::that(queue.empty(), "retry: an unreadable file is not loaded");
+
+        for (const auto &[file, content] : contents) {
+            std::ofstream(file, std::ios::binary | std::ios::trunc) << content;
+        }
+        queue.retryRefill();
+        while (!queue.empty()) {
+            ordered = ordered && queue.pop_front() == expected++;
+        }
+        check::that(ordered && expected == 20, "retry: the tasks are popped in order once the files are readable");
+        check::that(!queue.size(), "retry: nothing is left behind");
+    }
+    std::filesystem::remove_all(directory);
+}
+
+/**
+ * Tests the SpillQueue used by the WorkerController to queue tasks beyond ControllerConfiguration::spillMemoryBudget
+ */
+int main() {
+    testOrder();
+    testRetryRefill();
+    return check::result();
+}
@@ -0,0 +1,108 @@
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "../Check.h"
+#include "../../TimerWheel.h"
+
+using namespace std::chrono_literals;
+
+/**
+ * Timers fire in the order of their due ticks, never early and only once
+ */
+void testOneShotTimers() {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    TimerWheel<int> wheel(1ms, start);
+    wheel.schedule(start + 30ms, 3);
+    wheel.schedule(start + 10ms, 1);
+    wheel.schedule(start + 20ms, 2);
+
+    std::vector<int> fired;
+    wheel.advance(start + 9ms, [&fired](int &payload) -> void { fired.push_back(payload); });
+    check::that(fired.empty(), "one-shot: no timer fires before it is due");
+
+    wheel.advance(start + 25ms, [&fired](int &payload) -> void { fired.push_back(payload); });
+    check::that(fired == std::vector<int>({1, 2}), "one-shot: the due timers fire in the order of their due ticks");
+
+    wheel.advance(start + 100ms, [&fired](int &payload) -> void { fired.push_back(payload); });
+    check::that(fired == std::vector<int>({1, 2, 3}), "one-shot: every timer fires exactly once");
+    check::that(!wheel.size() && !wheel.nextAdvance(), "one-shot: fired timers are removed");
+}
+
+/**
+ * Cancelled timers do not fire, ids of fired or cancelled timers cannot cancel another timer
+ */
+void testCancel() {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    TimerWheel<int> wheel(1ms, start);
+    const TimerId cancelled = wheel.schedule(start + 10ms, 1);
+    const TimerId fired = wheel.schedule(start + 10ms, 2);
+
+    check::that(wheel.cancel(cancelled), "cancel: a pending timer can be cancelled");
+    check::that(!wheel.cancel(cancelled), "cancel: a timer can be cancelled only once");
+
+    int firedPayload = 0;
+    wheel.advance(start + 10ms, [&firedPayload](int &payload) -> void { firedPayload += payload; });
+    check::that(firedPayload == 2, "cancel: only the timer not cancelled fires");
+    check::that(!wheel.cancel(fired), "cancel: a fired timer cannot be cancelled");
+
+    // the node of the fired timer is reused, its old id must not match the new timer
+    const TimerId reused = wheel.schedule(start + 20ms, 3);
+    check::that(!wheel.cancel(fired) && wheel.cancel(reused), "cancel: old ids do not match reused nodes");
+}
+
+/**
+ * Periodic timers fire once per period, periods missed while the wheel has not been advanced are skipped
+ */
+void testPeriodicCatchUp() {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    TimerWheel<int> wheel(1ms, start);
+    wheel.schedule(start + 1ms, 1, 1ms);
+
+    std::size_t fired = 0;
+    const auto count = [&fired](int &) -> void { ++fired; };
+    for (int millisecond = 1; millisecond <= 5; ++millisecond) {
+        wheel.advance(start + std::chrono::milliseconds(millisecond), count);
+    }
+    check::that(fired == 5, "periodic: fires once per period when advanced every period");
+
+    // a stall of 10 s must not give 10,000 copies at once
+    fired = 0;
+    wheel.advance(start + 5ms + 10s, count);
+    check::that(fired == 1, "periodic: fires only once after a stall, the missed periods are skipped");
+
+    fired = 0;
+    wheel.advance(start + 5ms + 10s, count);
+    check::that(fired == 0, "periodic: does not fire again within the same tick");
+    wheel.advance(start + 6ms + 10s, count);
+    check::that(fired == 1, "periodic: continues with the next period after the stall");
+    check::that(wheel.size() == 1, "periodic: a periodic timer stays pending");
+}
+
+/**
+ * Timers beyond the range of the highest wheel wait there and are moved down, until they are due
+ */
+void testFarFuture() {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    // 2^32 ticks of 1 ns are about 4.3 s, thus 10 s are beyond the highest wheel
+    TimerWheel<int> wheel(1ns, start);
+    wheel.schedule(start + 10s, 1);
+
+    std::size_t fired = 0;
+    const auto count = [&fired](int &) -> void { ++fired; };
+    wheel.advance(start + 5s, count);
+    wheel.advance(start + 10s - 1ns, count);
+    check::that(fired == 0, "far future: does not fire early");
+    wheel.advance(start + 10s, count);
+    check::that(fired == 1, "far future: fires when due");
+}
+
+/**
+ * Tests the TimerWheel used by Controller::scheduleAt() and Controller::scheduleEvery()
+ */
+int main() {
+    testOneShotTimers();
+    testCancel();
+    testPeriodicCatchUp();
+    testFarFuture();
+    return check::result();
+}